@@ -702,11 +702,12 @@ _bfd_get_elt_at_filepos (bfd *archive, file_ptr filepos)
 	    }
 	  n_bfd->proxy_origin = bfd_tell (archive);
 
-	  /* Copy BFD_COMPRESS, BFD_DECOMPRESS and BFD_COMPRESS_GABI
-	     flags.  */
+	  /* Copy BFD_COMPRESS, BFD_DECOMPRESS, BFD_COMPRESS_GABI and
+	     BFD_COMPRESS_ZSTD flags.  */
 	  n_bfd->flags |= archive->flags & (BFD_COMPRESS
 					    | BFD_DECOMPRESS
-					    | BFD_COMPRESS_GABI);
+					    | BFD_COMPRESS_GABI
+					    | BFD_COMPRESS_ZSTD);
 
 	  return n_bfd;
 	}
@@ -743,10 +744,12 @@ _bfd_get_elt_at_filepos (bfd *archive, file_ptr filepos)
 
   n_bfd->arelt_data = new_areldata;
 
-  /* Copy BFD_COMPRESS, BFD_DECOMPRESS and BFD_COMPRESS_GABI flags.  */
+  /* Copy BFD_COMPRESS, BFD_DECOMPRESS, BFD_COMPRESS_GABI and
+     BFD_COMPRESS_ZSTD flags.  */
   n_bfd->flags |= archive->flags & (BFD_COMPRESS
 				    | BFD_DECOMPRESS
-				    | BFD_COMPRESS_GABI);
+				    | BFD_COMPRESS_GABI
+				    | BFD_COMPRESS_ZSTD);
 
   /* Copy is_linker_input.  */
   n_bfd->is_linker_input = archive->is_linker_input;
@@ -417,13 +417,14 @@ extern void bfd_hash_traverse
 extern unsigned long bfd_hash_set_default_size (unsigned long);
 
 /* Types of compressed DWARF debug sections.  We currently support
-   zlib.  */
+   zlib, and zstd with SHF_COMPRESSED sections.  */
 enum compressed_debug_section_type
 {
   COMPRESS_DEBUG_NONE = 0,
   COMPRESS_DEBUG = 1 << 0,
   COMPRESS_DEBUG_GNU_ZLIB = COMPRESS_DEBUG | 1 << 1,
-  COMPRESS_DEBUG_GABI_ZLIB = COMPRESS_DEBUG | 1 << 2
+  COMPRESS_DEBUG_GABI_ZLIB = COMPRESS_DEBUG | 1 << 2,
+  COMPRESS_DEBUG_ZSTD = COMPRESS_DEBUG | 1 << 3
 };
 
 /* This structure is used to keep track of stabs in sections
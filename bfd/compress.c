@@ -20,14 +20,33 @@
 
 #include "sysdep.h"
 #include <zlib.h>
+#ifdef HAVE_ZSTD
+#include <zstd.h>
+#endif
 #include "bfd.h"
 #include "libbfd.h"
 #include "safe-ctype.h"
+#include "elf/common.h"
 
 #define MAX_COMPRESSION_HEADER_SIZE 24
 
+/* Return the ELFCOMPRESS_* type of the compressed section contents
+   CONTENTS in ABFD, whose compression header is COMPRESSION_HEADER_SIZE
+   bytes long.  .zdebug* sections, which have no ELF compression header,
+   are always compressed with zlib.  */
+
+static unsigned int
+compression_type (bfd *abfd, bfd_byte *contents,
+		  int compression_header_size)
+{
+  /* ch_type is the first field of both Elf32_Chdr and Elf64_Chdr.  */
+  if (compression_header_size > 0)
+    return bfd_get_32 (abfd, contents);
+  return ELFCOMPRESS_ZLIB;
+}
+
 static bfd_boolean
-decompress_contents (bfd_byte *compressed_buffer,
+decompress_contents (bfd_boolean is_zstd, bfd_byte *compressed_buffer,
 		     bfd_size_type compressed_size,
 		     bfd_byte *uncompressed_buffer,
 		     bfd_size_type uncompressed_size)
@@ -35,6 +54,17 @@ decompress_contents (bfd_byte *compressed_buffer,
   z_stream strm;
   int rc;
 
+  if (is_zstd)
+    {
+#ifdef HAVE_ZSTD
+      size_t ret = ZSTD_decompress (uncompressed_buffer, uncompressed_size,
+				    compressed_buffer, compressed_size);
+      return !ZSTD_isError (ret) && ret == uncompressed_size;
+#else
+      return FALSE;
+#endif
+    }
+
   /* It is possible the section consists of several compressed
      buffers concatenated together, so we uncompress in a loop.  */
   /* PR 18313: The state field in the z_stream structure is supposed
@@ -67,7 +97,8 @@ decompress_contents (bfd_byte *compressed_buffer,
 /* Compress data of the size specified in @var{uncompressed_size}
    and pointed to by @var{uncompressed_buffer} using zlib and store
    as the contents field.  This function assumes the contents
-   field was allocated using bfd_malloc() or equivalent.
+   field was allocated using bfd_malloc() or equivalent, and takes
+   ownership of @var{uncompressed_buffer} whether or not it succeeds.
 
    Return the uncompressed size if the full section contents is
    compressed successfully.  Otherwise return 0.  */
@@ -85,18 +116,65 @@ bfd_compress_section_contents (bfd *abfd, sec_ptr sec,
   int orig_compression_header_size;
   bfd_size_type orig_uncompressed_size;
   unsigned int orig_uncompressed_alignment_pow;
+  unsigned int orig_ch_type;
   int header_size = bfd_get_compression_header_size (abfd, NULL);
   bfd_boolean compressed
-    = bfd_is_section_compressed_with_header (abfd, sec,
-					     &orig_compression_header_size,
-					     &orig_uncompressed_size,
-					     &orig_uncompressed_alignment_pow);
+    = bfd_is_section_compressed_info (abfd, sec,
+				      &orig_compression_header_size,
+				      &orig_uncompressed_size,
+				      &orig_uncompressed_alignment_pow,
+				      &orig_ch_type);
+  /* zstd is only used with the ELF compression header.  */
+  bfd_boolean use_zstd = (header_size != 0
+			  && (abfd->flags & BFD_COMPRESS_ZSTD) != 0);
+
+#ifndef HAVE_ZSTD
+  if (use_zstd)
+    {
+      bfd_set_error (bfd_error_invalid_operation);
+      free (uncompressed_buffer);
+      return 0;
+    }
+#endif
 
   /* Either ELF compression header or the 12-byte, "ZLIB" + 8-byte size,
      overhead in .zdebug* section.  */
   if (!header_size)
      header_size = 12;
 
+  /* A section compressed with another algorithm than the requested one
+     is decompressed, and then compressed again.  */
+  if (compressed
+      && orig_compression_header_size >= 0
+      && orig_ch_type != (use_zstd ? ELFCOMPRESS_ZSTD : ELFCOMPRESS_ZLIB))
+    {
+      int orig_header_size = (orig_compression_header_size != 0
+			      ? orig_compression_header_size : 12);
+      bfd_byte *contents = (bfd_byte *) bfd_malloc (orig_uncompressed_size);
+
+      if (contents == NULL)
+	{
+	  free (uncompressed_buffer);
+	  return 0;
+	}
+      if (!decompress_contents (orig_ch_type == ELFCOMPRESS_ZSTD,
+				uncompressed_buffer + orig_header_size,
+				uncompressed_size - orig_header_size,
+				contents, orig_uncompressed_size))
+	{
+	  bfd_set_error (bfd_error_bad_value);
+	  free (contents);
+	  free (uncompressed_buffer);
+	  return 0;
+	}
+      free (uncompressed_buffer);
+      uncompressed_buffer = contents;
+      uncompressed_size = orig_uncompressed_size;
+      sec->size = orig_uncompressed_size;
+      bfd_set_section_alignment (sec, orig_uncompressed_alignment_pow);
+      compressed = FALSE;
+    }
+
   if (compressed)
     {
       /* We shouldn't decompress unsupported compressed section.  */
@@ -123,6 +201,10 @@ bfd_compress_section_contents (bfd *abfd, sec_ptr sec,
       /* Add the header size.  */
       compressed_size = zlib_size + header_size;
     }
+#ifdef HAVE_ZSTD
+  else if (use_zstd)
+    compressed_size = ZSTD_compressBound (uncompressed_size) + header_size;
+#endif
   else
     compressed_size = compressBound (uncompressed_size) + header_size;
 
@@ -139,19 +221,24 @@ bfd_compress_section_contents (bfd *abfd, sec_ptr sec,
     }
   buffer = (bfd_byte *) bfd_alloc (abfd, buffer_size);
   if (buffer == NULL)
-    return 0;
+    {
+      free (uncompressed_buffer);
+      return 0;
+    }
 
   if (compressed)
     {
       sec->size = orig_uncompressed_size;
       if (decompress)
 	{
-	  if (!decompress_contents (uncompressed_buffer
+	  if (!decompress_contents (orig_ch_type == ELFCOMPRESS_ZSTD,
+				    uncompressed_buffer
 				    + orig_compression_header_size,
 				    zlib_size, buffer, buffer_size))
 	    {
 	      bfd_set_error (bfd_error_bad_value);
 	      bfd_release (abfd, buffer);
+	      free (uncompressed_buffer);
 	      return 0;
 	    }
 	  free (uncompressed_buffer);
@@ -171,6 +258,25 @@ bfd_compress_section_contents (bfd *abfd, sec_ptr sec,
     }
   else
     {
+#ifdef HAVE_ZSTD
+      if (use_zstd)
+	{
+	  size_t size = ZSTD_compress (buffer + header_size,
+				       compressed_size - header_size,
+				       uncompressed_buffer,
+				       uncompressed_size,
+				       ZSTD_CLEVEL_DEFAULT);
+	  if (ZSTD_isError (size))
+	    {
+	      bfd_release (abfd, buffer);
+	      bfd_set_error (bfd_error_bad_value);
+	      free (uncompressed_buffer);
+	      return 0;
+	    }
+	  compressed_size = size;
+	}
+      else
+#endif
       if (compress ((Bytef*) buffer + header_size,
 		    &compressed_size,
 		    (const Bytef*) uncompressed_buffer,
@@ -178,6 +284,7 @@ bfd_compress_section_contents (bfd *abfd, sec_ptr sec,
 	{
 	  bfd_release (abfd, buffer);
 	  bfd_set_error (bfd_error_bad_value);
+	  free (uncompressed_buffer);
 	  return 0;
 	}
 
@@ -233,6 +340,7 @@ bfd_get_full_section_contents (bfd *abfd, sec_ptr sec, bfd_byte **ptr)
   bfd_size_type save_rawsize;
   bfd_byte *compressed_buffer;
   unsigned int compression_header_size;
+  bfd_boolean is_zstd;
 
   if (abfd->direction != write_direction && sec->rawsize != 0)
     sz = sec->rawsize;
@@ -322,11 +430,15 @@ bfd_get_full_section_contents (bfd *abfd, sec_ptr sec, bfd_byte **ptr)
 	goto fail_compressed;
 
       compression_header_size = bfd_get_compression_header_size (abfd, sec);
+      is_zstd = (compression_type (abfd, compressed_buffer,
+				   compression_header_size)
+		 == ELFCOMPRESS_ZSTD);
       if (compression_header_size == 0)
 	/* Set header size to the zlib header size if it is a
 	   SHF_COMPRESSED section.  */
 	compression_header_size = 12;
-      if (!decompress_contents (compressed_buffer + compression_header_size,
+      if (!decompress_contents (is_zstd,
+				compressed_buffer + compression_header_size,
 				sec->compressed_size - compression_header_size, p, sz))
 	{
 	  bfd_set_error (bfd_error_bad_value);
@@ -409,6 +521,41 @@ bfd_is_section_compressed_with_header (bfd *abfd, sec_ptr sec,
 				       int *compression_header_size_p,
 				       bfd_size_type *uncompressed_size_p,
 				       unsigned int *uncompressed_align_pow_p)
+{
+  unsigned int ch_type;
+
+  return bfd_is_section_compressed_info (abfd, sec,
+					 compression_header_size_p,
+					 uncompressed_size_p,
+					 uncompressed_align_pow_p,
+					 &ch_type);
+}
+
+/*
+FUNCTION
+	bfd_is_section_compressed_info
+
+SYNOPSIS
+	bfd_boolean bfd_is_section_compressed_info
+	  (bfd *abfd, asection *section,
+	  int *compression_header_size_p,
+	  bfd_size_type *uncompressed_size_p,
+	  unsigned int *uncompressed_alignment_power_p,
+	  unsigned int *ch_type_p);
+
+DESCRIPTION
+	Like @code{bfd_is_section_compressed_with_header}, and also
+	return the compression type, an @code{ELFCOMPRESS_*} value, in
+	@var{ch_type_p}.  Sections without an ELF compression header
+	are compressed with zlib.
+*/
+
+bfd_boolean
+bfd_is_section_compressed_info (bfd *abfd, sec_ptr sec,
+				int *compression_header_size_p,
+				bfd_size_type *uncompressed_size_p,
+				unsigned int *uncompressed_align_pow_p,
+				unsigned int *ch_type_p)
 {
   bfd_byte header[MAX_COMPRESSION_HEADER_SIZE];
   int compression_header_size;
@@ -440,8 +587,10 @@ bfd_is_section_compressed_with_header (bfd *abfd, sec_ptr sec,
     compressed = FALSE;
 
   *uncompressed_size_p = sec->size;
+  *ch_type_p = 0;
   if (compressed)
     {
+      *ch_type_p = compression_type (abfd, header, compression_header_size);
       if (compression_header_size != 0)
 	{
 	  if (!bfd_check_compression_header (abfd, header, sec,
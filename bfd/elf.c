@@ -1199,11 +1199,13 @@ _bfd_elf_make_section_from_shdr (bfd *abfd,
       int compression_header_size;
       bfd_size_type uncompressed_size;
       unsigned int uncompressed_align_power;
+      unsigned int ch_type;
       bfd_boolean compressed
-	= bfd_is_section_compressed_with_header (abfd, newsect,
-						 &compression_header_size,
-						 &uncompressed_size,
-						 &uncompressed_align_power);
+	= bfd_is_section_compressed_info (abfd, newsect,
+					  &compression_header_size,
+					  &uncompressed_size,
+					  &uncompressed_align_power,
+					  &ch_type);
       if (compressed)
 	{
 	  /* Compressed section.  Check if we should decompress.  */
@@ -1215,13 +1217,18 @@ _bfd_elf_make_section_from_shdr (bfd *abfd,
 	 section.  Check if we should compress.  */
       if (action == nothing)
 	{
+	  bfd_boolean gabi = (abfd->flags & BFD_COMPRESS_GABI) != 0;
+	  unsigned int new_ch_type
+	    = (gabi && (abfd->flags & BFD_COMPRESS_ZSTD) != 0
+	       ? ELFCOMPRESS_ZSTD : ELFCOMPRESS_ZLIB);
+
 	  if (newsect->size != 0
 	      && (abfd->flags & BFD_COMPRESS)
 	      && compression_header_size >= 0
 	      && uncompressed_size > 0
 	      && (!compressed
-		  || ((compression_header_size > 0)
-		      != ((abfd->flags & BFD_COMPRESS_GABI) != 0))))
+		  || (compression_header_size > 0) != gabi
+		  || ch_type != new_ch_type))
 	    action = compress;
 	  else
 	    return TRUE;
@@ -3068,7 +3075,11 @@ bfd_section_from_phdr (bfd *abfd, Elf_Internal_Phdr *hdr, int hdr_index)
     case PT_LOAD:
       if (! _bfd_elf_make_section_from_phdr (abfd, hdr, hdr_index, "load"))
 	return FALSE;
-      if (bfd_get_format (abfd) == bfd_core && abfd->build_id == NULL)
+      /* A segment without contents in the file can't hold the ELF
+	 header of a mapped file; its offset may even be that of the
+	 core file's own header.  */
+      if (bfd_get_format (abfd) == bfd_core && abfd->build_id == NULL
+	  && hdr->p_filesz != 0)
 	_bfd_elf_core_find_build_id (abfd, hdr->p_offset);
       return TRUE;
 
@@ -230,6 +230,7 @@ static enum
   compress_zlib = compress | 1 << 1,
   compress_gnu_zlib = compress | 1 << 2,
   compress_gabi_zlib = compress | 1 << 3,
+  compress_zstd = compress | 1 << 5,
   decompress = 1 << 4
 } do_debug_sections = nothing;
 
@@ -672,9 +673,10 @@ copy_usage (FILE *stream, int exit_status)
                                    <commit>\n\
      --subsystem <name>[:<version>]\n\
                                    Set PE subsystem to <name> [& <version>]\n\
-     --compress-debug-sections[={none|zlib|zlib-gnu|zlib-gabi}]\n\
+     --compress-debug-sections[={none|zlib|zlib-gnu|zlib-gabi|zstd}]\n\
                                    Compress DWARF debug sections using zlib\n\
-     --decompress-debug-sections   Decompress DWARF debug sections using zlib\n\
+                                   or zstd\n\
+     --decompress-debug-sections   Decompress DWARF debug sections\n\
      --elf-stt-common=[yes|no]     Generate ELF common symbols with STT_COMMON\n\
                                      type\n\
      --verilog-data-width <number> Specifies data width, in bytes, for verilog output\n\
@@ -2626,7 +2628,7 @@ copy_object (bfd *ibfd, bfd *obfd, const bfd_arch_info_type *input_arch)
       if ((do_debug_sections & compress) != 0
 	  && do_debug_sections != compress)
 	{
-	  non_fatal (_("--compress-debug-sections=[zlib|zlib-gnu|zlib-gabi] is unsupported on `%s'"),
+	  non_fatal (_("--compress-debug-sections=[zlib|zlib-gnu|zlib-gabi|zstd] is unsupported on `%s'"),
 		     bfd_get_archive_filename (ibfd));
 	  return FALSE;
 	}
@@ -3747,11 +3749,14 @@ copy_file (const char *input_filename, const char *output_filename,
     case compress_zlib:
     case compress_gnu_zlib:
     case compress_gabi_zlib:
+    case compress_zstd:
       ibfd->flags |= BFD_COMPRESS;
       /* Don't check if input is ELF here since this information is
 	 only available after bfd_check_format_matches is called.  */
       if (do_debug_sections != compress_gnu_zlib)
 	ibfd->flags |= BFD_COMPRESS_GABI;
+      if (do_debug_sections == compress_zstd)
+	ibfd->flags |= BFD_COMPRESS_ZSTD;
       break;
     case decompress:
       ibfd->flags |= BFD_DECOMPRESS;
@@ -5387,6 +5392,15 @@ copy_main (int argc, char *argv[])
 		do_debug_sections = compress_gnu_zlib;
 	      else if (strcasecmp (optarg, "zlib-gabi") == 0)
 		do_debug_sections = compress_gabi_zlib;
+	      else if (strcasecmp (optarg, "zstd") == 0)
+		{
+#ifdef HAVE_ZSTD
+		  do_debug_sections = compress_zstd;
+#else
+		  fatal (_("--compress-debug-sections=zstd: binutils was "
+			   "built without zstd support"));
+#endif
+		}
 	      else
 		fatal (_("unrecognized --compress-debug-sections type `%s'"),
 		       optarg);
@@ -44,6 +44,9 @@
 #include <assert.h>
 #include <time.h>
 #include <zlib.h>
+#ifdef HAVE_ZSTD
+#include <zstd.h>
+#endif
 #ifdef HAVE_WCHAR_H
 #include <wchar.h>
 #endif
@@ -6858,6 +6861,8 @@ process_section_headers (Filedata * filedata)
 		    {
 		      if (chdr.ch_type == ELFCOMPRESS_ZLIB)
 			printf ("       ZLIB, ");
+		      else if (chdr.ch_type == ELFCOMPRESS_ZSTD)
+			printf ("       ZSTD, ");
 		      else
 			printf (_("       [<unknown>: 0x%x], "),
 				chdr.ch_type);
@@ -13770,10 +13775,27 @@ get_section_contents (Elf_Internal_Shdr * section, Filedata * filedata)
                              _("section contents"));
 }
 
-/* Uncompresses a section that was compressed using zlib, in place.  */
+/* Return TRUE if sections compressed with CH_TYPE can be
+   uncompressed.  */
 
 static bfd_boolean
-uncompress_section_contents (unsigned char **   buffer,
+supported_compression_type (unsigned int ch_type)
+{
+  if (ch_type == ELFCOMPRESS_ZLIB)
+    return TRUE;
+#ifdef HAVE_ZSTD
+  if (ch_type == ELFCOMPRESS_ZSTD)
+    return TRUE;
+#endif
+  return FALSE;
+}
+
+/* Uncompresses a section that was compressed using zlib, or zstd if
+   IS_ZSTD, in place.  */
+
+static bfd_boolean
+uncompress_section_contents (bfd_boolean        is_zstd,
+			     unsigned char **   buffer,
 			     dwarf_size_type    uncompressed_size,
 			     dwarf_size_type *  size)
 {
@@ -13783,6 +13805,27 @@ uncompress_section_contents (unsigned char **   buffer,
   z_stream strm;
   int rc;
 
+  uncompressed_buffer = (unsigned char *) xmalloc (uncompressed_size);
+
+#ifdef HAVE_ZSTD
+  if (is_zstd)
+    {
+      /* Like the zlib streams below, the section may hold several
+	 zstd frames; ZSTD_decompress handles them all.  */
+      size_t ret = ZSTD_decompress (uncompressed_buffer, uncompressed_size,
+				    compressed_buffer, compressed_size);
+      if (ZSTD_isError (ret) || ret != uncompressed_size)
+	goto fail;
+
+      *buffer = uncompressed_buffer;
+      *size = uncompressed_size;
+      return TRUE;
+    }
+#else
+  if (is_zstd)
+    goto fail;
+#endif
+
   /* It is possible the section consists of several compressed
      buffers concatenated together, so we uncompress in a loop.  */
   /* PR 18313: The state field in the z_stream structure is supposed
@@ -13794,7 +13837,6 @@ uncompress_section_contents (unsigned char **   buffer,
   strm.avail_in = compressed_size;
   strm.next_in = (Bytef *) compressed_buffer;
   strm.avail_out = uncompressed_size;
-  uncompressed_buffer = (unsigned char *) xmalloc (uncompressed_size);
 
   rc = inflateInit (& strm);
   while (strm.avail_in > 0)
@@ -13848,6 +13890,7 @@ dump_section_as_strings (Elf_Internal_Shdr * section, Filedata * filedata)
     {
       dwarf_size_type new_size = num_bytes;
       dwarf_size_type uncompressed_size = 0;
+      bfd_boolean is_zstd = FALSE;
 
       if ((section->sh_flags & SHF_COMPRESSED) != 0)
 	{
@@ -13860,12 +13903,13 @@ dump_section_as_strings (Elf_Internal_Shdr * section, Filedata * filedata)
 	       by get_compression_header.  */
 	    goto error_out;
 
-	  if (chdr.ch_type != ELFCOMPRESS_ZLIB)
+	  if (!supported_compression_type (chdr.ch_type))
 	    {
 	      warn (_("section '%s' has unsupported compress type: %d\n"),
 		    printable_section_name (filedata, section), chdr.ch_type);
 	      goto error_out;
 	    }
+	  is_zstd = chdr.ch_type == ELFCOMPRESS_ZSTD;
 	  uncompressed_size = chdr.ch_size;
 	  start += compression_header_size;
 	  new_size -= compression_header_size;
@@ -13889,7 +13933,7 @@ dump_section_as_strings (Elf_Internal_Shdr * section, Filedata * filedata)
 
       if (uncompressed_size)
 	{
-	  if (uncompress_section_contents (& start,
+	  if (uncompress_section_contents (is_zstd, & start,
 					   uncompressed_size, & new_size))
 	    num_bytes = new_size;
 	  else
@@ -14064,6 +14108,7 @@ dump_section_as_bytes (Elf_Internal_Shdr *  section,
     {
       dwarf_size_type new_size = section_size;
       dwarf_size_type uncompressed_size = 0;
+      bfd_boolean is_zstd = FALSE;
 
       if ((section->sh_flags & SHF_COMPRESSED) != 0)
 	{
@@ -14076,12 +14121,13 @@ dump_section_as_bytes (Elf_Internal_Shdr *  section,
 	       by get_compression_header.  */
 	    goto error_out;
 
-	  if (chdr.ch_type != ELFCOMPRESS_ZLIB)
+	  if (!supported_compression_type (chdr.ch_type))
 	    {
 	      warn (_("section '%s' has unsupported compress type: %d\n"),
 		    printable_section_name (filedata, section), chdr.ch_type);
 	      goto error_out;
 	    }
+	  is_zstd = chdr.ch_type == ELFCOMPRESS_ZSTD;
 	  uncompressed_size = chdr.ch_size;
 	  start += compression_header_size;
 	  new_size -= compression_header_size;
@@ -14105,7 +14151,7 @@ dump_section_as_bytes (Elf_Internal_Shdr *  section,
 
       if (uncompressed_size)
 	{
-	  if (uncompress_section_contents (& start, uncompressed_size,
+	  if (uncompress_section_contents (is_zstd, & start, uncompressed_size,
 					   & new_size))
 	    {
 	      section_size = new_size;
@@ -14437,6 +14483,7 @@ load_specific_debug_section (enum dwarf_section_display_enum  debug,
       unsigned char *start = section->start;
       dwarf_size_type size = sec->sh_size;
       dwarf_size_type uncompressed_size = 0;
+      bfd_boolean is_zstd = FALSE;
 
       if ((sec->sh_flags & SHF_COMPRESSED) != 0)
 	{
@@ -14458,12 +14505,13 @@ load_specific_debug_section (enum dwarf_section_display_enum  debug,
 	       by get_compression_header.  */
 	    return FALSE;
 
-	  if (chdr.ch_type != ELFCOMPRESS_ZLIB)
+	  if (!supported_compression_type (chdr.ch_type))
 	    {
 	      warn (_("section '%s' has unsupported compress type: %d\n"),
 		    section->name, chdr.ch_type);
 	      return FALSE;
 	    }
+	  is_zstd = chdr.ch_type == ELFCOMPRESS_ZSTD;
 	  uncompressed_size = chdr.ch_size;
 	  start += compression_header_size;
 	  size -= compression_header_size;
@@ -14487,7 +14535,7 @@ load_specific_debug_section (enum dwarf_section_display_enum  debug,
 
       if (uncompressed_size)
 	{
-	  if (uncompress_section_contents (&start, uncompressed_size,
+	  if (uncompress_section_contents (is_zstd, &start, uncompressed_size,
 					   &size))
 	    {
 	      /* Free the compressed buffer, update the section buffer
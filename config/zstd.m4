@@ -0,0 +1,43 @@
+dnl Copyright (C) 2020 Free Software Foundation, Inc.
+dnl This file is free software, distributed under the terms of the GNU
+dnl General Public License.  As a special exception to the GNU General
+dnl Public License, this file may be distributed as part of a program
+dnl that contains a configuration script generated by Autoconf, under
+dnl the same distribution terms as the rest of that program.
+
+dnl Check for libzstd, used for sections compressed with
+dnl ELFCOMPRESS_ZSTD.  The streaming API used to compress them,
+dnl ZSTD_compressStream2, needs zstd 1.4.0 or later.  Defines HAVE_ZSTD
+dnl and substitutes ZSTD_LIBS.
+AC_DEFUN([AC_ZSTD],
+[
+# Enable zstd
+AC_ARG_WITH([zstd],
+        AC_HELP_STRING([--with-zstd],
+                       [Support zstd compressed debug sections (auto/yes/no)]),
+        [], [with_zstd=auto])
+AC_MSG_CHECKING([whether to use zstd])
+AC_MSG_RESULT([$with_zstd])
+
+ZSTD_LIBS=
+if test "${with_zstd}" != no; then
+  AC_CACHE_CHECK([for zstd 1.4.0 or later], [acx_cv_zstd],
+    [acx_save_LIBS=$LIBS
+     LIBS="-lzstd $LIBS"
+     AC_LINK_IFELSE([AC_LANG_PROGRAM([[#include <zstd.h>]],
+[[ZSTD_CCtx *ctx = ZSTD_createCCtx ();
+ZSTD_inBuffer in = { 0, 0, 0 };
+ZSTD_outBuffer out = { 0, 0, 0 };
+return ZSTD_isError (ZSTD_compressStream2 (ctx, &out, &in, ZSTD_e_end));]])],
+       [acx_cv_zstd=yes], [acx_cv_zstd=no])
+     LIBS=$acx_save_LIBS])
+  if test "x$acx_cv_zstd" = "xyes"; then
+    AC_DEFINE([HAVE_ZSTD], [1],
+              [Define to 1 if zstd is enabled.])
+    ZSTD_LIBS="-lzstd"
+  elif test "$with_zstd" = yes; then
+    AC_MSG_ERROR([zstd 1.4.0 or later is missing or unusable])
+  fi
+fi
+AC_SUBST([ZSTD_LIBS])
+])
@@ -21,16 +21,29 @@
 #include "config.h"
 #include <stdio.h>
 #include <zlib.h>
+#ifdef HAVE_ZSTD
+#include <zstd.h>
+#endif
 #include "ansidecl.h"
+#include "bfd.h"
 #include "compress-debug.h"
 
 /* Initialize the compression engine.  */
 
-struct z_stream_s *
-compress_init (void)
+void *
+compress_init (bfd_boolean use_zstd)
 {
   static struct z_stream_s strm;
 
+  if (use_zstd)
+    {
+#ifdef HAVE_ZSTD
+      return ZSTD_createCCtx ();
+#else
+      return NULL;
+#endif
+    }
+
   strm.zalloc = NULL;
   strm.zfree = NULL;
   strm.opaque = NULL;
@@ -42,12 +55,34 @@ compress_init (void)
    from the engine goes into the current frag on the obstack.  */
 
 int
-compress_data (struct z_stream_s *strm, const char **next_in,
+compress_data (bfd_boolean use_zstd, void *ctx, const char **next_in,
 	       int *avail_in, char **next_out, int *avail_out)
 {
+  struct z_stream_s *strm = (struct z_stream_s *) ctx;
   int out_size = 0;
   int x;
 
+  if (use_zstd)
+    {
+#ifdef HAVE_ZSTD
+      ZSTD_outBuffer ob = { *next_out, *avail_out, 0 };
+      ZSTD_inBuffer ib = { *next_in, *avail_in, 0 };
+      size_t ret = ZSTD_compressStream2 ((ZSTD_CCtx *) ctx, &ob, &ib,
+					 ZSTD_e_continue);
+
+      if (ZSTD_isError (ret))
+	return -1;
+      out_size = ob.pos;
+      *next_in += ib.pos;
+      *avail_in -= ib.pos;
+      *next_out += ob.pos;
+      *avail_out -= ob.pos;
+      return out_size;
+#else
+      return -1;
+#endif
+    }
+
   strm->next_in = (Bytef *) (*next_in);
   strm->avail_in = *avail_in;
   strm->next_out = (Bytef *) (*next_out);
@@ -71,11 +106,33 @@ compress_data (struct z_stream_s *strm, const char **next_in,
    needed.  */
 
 int
-compress_finish (struct z_stream_s *strm, char **next_out,
+compress_finish (bfd_boolean use_zstd, void *ctx, char **next_out,
 		 int *avail_out, int *out_size)
 {
+  struct z_stream_s *strm = (struct z_stream_s *) ctx;
   int x;
 
+  if (use_zstd)
+    {
+#ifdef HAVE_ZSTD
+      ZSTD_CCtx *cctx = (ZSTD_CCtx *) ctx;
+      ZSTD_outBuffer ob = { *next_out, *avail_out, 0 };
+      ZSTD_inBuffer ib = { NULL, 0, 0 };
+      size_t ret = ZSTD_compressStream2 (cctx, &ob, &ib, ZSTD_e_end);
+
+      *out_size = ob.pos;
+      *next_out += ob.pos;
+      *avail_out -= ob.pos;
+      if (ZSTD_isError (ret))
+	return -1;
+      if (ret == 0)
+	return 0;
+      return 1;
+#else
+      return -1;
+#endif
+    }
+
   strm->avail_in = 0;
   strm->next_out = (Bytef *) (*next_out);
   strm->avail_out = *avail_out;
@@ -87,11 +144,24 @@ compress_finish (struct z_stream_s *strm, char **next_out,
   *avail_out = strm->avail_out;
 
   if (x == Z_STREAM_END)
-    {
-      deflateEnd (strm);
-      return 0;
-    }
+    return 0;
   if (strm->avail_out != 0)
     return -1;
   return 1;
 }
+
+/* Release the compression engine.  */
+
+void
+compress_end (bfd_boolean use_zstd, void *ctx)
+{
+  if (use_zstd)
+    {
+#ifdef HAVE_ZSTD
+      ZSTD_freeCCtx ((ZSTD_CCtx *) ctx);
+#endif
+      return;
+    }
+
+  deflateEnd ((struct z_stream_s *) ctx);
+}
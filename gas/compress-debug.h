@@ -21,19 +21,24 @@
 #ifndef COMPRESS_DEBUG_H
 #define COMPRESS_DEBUG_H
 
-struct z_stream_s;
-
-/* Initialize the compression engine.  */
-extern struct z_stream_s *
-compress_init (void);
+/* Initialize the compression engine, for zstd if USE_ZSTD and for
+   zlib otherwise.  Return an opaque handle for the other functions.  */
+extern void *
+compress_init (bfd_boolean use_zstd);
 
 /* Stream the contents of a frag to the compression engine.  Output
    from the engine goes into the current frag on the obstack.  */
 extern int
-compress_data (struct z_stream_s *, const char **, int *, char **, int *);
+compress_data (bfd_boolean use_zstd, void *, const char **, int *, char **,
+	       int *);
 
 /* Finish the compression and consume the remaining compressed output.  */
 extern int
-compress_finish (struct z_stream_s *, char **, int *, int *);
+compress_finish (bfd_boolean use_zstd, void *, char **, int *, int *);
+
+/* Release the compression engine, whether or not the compression
+   finished.  */
+extern void
+compress_end (bfd_boolean use_zstd, void *);
 
 #endif /* COMPRESS_DEBUG_H */
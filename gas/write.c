@@ -1374,8 +1374,8 @@ write_relocs (bfd *abfd ATTRIBUTE_UNUSED, asection *sec,
 }
 
 static int
-compress_frag (struct z_stream_s *strm, const char *contents, int in_size,
-	       fragS **last_newf, struct obstack *ob)
+compress_frag (bfd_boolean use_zstd, void *ctx, const char *contents,
+	       int in_size, fragS **last_newf, struct obstack *ob)
 {
   int out_size;
   int total_out_size = 0;
@@ -1403,7 +1403,7 @@ compress_frag (struct z_stream_s *strm, const char *contents, int in_size,
 	as_fatal (_("can't extend frag"));
       next_out = obstack_next_free (ob);
       obstack_blank_fast (ob, avail_out);
-      out_size = compress_data (strm, &contents, &in_size,
+      out_size = compress_data (use_zstd, ctx, &contents, &in_size,
 				&next_out, &avail_out);
       if (out_size < 0)
         return -1;
@@ -1432,10 +1432,11 @@ compress_debug (bfd *abfd, asection *sec, void *xxx ATTRIBUTE_UNUSED)
   const char *section_name;
   char *compressed_name;
   char *header;
-  struct z_stream_s *strm;
+  void *ctx;
   int x;
   flagword flags = bfd_section_flags (sec);
   unsigned int header_size, compression_header_size;
+  bfd_boolean use_zstd = flag_compress_debug == COMPRESS_DEBUG_ZSTD;
 
   if (seginfo == NULL
       || sec->size < 32
@@ -1446,11 +1447,11 @@ compress_debug (bfd *abfd, asection *sec, void *xxx ATTRIBUTE_UNUSED)
   if (strncmp (section_name, ".debug_", 7) != 0)
     return;
 
-  strm = compress_init ();
-  if (strm == NULL)
+  ctx = compress_init (use_zstd);
+  if (ctx == NULL)
     return;
 
-  if (flag_compress_debug == COMPRESS_DEBUG_GABI_ZLIB)
+  if (flag_compress_debug == COMPRESS_DEBUG_GABI_ZLIB || use_zstd)
     {
       compression_header_size
 	= bfd_get_compression_header_size (stdoutput, NULL);
@@ -1492,10 +1493,10 @@ compress_debug (bfd *abfd, asection *sec, void *xxx ATTRIBUTE_UNUSED)
       gas_assert (f->fr_type == rs_fill);
       if (f->fr_fix)
 	{
-	  out_size = compress_frag (strm, f->fr_literal, f->fr_fix,
+	  out_size = compress_frag (use_zstd, ctx, f->fr_literal, f->fr_fix,
 				    &last_newf, ob);
 	  if (out_size < 0)
-	    return;
+	    goto end;
 	  compressed_size += out_size;
 	}
       fill_literal = f->fr_literal + f->fr_fix;
@@ -1506,10 +1507,10 @@ compress_debug (bfd *abfd, asection *sec, void *xxx ATTRIBUTE_UNUSED)
 	{
 	  while (count--)
 	    {
-	      out_size = compress_frag (strm, fill_literal, (int) fill_size,
-				        &last_newf, ob);
+	      out_size = compress_frag (use_zstd, ctx, fill_literal,
+					(int) fill_size, &last_newf, ob);
 	      if (out_size < 0)
-		return;
+		goto end;
 	      compressed_size += out_size;
 	    }
 	}
@@ -1540,9 +1541,9 @@ compress_debug (bfd *abfd, asection *sec, void *xxx ATTRIBUTE_UNUSED)
 	as_fatal (_("can't extend frag"));
       next_out = obstack_next_free (ob);
       obstack_blank_fast (ob, avail_out);
-      x = compress_finish (strm, &next_out, &avail_out, &out_size);
+      x = compress_finish (use_zstd, ctx, &next_out, &avail_out, &out_size);
       if (x < 0)
-	return;
+	goto end;
 
       last_newf->fr_fix += out_size;
       compressed_size += out_size;
@@ -1558,7 +1559,7 @@ compress_debug (bfd *abfd, asection *sec, void *xxx ATTRIBUTE_UNUSED)
   /* PR binutils/18087: If compression didn't make the section smaller,
      just keep it uncompressed.  */
   if (compressed_size >= uncompressed_size)
-    return;
+    goto end;
 
   /* Replace the uncompressed frag list with the compressed frag list.  */
   seginfo->frchainP->frch_root = first_newf;
@@ -1573,6 +1574,9 @@ compress_debug (bfd *abfd, asection *sec, void *xxx ATTRIBUTE_UNUSED)
       compressed_name = concat (".z", section_name + 1, (char *) NULL);
       bfd_rename_section (sec, compressed_name);
     }
+
+ end:
+  compress_end (use_zstd, ctx);
 }
 
 #ifndef md_generate_nops
@@ -2485,6 +2489,8 @@ write_object_file (void)
     {
       if (flag_compress_debug == COMPRESS_DEBUG_GABI_ZLIB)
 	stdoutput->flags |= BFD_COMPRESS | BFD_COMPRESS_GABI;
+      else if (flag_compress_debug == COMPRESS_DEBUG_ZSTD)
+	stdoutput->flags |= BFD_COMPRESS | BFD_COMPRESS_GABI | BFD_COMPRESS_ZSTD;
       else
 	stdoutput->flags |= BFD_COMPRESS;
       bfd_map_over_sections (stdoutput, compress_debug, (char *) 0);
@@ -358,7 +358,7 @@ AC_DEFUN([GDB_AC_CHECK_BFD], [
   ZLIBDIR=`echo $zlibdir | sed 's,\$(top_builddir)/,,g'`
   LDFLAGS="-L../bfd -L../libiberty $ZLIBDIR $LDFLAGS"
   intl=`echo $LIBINTL | sed 's,${top_builddir}/,,g'`
-  LIBS="-lbfd -liberty -lz $intl $LIBS"
+  LIBS="-lbfd -liberty -lz $ZSTD_LIBS $intl $LIBS"
   AC_CACHE_CHECK([$1], [$2],
   [AC_TRY_LINK(
   [#include <stdlib.h>
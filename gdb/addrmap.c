@@ -18,15 +18,9 @@
    along with this program.  If not, see <http://www.gnu.org/licenses/>.  */
 
 #include "defs.h"
-#include "splay-tree.h"
 #include "gdb_obstack.h"
 #include "addrmap.h"
 
-/* Make sure splay trees can actually hold the values we want to
-   store in them.  */
-gdb_static_assert (sizeof (splay_tree_key) >= sizeof (CORE_ADDR *));
-gdb_static_assert (sizeof (splay_tree_value) >= sizeof (void *));
-
 
 /* The "abstract class".  */
 
@@ -213,6 +207,37 @@ static const struct addrmap_funcs addrmap_fixed_funcs =
 
 /* Mutable address maps.  */
 
+/* The maximum number of entries of a node of the B+ tree of a mutable
+   address map.  */
+#define ADDRMAP_NODE_SIZE 32
+
+/* A node of the B+ tree of a mutable address map.  */
+
+struct addrmap_node
+{
+  /* The number of entries in use.  */
+  int count;
+
+  /* True if this node is a leaf, whose entries are transitions: there
+     is a transition to VALUES[I] at KEYS[I].  Otherwise, the entries
+     are subtrees, and all the addresses in CHILDREN[I] are at least
+     KEYS[I], and less than KEYS[I + 1].  */
+  bool leaf;
+
+  /* The addresses of the entries, in increasing order.  */
+  CORE_ADDR keys[ADDRMAP_NODE_SIZE];
+
+  union
+  {
+    void *values[ADDRMAP_NODE_SIZE];
+    struct addrmap_node *children[ADDRMAP_NODE_SIZE];
+  };
+
+  /* For leaves, the previous and next leaves, in address order.  NEXT
+     also chains the nodes of the free list.  */
+  struct addrmap_node *prev, *next;
+};
+
 struct addrmap_mutable
 {
   struct addrmap addrmap;
@@ -220,117 +245,338 @@ struct addrmap_mutable
   /* The obstack to use for allocations for this map.  */
   struct obstack *obstack;
 
-  /* A splay tree, with a node for each transition; there is a
+  /* A B+ tree, with an entry for each transition; there is a
      transition at address T if T-1 and T map to different objects.
 
-     Any addresses below the first node map to NULL.  (Unlike
-     fixed maps, we have no entry at (CORE_ADDR) 0; it doesn't 
+     Any addresses below the first transition map to NULL.  (Unlike
+     fixed maps, we have no entry at (CORE_ADDR) 0; it doesn't
      simplify enough.)
 
      The last region is assumed to end at CORE_ADDR_MAX.
 
-     Since we can't know whether CORE_ADDR is larger or smaller than
-     splay_tree_key (unsigned long) --- I think both are possible,
-     given all combinations of 32- and 64-bit hosts and targets ---
-     our keys are pointers to CORE_ADDR values.  Since the splay tree
-     library doesn't pass any closure pointer to the key free
-     function, we can't keep a freelist for keys.  Since mutable
-     addrmaps are only used temporarily right now, we just leak keys
-     from deleted nodes; they'll be freed when the obstack is freed.  */
-  splay_tree tree;
-
-  /* A freelist for splay tree nodes, allocated on obstack, and
-     chained together by their 'right' pointers.  */
-  splay_tree_node free_nodes;
+     Unlike a splay tree, the tree is not modified by lookups, so
+     several threads may read the map at the same time, as long as
+     none modifies it.  Its leaves hold sorted arrays of transitions,
+     which makes lookups and traversals cache friendly.
+
+     The root is a leaf, possibly empty, until it has to be split.  No
+     other node is empty.  */
+  struct addrmap_node *root;
+
+  /* The first leaf of the tree.  */
+  struct addrmap_node *first_leaf;
+
+  /* The number of transitions in the tree.  */
+  size_t num_transitions;
+
+  /* A freelist for tree nodes, allocated on obstack, and chained
+     together by their 'next' pointers.  */
+  struct addrmap_node *free_nodes;
+};
+
+
+/* A position in the B+ tree of a mutable address map: the entry INDEX
+   of the leaf LEAF, or no position at all if LEAF is NULL.  */
+
+struct addrmap_position
+{
+  struct addrmap_node *leaf;
+  int index;
 };
 
 
-/* Allocate a copy of CORE_ADDR in MAP's obstack.  */
-static splay_tree_key
-allocate_key (struct addrmap_mutable *map, CORE_ADDR addr)
+/* Allocate a new, empty node for MAP.  */
+static struct addrmap_node *
+addrmap_node_alloc (struct addrmap_mutable *map, bool leaf)
 {
-  CORE_ADDR *key = XOBNEW (map->obstack, CORE_ADDR);
+  struct addrmap_node *node = map->free_nodes;
 
-  *key = addr;
-  return (splay_tree_key) key;
+  if (node != NULL)
+    map->free_nodes = node->next;
+  else
+    node = XOBNEW (map->obstack, struct addrmap_node);
+
+  node->count = 0;
+  node->leaf = leaf;
+  node->prev = NULL;
+  node->next = NULL;
+  return node;
 }
 
 
-/* Type-correct wrappers for splay tree access.  */
-static splay_tree_node
-addrmap_splay_tree_lookup (struct addrmap_mutable *map, CORE_ADDR addr)
+/* Put NODE on the free list of MAP.  */
+static void
+addrmap_node_free (struct addrmap_mutable *map, struct addrmap_node *node)
 {
-  return splay_tree_lookup (map->tree, (splay_tree_key) &addr);
+  node->next = map->free_nodes;
+  map->free_nodes = node;
 }
 
 
-static splay_tree_node
-addrmap_splay_tree_predecessor (struct addrmap_mutable *map, CORE_ADDR addr)
+/* Return the index of the last entry of NODE whose address is not
+   above ADDR, or -1 if there is none.  */
+static int
+addrmap_node_search (const struct addrmap_node *node, CORE_ADDR addr)
 {
-  return splay_tree_predecessor (map->tree, (splay_tree_key) &addr);
+  int low = 0;
+  int high = node->count;
+
+  while (low < high)
+    {
+      int mid = low + (high - low) / 2;
+
+      if (node->keys[mid] <= addr)
+	low = mid + 1;
+      else
+	high = mid;
+    }
+
+  return low - 1;
 }
 
 
-static splay_tree_node
-addrmap_splay_tree_successor (struct addrmap_mutable *map, CORE_ADDR addr)
+/* Return the position of the last transition of MAP at or below
+   ADDR.  */
+static struct addrmap_position
+addrmap_find_transition (const struct addrmap_mutable *map, CORE_ADDR addr)
 {
-  return splay_tree_successor (map->tree, (splay_tree_key) &addr);
+  struct addrmap_node *node = map->root;
+
+  while (!node->leaf)
+    {
+      int i = addrmap_node_search (node, addr);
+
+      node = node->children[i < 0 ? 0 : i];
+    }
+
+  int i = addrmap_node_search (node, addr);
+  if (i >= 0)
+    return { node, i };
+
+  /* All the transitions of NODE are above ADDR.  This happens when
+     ADDR is below the first transition of the subtree it belongs to,
+     in which case the transition we want ends the previous leaf.  */
+  if (node->prev != NULL)
+    return { node->prev, node->prev->count - 1 };
+  return { NULL, 0 };
 }
 
 
-static void
-addrmap_splay_tree_remove (struct addrmap_mutable *map, CORE_ADDR addr)
+/* Return the position following POS.  */
+static struct addrmap_position
+addrmap_next_transition (struct addrmap_position pos)
 {
-  splay_tree_remove (map->tree, (splay_tree_key) &addr);
+  if (pos.index + 1 < pos.leaf->count)
+    return { pos.leaf, pos.index + 1 };
+  if (pos.leaf->next != NULL)
+    return { pos.leaf->next, 0 };
+  return { NULL, 0 };
 }
 
 
-static CORE_ADDR
-addrmap_node_key (splay_tree_node node)
+/* Return the position of the first transition of MAP at or above
+   ADDR.  */
+static struct addrmap_position
+addrmap_find_transition_above (const struct addrmap_mutable *map,
+			       CORE_ADDR addr)
 {
-  return * (CORE_ADDR *) node->key;
+  struct addrmap_position pos = addrmap_find_transition (map, addr);
+
+  if (pos.leaf == NULL)
+    {
+      if (map->first_leaf->count == 0)
+	return { NULL, 0 };
+      return { map->first_leaf, 0 };
+    }
+  if (pos.leaf->keys[pos.index] < addr)
+    return addrmap_next_transition (pos);
+  return pos;
 }
 
 
-static void *
-addrmap_node_value (splay_tree_node node)
+/* Insert an entry for ADDR and VALUE (a child node, for internal
+   nodes) at index POS of NODE.  If NODE is full, split it first, and
+   return the new node holding its upper half; otherwise return
+   NULL.  */
+static struct addrmap_node *
+addrmap_node_insert_at (struct addrmap_mutable *map, struct addrmap_node *node,
+			int pos, CORE_ADDR addr, void *value)
 {
-  return (void *) node->value;
+  struct addrmap_node *right = NULL;
+
+  if (node->count == ADDRMAP_NODE_SIZE)
+    {
+      int half = ADDRMAP_NODE_SIZE / 2;
+
+      right = addrmap_node_alloc (map, node->leaf);
+      right->count = node->count - half;
+      memcpy (right->keys, node->keys + half,
+	      right->count * sizeof (node->keys[0]));
+      memcpy (right->values, node->values + half,
+	      right->count * sizeof (node->values[0]));
+      node->count = half;
+
+      if (node->leaf)
+	{
+	  right->prev = node;
+	  right->next = node->next;
+	  if (node->next != NULL)
+	    node->next->prev = right;
+	  node->next = right;
+	}
+
+      if (pos > half)
+	{
+	  node = right;
+	  pos -= half;
+	}
+    }
+
+  memmove (node->keys + pos + 1, node->keys + pos,
+	   (node->count - pos) * sizeof (node->keys[0]));
+  memmove (node->values + pos + 1, node->values + pos,
+	   (node->count - pos) * sizeof (node->values[0]));
+  node->keys[pos] = addr;
+  node->values[pos] = value;
+  node->count++;
+
+  return right;
 }
 
 
+/* Insert a transition at ADDR to VALUE in the subtree NODE of MAP.
+   There must be no transition at ADDR yet.  If NODE had to be split,
+   return the new node holding its upper half; otherwise return
+   NULL.  */
+static struct addrmap_node *
+addrmap_node_insert (struct addrmap_mutable *map, struct addrmap_node *node,
+		     CORE_ADDR addr, void *value)
+{
+  int i = addrmap_node_search (node, addr);
+
+  if (node->leaf)
+    {
+      gdb_assert (i < 0 || node->keys[i] != addr);
+      return addrmap_node_insert_at (map, node, i + 1, addr, value);
+    }
+
+  /* ADDR becomes the lowest address of the subtree.  */
+  if (i < 0)
+    {
+      i = 0;
+      node->keys[0] = addr;
+    }
+
+  struct addrmap_node *split
+    = addrmap_node_insert (map, node->children[i], addr, value);
+  if (split == NULL)
+    return NULL;
+
+  return addrmap_node_insert_at (map, node, i + 1, split->keys[0], split);
+}
+
+
+/* Insert a transition at ADDR to VALUE in MAP.  There must be no
+   transition at ADDR yet.  */
 static void
-addrmap_node_set_value (splay_tree_node node, void *value)
+addrmap_insert_transition (struct addrmap_mutable *map,
+			   CORE_ADDR addr, void *value)
 {
-  node->value = (splay_tree_value) value;
+  struct addrmap_node *split
+    = addrmap_node_insert (map, map->root, addr, value);
+
+  if (split != NULL)
+    {
+      struct addrmap_node *root = addrmap_node_alloc (map, false);
+
+      root->count = 2;
+      root->keys[0] = map->root->keys[0];
+      root->children[0] = map->root;
+      root->keys[1] = split->keys[0];
+      root->children[1] = split;
+      map->root = root;
+    }
+
+  map->num_transitions++;
 }
 
 
+/* Remove the transition at ADDR from the subtree NODE of MAP.  If
+   that leaves NODE empty and NODE isn't the root, unlink it and free
+   it, and return true.  */
+static bool
+addrmap_node_remove (struct addrmap_mutable *map, struct addrmap_node *node,
+		     CORE_ADDR addr)
+{
+  int i = addrmap_node_search (node, addr);
+
+  gdb_assert (i >= 0);
+  if (node->leaf)
+    gdb_assert (node->keys[i] == addr);
+  else if (!addrmap_node_remove (map, node->children[i], addr))
+    return false;
+
+  memmove (node->keys + i, node->keys + i + 1,
+	   (node->count - i - 1) * sizeof (node->keys[0]));
+  memmove (node->values + i, node->values + i + 1,
+	   (node->count - i - 1) * sizeof (node->values[0]));
+  node->count--;
+
+  if (node->count > 0 || node == map->root)
+    return false;
+
+  if (node->leaf)
+    {
+      if (node->prev != NULL)
+	node->prev->next = node->next;
+      else
+	map->first_leaf = node->next;
+      if (node->next != NULL)
+	node->next->prev = node->prev;
+    }
+
+  addrmap_node_free (map, node);
+  return true;
+}
+
+
+/* Remove the transition at ADDR from MAP.  */
 static void
-addrmap_splay_tree_insert (struct addrmap_mutable *map,
-			   CORE_ADDR key, void *value)
+addrmap_remove_transition (struct addrmap_mutable *map, CORE_ADDR addr)
 {
-  splay_tree_insert (map->tree,
-                     allocate_key (map, key),
-                     (splay_tree_value) value);
+  addrmap_node_remove (map, map->root, addr);
+  map->num_transitions--;
+
+  /* Shrink the tree when the root is left with a single child, or
+     none.  */
+  while (!map->root->leaf && map->root->count <= 1)
+    {
+      struct addrmap_node *root = map->root;
+
+      if (root->count == 1)
+	map->root = root->children[0];
+      else
+	{
+	  map->root = addrmap_node_alloc (map, true);
+	  map->first_leaf = map->root;
+	}
+      addrmap_node_free (map, root);
+    }
 }
 
 
 /* Without changing the mapping of any address, ensure that there is a
-   tree node at ADDR, even if it would represent a "transition" from
+   transition at ADDR, even if it would represent a "transition" from
    one value to the same value.  */
 static void
 force_transition (struct addrmap_mutable *self, CORE_ADDR addr)
 {
-  splay_tree_node n
-    = addrmap_splay_tree_lookup (self, addr);
+  struct addrmap_position pos = addrmap_find_transition (self, addr);
 
-  if (! n)
-    {
-      n = addrmap_splay_tree_predecessor (self, addr);
-      addrmap_splay_tree_insert (self, addr,
-                                 n ? addrmap_node_value (n) : NULL);
-    }
+  if (pos.leaf == NULL || pos.leaf->keys[pos.index] != addr)
+    addrmap_insert_transition (self, addr,
+			       (pos.leaf != NULL
+				? pos.leaf->values[pos.index] : NULL));
 }
 
 
@@ -340,7 +586,7 @@ addrmap_mutable_set_empty (struct addrmap *self,
                            void *obj)
 {
   struct addrmap_mutable *map = (struct addrmap_mutable *) self;
-  splay_tree_node n, next;
+  struct addrmap_position pos;
   void *prior_value;
 
   /* If we're being asked to set all empty portions of the given
@@ -361,29 +607,45 @@ addrmap_mutable_set_empty (struct addrmap *self,
     force_transition (map, end_inclusive + 1);
 
   /* Walk the area, changing all NULL regions to OBJ.  */
-  for (n = addrmap_splay_tree_lookup (map, start), gdb_assert (n);
-       n && addrmap_node_key (n) <= end_inclusive;
-       n = addrmap_splay_tree_successor (map, addrmap_node_key (n)))
+  for (pos = addrmap_find_transition (map, start);
+       pos.leaf != NULL && pos.leaf->keys[pos.index] <= end_inclusive;
+       pos = addrmap_next_transition (pos))
     {
-      if (! addrmap_node_value (n))
-        addrmap_node_set_value (n, obj);
+      if (pos.leaf->values[pos.index] == NULL)
+	pos.leaf->values[pos.index] = obj;
     }
 
   /* Walk the area again, removing transitions from any value to
      itself.  Be sure to visit both the transitions we forced
-     above.  */
-  n = addrmap_splay_tree_predecessor (map, start);
-  prior_value = n ? addrmap_node_value (n) : NULL;
-  for (n = addrmap_splay_tree_lookup (map, start), gdb_assert (n);
-       n && (end_inclusive == CORE_ADDR_MAX
-             || addrmap_node_key (n) <= end_inclusive + 1);
-       n = next)
+     above.  Removing a transition invalidates positions, so find
+     the next transition again by address.  */
+  prior_value = NULL;
+  if (start > 0)
+    {
+      pos = addrmap_find_transition (map, start - 1);
+      if (pos.leaf != NULL)
+	prior_value = pos.leaf->values[pos.index];
+    }
+  for (pos = addrmap_find_transition (map, start);
+       pos.leaf != NULL
+	 && (end_inclusive == CORE_ADDR_MAX
+	     || pos.leaf->keys[pos.index] <= end_inclusive + 1);
+       )
     {
-      next = addrmap_splay_tree_successor (map, addrmap_node_key (n));
-      if (addrmap_node_value (n) == prior_value)
-        addrmap_splay_tree_remove (map, addrmap_node_key (n));
+      CORE_ADDR addr = pos.leaf->keys[pos.index];
+
+      if (pos.leaf->values[pos.index] == prior_value)
+	{
+	  addrmap_remove_transition (map, addr);
+	  if (addr == CORE_ADDR_MAX)
+	    break;
+	  pos = addrmap_find_transition_above (map, addr);
+	}
       else
-        prior_value = addrmap_node_value (n);
+	{
+	  prior_value = pos.leaf->values[pos.index];
+	  pos = addrmap_next_transition (pos);
+	}
     }
 }
 
@@ -391,38 +653,12 @@ addrmap_mutable_set_empty (struct addrmap *self,
 static void *
 addrmap_mutable_find (struct addrmap *self, CORE_ADDR addr)
 {
-  /* Not needed yet.  */
-  internal_error (__FILE__, __LINE__,
-                  _("addrmap_find is not implemented yet "
-                    "for mutable addrmaps"));
-}
-
-
-/* A function to pass to splay_tree_foreach to count the number of nodes
-   in the tree.  */
-static int
-splay_foreach_count (splay_tree_node n, void *closure)
-{
-  size_t *count = (size_t *) closure;
-
-  (*count)++;
-  return 0;
-}
-
-
-/* A function to pass to splay_tree_foreach to copy entries into a
-   fixed address map.  */
-static int
-splay_foreach_copy (splay_tree_node n, void *closure)
-{
-  struct addrmap_fixed *fixed = (struct addrmap_fixed *) closure;
-  struct addrmap_transition *t = &fixed->transitions[fixed->num_transitions];
-
-  t->addr = addrmap_node_key (n);
-  t->value = addrmap_node_value (n);
-  fixed->num_transitions++;
+  struct addrmap_mutable *map = (struct addrmap_mutable *) self;
+  struct addrmap_position pos = addrmap_find_transition (map, addr);
 
-  return 0;
+  if (pos.leaf == NULL)
+    return NULL;
+  return pos.leaf->values[pos.index];
 }
 
 
@@ -434,13 +670,9 @@ addrmap_mutable_create_fixed (struct addrmap *self, struct obstack *obstack)
   size_t num_transitions;
   size_t alloc_len;
 
-  /* Count the number of transitions in the tree.  */
-  num_transitions = 0;
-  splay_tree_foreach (mutable_obj->tree, splay_foreach_count, &num_transitions);
-
   /* Include an extra entry for the transition at zero (which fixed
      maps have, but mutable maps do not.)  */
-  num_transitions++;
+  num_transitions = mutable_obj->num_transitions + 1;
 
   alloc_len = sizeof (*fixed)
 	      + (num_transitions * sizeof (fixed->transitions[0]));
@@ -450,9 +682,20 @@ addrmap_mutable_create_fixed (struct addrmap *self, struct obstack *obstack)
   fixed->transitions[0].addr = 0;
   fixed->transitions[0].value = NULL;
 
-  /* Copy all entries from the splay tree to the array, in order 
-     of increasing address.  */
-  splay_tree_foreach (mutable_obj->tree, splay_foreach_copy, fixed);
+  /* Copy all entries from the leaves to the array, in order of
+     increasing address.  */
+  for (struct addrmap_node *leaf = mutable_obj->first_leaf;
+       leaf != NULL;
+       leaf = leaf->next)
+    for (int i = 0; i < leaf->count; i++)
+      {
+	struct addrmap_transition *t
+	  = &fixed->transitions[fixed->num_transitions];
+
+	t->addr = leaf->keys[i];
+	t->value = leaf->values[i];
+	fixed->num_transitions++;
+      }
 
   /* We should have filled the array.  */
   gdb_assert (fixed->num_transitions == num_transitions);
@@ -471,39 +714,24 @@ addrmap_mutable_relocate (struct addrmap *self, CORE_ADDR offset)
 }
 
 
-/* Struct to map addrmap's foreach function to splay_tree's version.  */
-struct mutable_foreach_data
-{
-  addrmap_foreach_fn fn;
-  void *data;
-};
-
-
-/* This is a splay_tree_foreach_fn.  */
-
-static int
-addrmap_mutable_foreach_worker (splay_tree_node node, void *data)
-{
-  struct mutable_foreach_data *foreach_data
-    = (struct mutable_foreach_data *) data;
-
-  return foreach_data->fn (foreach_data->data,
-			   addrmap_node_key (node),
-			   addrmap_node_value (node));
-}
-
-
 static int
 addrmap_mutable_foreach (struct addrmap *self, addrmap_foreach_fn fn,
 			 void *data)
 {
   struct addrmap_mutable *mutable_obj = (struct addrmap_mutable *) self;
-  struct mutable_foreach_data foreach_data;
 
-  foreach_data.fn = fn;
-  foreach_data.data = data;
-  return splay_tree_foreach (mutable_obj->tree, addrmap_mutable_foreach_worker,
-			     &foreach_data);
+  for (struct addrmap_node *leaf = mutable_obj->first_leaf;
+       leaf != NULL;
+       leaf = leaf->next)
+    for (int i = 0; i < leaf->count; i++)
+      {
+	int res = fn (data, leaf->keys[i], leaf->values[i]);
+
+	if (res != 0)
+	  return res;
+      }
+
+  return 0;
 }
 
 
@@ -517,59 +745,6 @@ static const struct addrmap_funcs addrmap_mutable_funcs =
 };
 
 
-static void *
-splay_obstack_alloc (int size, void *closure)
-{
-  struct addrmap_mutable *map = (struct addrmap_mutable *) closure;
-  splay_tree_node n;
-
-  /* We should only be asked to allocate nodes and larger things.
-     (If, at some point in the future, this is no longer true, we can
-     just round up the size to sizeof (*n).)  */
-  gdb_assert (size >= sizeof (*n));
-
-  if (map->free_nodes)
-    {
-      n = map->free_nodes;
-      map->free_nodes = n->right;
-      return n;
-    }
-  else
-    return obstack_alloc (map->obstack, size);
-}
-
-
-static void
-splay_obstack_free (void *obj, void *closure)
-{
-  struct addrmap_mutable *map = (struct addrmap_mutable *) closure;
-  splay_tree_node n = (splay_tree_node) obj;
-
-  /* We've asserted in the allocation function that we only allocate
-     nodes or larger things, so it should be safe to put whatever
-     we get passed back on the free list.  */
-  n->right = map->free_nodes;
-  map->free_nodes = n;
-}
-
-
-/* Compare keys as CORE_ADDR * values.  */
-static int
-splay_compare_CORE_ADDR_ptr (splay_tree_key ak, splay_tree_key bk)
-{
-  CORE_ADDR a = * (CORE_ADDR *) ak;
-  CORE_ADDR b = * (CORE_ADDR *) bk;
-
-  /* We can't just return a-b here, because of over/underflow.  */
-  if (a < b)
-    return -1;
-  else if (a == b)
-    return 0;
-  else
-    return 1;
-}
-
-
 struct addrmap *
 addrmap_create_mutable (struct obstack *obstack)
 {
@@ -577,18 +752,10 @@ addrmap_create_mutable (struct obstack *obstack)
 
   map->addrmap.funcs = &addrmap_mutable_funcs;
   map->obstack = obstack;
-
-  /* splay_tree_new_with_allocator uses the provided allocation
-     function to allocate the main splay_tree structure itself, so our
-     free list has to be initialized before we create the tree.  */
   map->free_nodes = NULL;
-
-  map->tree = splay_tree_new_with_allocator (splay_compare_CORE_ADDR_ptr,
-                                             NULL, /* no delete key */
-                                             NULL, /* no delete value */
-                                             splay_obstack_alloc,
-                                             splay_obstack_free,
-                                             map);
+  map->num_transitions = 0;
+  map->root = addrmap_node_alloc (map, true);
+  map->first_leaf = map->root;
 
   return (struct addrmap *) map;
 }
@@ -3113,6 +3113,27 @@ amd64_in_indirect_branch_thunk (struct gdbarch *gdbarch, CORE_ADDR pc)
 				       AMD64_RIP_REGNUM);
 }
 
+/* Implement the "call_preserved_register_p" gdbarch method.  */
+
+static int
+amd64_call_preserved_register_p (struct gdbarch *gdbarch, int regnum)
+{
+  switch (regnum)
+    {
+    case AMD64_RBX_REGNUM:
+    case AMD64_RSP_REGNUM:
+    case AMD64_RBP_REGNUM:
+    case AMD64_R12_REGNUM:
+    case AMD64_R13_REGNUM:
+    case AMD64_R14_REGNUM:
+    case AMD64_R15_REGNUM:
+    case AMD64_RIP_REGNUM:
+      return 1;
+    default:
+      return 0;
+    }
+}
+
 void
 amd64_init_abi (struct gdbarch_info info, struct gdbarch *gdbarch,
 		const target_desc *default_tdesc)
@@ -3280,6 +3301,9 @@ amd64_init_abi (struct gdbarch_info info, struct gdbarch *gdbarch,
 
   set_gdbarch_in_indirect_branch_thunk (gdbarch,
 					amd64_in_indirect_branch_thunk);
+
+  set_gdbarch_call_preserved_register_p (gdbarch,
+					 amd64_call_preserved_register_p);
 }
 
 /* Initialize ARCH for x86-64, no osabi.  */
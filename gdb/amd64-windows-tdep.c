@@ -1208,6 +1208,33 @@ amd64_windows_auto_wide_charset (void)
   return "UTF-16";
 }
 
+/* Implement the "call_preserved_register_p" gdbarch method.  Unlike
+   the SysV ABI, the Windows x64 ABI also preserves RSI, RDI and XMM6
+   to XMM15 across calls.  */
+
+static int
+amd64_windows_call_preserved_register_p (struct gdbarch *gdbarch,
+					 int regnum)
+{
+  switch (regnum)
+    {
+    case AMD64_RBX_REGNUM:
+    case AMD64_RSP_REGNUM:
+    case AMD64_RBP_REGNUM:
+    case AMD64_RSI_REGNUM:
+    case AMD64_RDI_REGNUM:
+    case AMD64_R12_REGNUM:
+    case AMD64_R13_REGNUM:
+    case AMD64_R14_REGNUM:
+    case AMD64_R15_REGNUM:
+    case AMD64_RIP_REGNUM:
+      return 1;
+    default:
+      return (regnum >= AMD64_XMM0_REGNUM + 6
+	      && regnum <= AMD64_XMM0_REGNUM + 15);
+    }
+}
+
 /* Common parts for gdbarch initialization for Windows and Cygwin on AMD64.  */
 
 static void
@@ -1239,6 +1266,9 @@ amd64_windows_init_abi_common (gdbarch_info info, struct gdbarch *gdbarch)
   set_gdbarch_skip_prologue (gdbarch, amd64_windows_skip_prologue);
 
   set_gdbarch_auto_wide_charset (gdbarch, amd64_windows_auto_wide_charset);
+
+  set_gdbarch_call_preserved_register_p
+    (gdbarch, amd64_windows_call_preserved_register_p);
 }
 
 /* gdbarch initialization for Windows on AMD64.  */
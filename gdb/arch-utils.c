@@ -1022,6 +1022,14 @@ default_in_indirect_branch_thunk (gdbarch *gdbarch, CORE_ADDR pc)
 
 /* See arch-utils.h.  */
 
+int
+default_call_preserved_register_p (struct gdbarch *gdbarch, int regnum)
+{
+  return 1;
+}
+
+/* See arch-utils.h.  */
+
 ULONGEST
 default_type_align (struct gdbarch *gdbarch, struct type *type)
 {
@@ -0,0 +1,242 @@
+/* Compressed memory of core files written by GDB.
+
+   Copyright (C) 2020 Free Software Foundation, Inc.
+
+   This file is part of GDB.
+
+   This program is free software; you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation; either version 3 of the License, or
+   (at your option) any later version.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this program.  If not, see <http://www.gnu.org/licenses/>.  */
+
+#include "defs.h"
+#include "compressed-core.h"
+#include "elf-bfd.h"
+#include <algorithm>
+#include <zlib.h>
+
+/* The number of decompressed chunks kept by a
+   compressed_core_memory.  */
+#define COMPRESSED_CORE_CACHE_CHUNKS 16
+
+/* The largest chunk size accepted in a core file.  A chunk is
+   decompressed into a buffer of that size; "gcore -compress" writes
+   chunks of 256 KiB.  */
+#define COMPRESSED_CORE_MAX_CHUNK_SIZE (64 * 1024 * 1024)
+
+/* See compressed-core.h.  */
+
+std::unique_ptr<compressed_core_memory>
+compressed_core_memory::open (bfd *abfd)
+{
+  if (bfd_get_flavour (abfd) != bfd_target_elf_flavour)
+    return NULL;
+
+  /* BFD makes a section of each segment of a core file; find the one
+     of the compressed memory segment.  */
+  const Elf_Internal_Phdr *phdr = elf_tdata (abfd)->phdr;
+  asection *section = NULL;
+  for (unsigned int i = 0; i < elf_elfheader (abfd)->e_phnum; i++)
+    if (phdr[i].p_type == PT_GDB_COMPRESSED_MEMORY && phdr[i].p_filesz > 0)
+      for (asection *sec = abfd->sections; sec != NULL; sec = sec->next)
+	if ((bfd_section_flags (sec) & SEC_HAS_CONTENTS) != 0
+	    && sec->filepos == phdr[i].p_offset
+	    && bfd_section_size (sec) == phdr[i].p_filesz)
+	  section = sec;
+
+  if (section == NULL)
+    return NULL;
+
+  std::unique_ptr<compressed_core_memory> memory
+    (new compressed_core_memory (abfd, section));
+  bfd_size_type section_size = bfd_section_size (section);
+
+  auto malformed = [&] ()
+    {
+      error (_("Malformed compressed memory in core file \"%s\"."),
+	     bfd_get_filename (abfd));
+    };
+
+  gdb_byte header[COMPRESSED_CORE_HEADER_SIZE];
+  if (section_size < sizeof (header)
+      || !bfd_get_section_contents (abfd, section, header, 0,
+				    sizeof (header))
+      || memcmp (header, COMPRESSED_CORE_MAGIC,
+		 COMPRESSED_CORE_MAGIC_SIZE) != 0)
+    malformed ();
+
+  ULONGEST version = bfd_get_32 (abfd, header + 8);
+  ULONGEST method = bfd_get_32 (abfd, header + 12);
+  if (version != COMPRESSED_CORE_VERSION || method != COMPRESSED_CORE_ZLIB)
+    {
+      warning (_("Core file \"%s\" has compressed memory of an unsupported "
+		 "version (%s) or method (%s)."),
+	       bfd_get_filename (abfd), pulongest (version),
+	       pulongest (method));
+      return NULL;
+    }
+
+  memory->m_chunk_size = bfd_get_64 (abfd, header + 16);
+  ULONGEST num_regions = bfd_get_64 (abfd, header + 24);
+  ULONGEST num_chunks = bfd_get_64 (abfd, header + 32);
+  bfd_size_type available = section_size - sizeof (header);
+  if (memory->m_chunk_size == 0
+      || memory->m_chunk_size > COMPRESSED_CORE_MAX_CHUNK_SIZE
+      || num_regions > available / COMPRESSED_CORE_REGION_SIZE
+      || num_chunks > available / COMPRESSED_CORE_CHUNK_SIZE
+      || (num_regions * COMPRESSED_CORE_REGION_SIZE
+	  + num_chunks * COMPRESSED_CORE_CHUNK_SIZE) > available)
+    malformed ();
+
+  gdb::byte_vector tables (num_regions * COMPRESSED_CORE_REGION_SIZE
+			   + num_chunks * COMPRESSED_CORE_CHUNK_SIZE);
+  if (!bfd_get_section_contents (abfd, section, tables.data (),
+				 sizeof (header), tables.size ()))
+    malformed ();
+
+  const gdb_byte *p = tables.data ();
+  size_t first_chunk = 0;
+  for (ULONGEST i = 0; i < num_regions; i++)
+    {
+      region r;
+
+      r.addr = bfd_get_64 (abfd, p);
+      r.size = bfd_get_64 (abfd, p + 8);
+      r.first_chunk = first_chunk;
+      p += COMPRESSED_CORE_REGION_SIZE;
+
+      ULONGEST region_chunks = (r.size / memory->m_chunk_size
+				+ (r.size % memory->m_chunk_size != 0));
+      if (r.size == 0
+	  || r.addr + r.size < r.addr
+	  || region_chunks > num_chunks - first_chunk
+	  || (!memory->m_regions.empty ()
+	      && (memory->m_regions.back ().addr
+		  + memory->m_regions.back ().size) > r.addr))
+	malformed ();
+
+      first_chunk += region_chunks;
+      memory->m_regions.push_back (r);
+    }
+  if (first_chunk != num_chunks)
+    malformed ();
+
+  for (ULONGEST i = 0; i < num_chunks; i++)
+    {
+      chunk c;
+
+      c.offset = bfd_get_64 (abfd, p);
+      c.size = bfd_get_64 (abfd, p + 8);
+      p += COMPRESSED_CORE_CHUNK_SIZE;
+
+      if (c.offset > section_size || c.size > section_size - c.offset
+	  || c.size > memory->m_chunk_size)
+	malformed ();
+
+      memory->m_chunks.push_back (c);
+    }
+
+  return memory;
+}
+
+/* See compressed-core.h.  */
+
+enum target_xfer_status
+compressed_core_memory::xfer_partial (gdb_byte *readbuf, ULONGEST offset,
+				      ULONGEST *len, ULONGEST *xfered_len)
+{
+  auto iter = std::upper_bound (m_regions.begin (), m_regions.end (), offset,
+				[] (ULONGEST addr, const region &r)
+				{
+				  return addr < r.addr;
+				});
+
+  if (iter == m_regions.begin ()
+      || offset - (iter - 1)->addr >= (iter - 1)->size)
+    {
+      if (iter != m_regions.end ())
+	*len = std::min (*len, iter->addr - offset);
+      return TARGET_XFER_EOF;
+    }
+
+  const region &r = *(iter - 1);
+  if (readbuf == NULL)
+    return TARGET_XFER_E_IO;
+
+  ULONGEST pos = offset - r.addr;
+  ULONGEST index = pos / m_chunk_size;
+  ULONGEST within = pos % m_chunk_size;
+  ULONGEST chunk_len = std::min (m_chunk_size, r.size - index * m_chunk_size);
+  ULONGEST n = std::min (*len, chunk_len - within);
+
+  const gdb_byte *contents = chunk_contents (r.first_chunk + index,
+					     chunk_len);
+  if (contents == NULL)
+    return TARGET_XFER_E_IO;
+
+  memcpy (readbuf, contents + within, n);
+  *xfered_len = n;
+  return TARGET_XFER_OK;
+}
+
+const gdb_byte *
+compressed_core_memory::chunk_contents (size_t index, ULONGEST size)
+{
+  for (cache_entry &entry : m_cache)
+    if (entry.chunk == index)
+      {
+	entry.last_use = ++m_uses;
+	return entry.contents.data ();
+      }
+
+  const chunk &c = m_chunks[index];
+  gdb::byte_vector contents (size);
+
+  if (c.size == 0)
+    memset (contents.data (), 0, size);
+  else if (c.size == size)
+    {
+      if (!bfd_get_section_contents (m_bfd, m_section, contents.data (),
+				     c.offset, size))
+	return NULL;
+    }
+  else
+    {
+      gdb::byte_vector compressed (c.size);
+      uLongf contents_len = size;
+
+      if (!bfd_get_section_contents (m_bfd, m_section, compressed.data (),
+				     c.offset, c.size)
+	  || uncompress (contents.data (), &contents_len,
+			 compressed.data (), c.size) != Z_OK
+	  || contents_len != size)
+	return NULL;
+    }
+
+  /* Replace the least recently used chunk once the cache is full.  */
+  cache_entry *entry;
+  if (m_cache.size () < COMPRESSED_CORE_CACHE_CHUNKS)
+    {
+      m_cache.emplace_back ();
+      entry = &m_cache.back ();
+    }
+  else
+    entry = &*std::min_element (m_cache.begin (), m_cache.end (),
+				[] (const cache_entry &a, const cache_entry &b)
+				{
+				  return a.last_use < b.last_use;
+				});
+
+  entry->chunk = index;
+  entry->contents = std::move (contents);
+  entry->last_use = ++m_uses;
+  return entry->contents.data ();
+}
@@ -0,0 +1,153 @@
+/* Compressed memory of core files written by GDB.
+
+   Copyright (C) 2020 Free Software Foundation, Inc.
+
+   This file is part of GDB.
+
+   This program is free software; you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation; either version 3 of the License, or
+   (at your option) any later version.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this program.  If not, see <http://www.gnu.org/licenses/>.  */
+
+#ifndef COMPRESSED_CORE_H
+#define COMPRESSED_CORE_H
+
+#include "target.h"
+#include "elf/common.h"
+#include "gdbsupport/byte-vector.h"
+
+/* "gcore -compress" writes ELF core files whose PT_LOAD segments have
+   no contents in the file (a p_filesz of zero).  The memory of those
+   segments is instead kept in a single segment of type
+   PT_GDB_COMPRESSED_MEMORY, in chunks that are compressed
+   independently of each other, so that any part of the memory can be
+   read without decompressing the rest.
+
+   All the numbers of the segment are in the byte order of the core
+   file.  The segment starts with a header:
+
+     8 bytes   COMPRESSED_CORE_MAGIC
+     4 bytes   version, COMPRESSED_CORE_VERSION
+     4 bytes   compression method, see compressed_core_method
+     8 bytes   the size of the chunks, in bytes of memory
+     8 bytes   the number of regions
+     8 bytes   the number of chunks
+
+   followed by the regions, each being
+
+     8 bytes   the address of the region
+     8 bytes   the size of the region
+
+   followed by the chunks, each being
+
+     8 bytes   the offset of the chunk data in the segment
+     8 bytes   the size of the chunk data
+
+   and then by the data of the chunks.  The memory of each region is
+   divided into chunks of the chunk size, except for its last chunk,
+   which can be smaller; the chunks of the first region come first,
+   then those of the second one, and so on.  A chunk whose data is
+   empty is all zero; a chunk whose data has the size of the chunk is
+   stored uncompressed.  */
+
+/* The program header type of the compressed memory segment: "GDB"
+   in the OS-specific range, like the PT_GNU_* types use "GNU".  */
+#define PT_GDB_COMPRESSED_MEMORY (PT_LOOS + 0x4744420)
+
+#define COMPRESSED_CORE_MAGIC "GDBZMEM"
+#define COMPRESSED_CORE_MAGIC_SIZE 8
+#define COMPRESSED_CORE_VERSION 1
+
+/* The sizes of the header, of a region and of a chunk entry.  */
+#define COMPRESSED_CORE_HEADER_SIZE 40
+#define COMPRESSED_CORE_REGION_SIZE 16
+#define COMPRESSED_CORE_CHUNK_SIZE 16
+
+/* The methods the chunks can be compressed with.  */
+
+enum compressed_core_method
+{
+  /* A zlib stream, as written by compress2.  */
+  COMPRESSED_CORE_ZLIB = 1,
+};
+
+/* The compressed memory of a core file.  Chunks are decompressed when
+   they are first read, and the last few of them are kept.  */
+
+class compressed_core_memory
+{
+public:
+
+  /* Return the compressed memory of the core file ABFD, or NULL if it
+     has none.  Throw an error if it is malformed.  */
+  static std::unique_ptr<compressed_core_memory> open (bfd *abfd);
+
+  /* Read up to LEN bytes of memory at OFFSET into READBUF, see
+     target_ops::xfer_partial.  Return TARGET_XFER_EOF if OFFSET is not
+     in the compressed memory; LEN is then reduced so that it does not
+     reach into the compressed memory either.  */
+  enum target_xfer_status xfer_partial (gdb_byte *readbuf, ULONGEST offset,
+					ULONGEST *len,
+					ULONGEST *xfered_len);
+
+private:
+
+  /* A region of memory.  */
+  struct region
+  {
+    CORE_ADDR addr;
+    ULONGEST size;
+
+    /* The index of the first chunk of the region.  */
+    size_t first_chunk;
+  };
+
+  /* The data of a chunk in the segment.  */
+  struct chunk
+  {
+    ULONGEST offset;
+    ULONGEST size;
+  };
+
+  /* A decompressed chunk.  */
+  struct cache_entry
+  {
+    size_t chunk;
+    gdb::byte_vector contents;
+    unsigned long last_use;
+  };
+
+  compressed_core_memory (bfd *abfd, asection *section)
+    : m_bfd (abfd), m_section (section)
+  {
+  }
+
+  /* Return the decompressed contents of chunk INDEX, of SIZE bytes,
+     or NULL if it cannot be read.  */
+  const gdb_byte *chunk_contents (size_t index, ULONGEST size);
+
+  /* The core file, and its section holding the compressed memory
+     segment.  */
+  bfd *m_bfd;
+  asection *m_section;
+
+  ULONGEST m_chunk_size = 0;
+
+  /* The regions, sorted by address, and the chunks.  */
+  std::vector<region> m_regions;
+  std::vector<chunk> m_chunks;
+
+  /* The recently used chunks, and a counter of their uses.  */
+  std::vector<cache_entry> m_cache;
+  unsigned long m_uses = 0;
+};
+
+#endif /* COMPRESSED_CORE_H */
@@ -45,6 +45,11 @@
 #include "gdbsupport/filestuff.h"
 #include "build-id.h"
 #include "gdbsupport/pathstuff.h"
+#include "compressed-core.h"
+#include "gdbsupport/scoped_fd.h"
+#include "gdbsupport/scoped_mmap.h"
+#include <algorithm>
+#include <unordered_map>
 
 #ifndef O_LARGEFILE
 #define O_LARGEFILE 0
@@ -97,6 +102,10 @@ class core_target final : public process_stratum_target
 
   /* A few helpers.  */
 
+  /* Add a thread for each ".reg/LWP" section of the core file, and
+     switch to the one whose registers are also in ".reg".  */
+  void add_to_thread_list ();
+
   /* Getter, see variable definition.  */
   struct gdbarch *core_gdbarch ()
   {
@@ -121,6 +130,64 @@ class core_target final : public process_stratum_target
      targets.  */
   target_section_table m_core_section_table {};
 
+  /* The memory of the core file that is compressed, if any; it is not
+     in M_CORE_SECTION_TABLE.  */
+  std::unique_ptr<compressed_core_memory> m_compressed_memory;
+
+  /* Map the core file in memory, and fill M_MAPPED_SECTIONS.  */
+  void map_core_file ();
+
+  /* Fill M_THREAD_SECTIONS and M_THREAD_REG_SECTIONS.  */
+  void index_thread_sections ();
+
+  /* Return the section NAME of the thread PTID, "NAME/LWP" in the
+     core file, or NULL if there is none.  */
+  asection *find_thread_section (const char *name, ptid_t ptid);
+
+  /* Return the contents of SECTION in M_CORE_MAPPING, or NULL if they
+     must be read through BFD.  */
+  const gdb_byte *mapped_section_contents (asection *section);
+
+  /* A section of the core file holding data of a thread, such as its
+     registers.  */
+  struct thread_section
+  {
+    /* The name of the section, without its "/LWP" suffix; it is not
+       NUL-terminated.  */
+    const char *name;
+    size_t name_len;
+
+    asection *section;
+  };
+
+  /* The sections of each thread, by LWP, in the order of the core
+     file.  A thread only has a few of them, so looking up the
+     registers of a thread does not go through the name of every
+     section of the core file.  */
+  std::unordered_map<long, std::vector<thread_section>> m_thread_sections;
+
+  /* The ".reg/LWP" sections, in the order of the core file.  */
+  std::vector<asection *> m_thread_reg_sections;
+
+  /* A section of M_CORE_SECTION_TABLE whose contents are in
+     M_CORE_MAPPING.  */
+  struct mapped_section
+  {
+    CORE_ADDR addr;
+    CORE_ADDR endaddr;
+    const gdb_byte *contents;
+  };
+
+#ifdef HAVE_SYS_MMAN_H
+  /* The core file, mapped in memory.  The register sections are read
+     out of it too.  */
+  scoped_mmap m_core_mapping;
+#endif
+
+  /* The mapped sections, sorted by address.  Memory is read from them
+     with a copy out of M_CORE_MAPPING, instead of through BFD.  */
+  std::vector<mapped_section> m_mapped_sections;
+
   /* FIXME: kettenis/20031023: Eventually this field should
      disappear.  */
   struct gdbarch *m_core_gdbarch = NULL;
@@ -135,12 +202,138 @@ core_target::core_target ()
     error (_("\"%s\": Core file format not supported"),
 	   bfd_get_filename (core_bfd));
 
+  /* Do this before anything that needs undoing if it throws.  */
+  m_compressed_memory = compressed_core_memory::open (core_bfd);
+
   /* Find the data section */
   if (build_section_table (core_bfd,
 			   &m_core_section_table.sections,
 			   &m_core_section_table.sections_end))
     error (_("\"%s\": Can't find sections: %s"),
 	   bfd_get_filename (core_bfd), bfd_errmsg (bfd_get_error ()));
+
+  index_thread_sections ();
+  map_core_file ();
+}
+
+void
+core_target::map_core_file ()
+{
+#ifdef HAVE_SYS_MMAN_H
+  /* Memory written with "set write on" must be read back through
+     BFD.  */
+  if (write_files
+      || (bfd_get_file_flags (core_bfd) & BFD_IN_MEMORY) != 0)
+    return;
+
+  scoped_fd fd (gdb_open_cloexec (bfd_get_filename (core_bfd),
+				  O_RDONLY | O_BINARY | O_LARGEFILE, 0));
+  struct stat st;
+  if (fd.get () < 0
+      || fstat (fd.get (), &st) != 0
+      || st.st_size == 0
+      || (ULONGEST) st.st_size != (size_t) st.st_size)
+    return;
+
+  m_core_mapping.reset (nullptr, st.st_size, PROT_READ, MAP_PRIVATE,
+			fd.get (), 0);
+  if (m_core_mapping.get () == MAP_FAILED)
+    return;
+
+  /* Sections that extend past the end of a truncated core file are
+     left to BFD, which reports the error; touching their pages would
+     raise SIGBUS.  */
+  const gdb_byte *base = (const gdb_byte *) m_core_mapping.get ();
+  for (target_section *p = m_core_section_table.sections;
+       p < m_core_section_table.sections_end;
+       p++)
+    {
+      asection *sec = p->the_bfd_section;
+
+      if ((bfd_section_flags (sec) & SEC_HAS_CONTENTS) == 0
+	  || p->endaddr <= p->addr
+	  || sec->filepos < 0
+	  || (ULONGEST) sec->filepos > (ULONGEST) st.st_size
+	  || p->endaddr - p->addr > (ULONGEST) st.st_size - sec->filepos)
+	continue;
+
+      m_mapped_sections.push_back ({ p->addr, p->endaddr,
+				     base + sec->filepos });
+    }
+
+  std::sort (m_mapped_sections.begin (), m_mapped_sections.end (),
+	     [] (const mapped_section &a, const mapped_section &b)
+	     {
+	       return a.addr < b.addr;
+	     });
+
+  /* Leave overlapping sections to the section table, which resolves
+     them in its own order.  */
+  for (size_t i = 1; i < m_mapped_sections.size (); i++)
+    if (m_mapped_sections[i].addr < m_mapped_sections[i - 1].endaddr)
+      {
+	m_mapped_sections.clear ();
+	break;
+      }
+#endif
+}
+
+void
+core_target::index_thread_sections ()
+{
+  for (asection *sect = core_bfd->sections; sect != NULL; sect = sect->next)
+    {
+      const char *name = bfd_section_name (sect);
+      const char *slash = strrchr (name, '/');
+      if (slash == NULL || !isdigit (slash[1]))
+	continue;
+
+      char *end;
+      long lwp = strtol (slash + 1, &end, 10);
+      if (*end != '\0')
+	continue;
+
+      m_thread_sections[lwp].push_back ({ name, (size_t) (slash - name),
+					  sect });
+      if (startswith (name, ".reg/"))
+	m_thread_reg_sections.push_back (sect);
+    }
+}
+
+asection *
+core_target::find_thread_section (const char *name, ptid_t ptid)
+{
+  if (!ptid.lwp_p ())
+    return bfd_get_section_by_name (core_bfd, name);
+
+  auto iter = m_thread_sections.find (ptid.lwp ());
+  if (iter == m_thread_sections.end ())
+    return NULL;
+
+  size_t name_len = strlen (name);
+  for (const thread_section &sect : iter->second)
+    if (sect.name_len == name_len
+	&& strncmp (sect.name, name, name_len) == 0)
+      return sect.section;
+
+  return NULL;
+}
+
+const gdb_byte *
+core_target::mapped_section_contents (asection *section)
+{
+#ifdef HAVE_SYS_MMAN_H
+  if (m_core_mapping.get () != MAP_FAILED
+      && ((bfd_section_flags (section) & (SEC_HAS_CONTENTS | SEC_IN_MEMORY))
+	  == SEC_HAS_CONTENTS)
+      && section->filepos >= 0
+      && (ULONGEST) section->filepos <= m_core_mapping.size ()
+      && (bfd_section_size (section)
+	  <= m_core_mapping.size () - section->filepos))
+    return (const gdb_byte *) m_core_mapping.get () + section->filepos;
+#endif
+
+  return NULL;
 }
 
 core_target::~core_target ()
@@ -148,8 +341,6 @@ core_target::~core_target ()
   xfree (m_core_section_table.sections);
 }
 
-static void add_to_thread_list (bfd *, asection *, void *);
-
 /* An arbitrary identifier for the core inferior.  */
 #define CORELOW_PID 1
 
@@ -176,48 +367,40 @@ core_target::close ()
   delete this;
 }
 
-/* Look for sections whose names start with `.reg/' so that we can
-   extract the list of threads in a core file.  */
-
-static void
-add_to_thread_list (bfd *abfd, asection *asect, void *reg_sect_arg)
+void
+core_target::add_to_thread_list ()
 {
-  int core_tid;
-  int pid, lwpid;
-  asection *reg_sect = (asection *) reg_sect_arg;
+  asection *reg_sect = bfd_get_section_by_name (core_bfd, ".reg");
   bool fake_pid_p = false;
-  struct inferior *inf;
 
-  if (!startswith (bfd_section_name (asect), ".reg/"))
-    return;
-
-  core_tid = atoi (bfd_section_name (asect) + 5);
-
-  pid = bfd_core_file_pid (core_bfd);
+  int pid = bfd_core_file_pid (core_bfd);
   if (pid == 0)
     {
       fake_pid_p = true;
       pid = CORELOW_PID;
     }
 
-  lwpid = core_tid;
-
-  inf = current_inferior ();
-  if (inf->pid == 0)
+  for (asection *asect : m_thread_reg_sections)
     {
-      inferior_appeared (inf, pid);
-      inf->fake_pid_p = fake_pid_p;
-    }
+      int lwpid = atoi (bfd_section_name (asect) + 5);
 
-  ptid_t ptid (pid, lwpid);
+      inferior *inf = current_inferior ();
+      if (inf->pid == 0)
+	{
+	  inferior_appeared (inf, pid);
+	  inf->fake_pid_p = fake_pid_p;
+	}
+
+      ptid_t ptid (pid, lwpid);
 
-  thread_info *thr = add_thread (inf->process_target (), ptid);
+      thread_info *thr = add_thread (inf->process_target (), ptid);
 
-/* Warning, Will Robinson, looking at BFD private data! */
+      /* Warning, Will Robinson, looking at BFD private data! */
 
-  if (reg_sect != NULL
-      && asect->filepos == reg_sect->filepos)	/* Did we find .reg?  */
-    switch_to_thread (thr);			/* Yes, make it current.  */
+      if (reg_sect != NULL
+	  && asect->filepos == reg_sect->filepos)	/* Did we find .reg?  */
+	switch_to_thread (thr);			/* Yes, make it current.  */
+    }
 }
 
 /* Issue a message saying we have no core to debug, if FROM_TTY.  */
@@ -351,8 +534,7 @@ core_target_open (const char *arg, int from_tty)
   /* Build up thread list from BFD sections, and possibly set the
      current thread to the .reg/NN section matching the .reg
      section.  */
-  bfd_map_over_sections (core_bfd, add_to_thread_list,
-			 bfd_get_section_by_name (core_bfd, ".reg"));
+  target->add_to_thread_list ();
 
   if (inferior_ptid == null_ptid)
     {
@@ -491,9 +673,7 @@ core_target::get_core_register_section (struct regcache *regcache,
   bfd_size_type size;
   bool variable_size_section = (regset->flags & REGSET_VARIABLE_SIZE);
 
-  thread_section_name section_name (name, regcache->ptid ());
-
-  section = bfd_get_section_by_name (core_bfd, section_name.c_str ());
+  section = find_thread_section (name, regcache->ptid ());
   if (! section)
     {
       if (required)
@@ -502,6 +682,7 @@ core_target::get_core_register_section (struct regcache *regcache,
       return;
     }
 
+  thread_section_name section_name (name, regcache->ptid ());
   size = bfd_section_size (section);
   if (size < section_min_size)
     {
@@ -515,16 +696,23 @@ core_target::get_core_register_section (struct regcache *regcache,
 	       section_name.c_str ());
     }
 
-  gdb::byte_vector contents (size);
-  if (!bfd_get_section_contents (core_bfd, section, contents.data (),
-				 (file_ptr) 0, size))
+  const gdb_byte *contents = mapped_section_contents (section);
+  gdb::byte_vector buf;
+  if (contents == NULL)
     {
-      warning (_("Couldn't read %s registers from `%s' section in core file."),
-	       human_name, section_name.c_str ());
-      return;
+      buf.resize (size);
+      if (!bfd_get_section_contents (core_bfd, section, buf.data (),
+				     (file_ptr) 0, size))
+	{
+	  warning (_("Couldn't read %s registers from `%s' section in "
+		     "core file."),
+		   human_name, section_name.c_str ());
+	  return;
+	}
+      contents = buf.data ();
     }
 
-  regset->supply_regset (regset, regcache, -1, contents.data (), size);
+  regset->supply_regset (regset, regcache, -1, contents, size);
 }
 
 /* Data passed to gdbarch_iterate_over_regset_sections's callback.  */
@@ -611,6 +799,37 @@ core_target::xfer_partial (enum target_object object, const char *annex,
   switch (object)
     {
     case TARGET_OBJECT_MEMORY:
+      if (m_compressed_memory != nullptr)
+	{
+	  enum target_xfer_status status
+	    = m_compressed_memory->xfer_partial (readbuf, offset, &len,
+						 xfered_len);
+	  if (status != TARGET_XFER_EOF)
+	    return status;
+	}
+
+      if (readbuf != NULL && !m_mapped_sections.empty ())
+	{
+	  auto iter = std::upper_bound (m_mapped_sections.begin (),
+					m_mapped_sections.end (), offset,
+					[] (ULONGEST addr,
+					    const mapped_section &sec)
+					{
+					  return addr < sec.addr;
+					});
+
+	  if (iter != m_mapped_sections.begin ()
+	      && offset < (iter - 1)->endaddr)
+	    {
+	      const mapped_section &sec = *(iter - 1);
+	      ULONGEST n = std::min (len, sec.endaddr - offset);
+
+	      memcpy (readbuf, sec.contents + (offset - sec.addr), n);
+	      *xfered_len = n;
+	      return TARGET_XFER_OK;
+	    }
+	}
+
       return (section_table_xfer_memory_partial
 	      (readbuf, writebuf,
 	       offset, len, xfered_len,
@@ -25,6 +25,7 @@
 #include "inferior.h"
 #include "splay-tree.h"
 #include "gdbarch.h"
+#include "gdbsupport/byte-vector.h"
 
 /* Commands with a prefix of `{set,show} dcache'.  */
 static struct cmd_list_element *dcache_set_list = NULL;
@@ -458,6 +459,26 @@ dcache_init (void)
 }
 
 
+/* See dcache.h.  */
+
+bool dcache_keep_on_thread_switch = false;
+
+/* If the current thread is a different one from what we've recorded,
+   flush DCACHE.  With DCACHE_KEEP_ON_THREAD_SWITCH, only flush it if
+   the current inferior changed.  */
+
+static void
+dcache_check_inferior (DCACHE *dcache)
+{
+  if (dcache_keep_on_thread_switch
+      ? inferior_ptid.pid () != dcache->ptid.pid ()
+      : inferior_ptid != dcache->ptid)
+    {
+      dcache_invalidate (dcache);
+      dcache->ptid = inferior_ptid;
+    }
+}
+
 /* Read LEN bytes from dcache memory at MEMADDR, transferring to
    debugger address MYADDR.  If the data is presently cached, this
    fills the cache.  Arguments/return are like the target_xfer_partial
@@ -470,14 +491,7 @@ dcache_read_memory_partial (struct target_ops *ops, DCACHE *dcache,
 {
   ULONGEST i;
 
-  /* If this is a different inferior from what we've recorded,
-     flush the cache.  */
-
-  if (inferior_ptid != dcache->ptid)
-    {
-      dcache_invalidate (dcache);
-      dcache->ptid = inferior_ptid;
-    }
+  dcache_check_inferior (dcache);
 
   for (i = 0; i < len; i++)
     {
@@ -535,6 +549,63 @@ dcache_update (DCACHE *dcache, enum target_xfer_status status,
       }
 }
 
+/* See dcache.h.  */
+
+void
+dcache_prefetch (struct target_ops *ops, DCACHE *dcache,
+		 CORE_ADDR memaddr, ULONGEST len)
+{
+  CORE_ADDR addr = MASK (dcache, memaddr);
+  CORE_ADDR end = MASK (dcache, memaddr + len + dcache->line_size - 1);
+
+  dcache_check_inferior (dcache);
+
+  while (addr < end)
+    {
+      if (splay_tree_lookup (dcache->tree, (splay_tree_key) addr) != NULL)
+	{
+	  addr += dcache->line_size;
+	  continue;
+	}
+
+      /* Find the run of missing lines starting at ADDR.  */
+      CORE_ADDR run_end = addr + dcache->line_size;
+      while (run_end < end
+	     && splay_tree_lookup (dcache->tree,
+				   (splay_tree_key) run_end) == NULL)
+	run_end += dcache->line_size;
+
+      /* Don't read across memory regions; dcache_read_line deals with
+	 the lines that straddle them.  */
+      struct mem_region *region = lookup_mem_region (addr);
+      if (region->attrib.mode == MEM_WO)
+	return;
+      if (region->hi != 0 && region->hi < run_end)
+	run_end = MASK (dcache, region->hi);
+      if (run_end <= addr)
+	return;
+
+      gdb::byte_vector buf (run_end - addr);
+      LONGEST xfered = target_read (ops, TARGET_OBJECT_RAW_MEMORY, NULL,
+				    buf.data (), addr, buf.size ());
+
+      /* Only cache the lines read entirely.  */
+      for (LONGEST offset = 0;
+	   offset + dcache->line_size <= xfered;
+	   offset += dcache->line_size)
+	{
+	  struct dcache_block *db = dcache_alloc (dcache, addr + offset);
+
+	  memcpy (db->data, buf.data () + offset, dcache->line_size);
+	}
+
+      if (xfered < (LONGEST) buf.size ())
+	return;
+
+      addr = run_end;
+    }
+}
+
 /* Print DCACHE line INDEX.  */
 
 static void
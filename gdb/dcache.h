@@ -52,4 +52,19 @@ void dcache_update (DCACHE *dcache, enum target_xfer_status status,
 		    CORE_ADDR memaddr, const gdb_byte *myaddr,
 		    ULONGEST len);
 
+/* When true, switching between threads of the same inferior doesn't
+   flush the data caches, since they share memory.  Otherwise the
+   caches are flushed whenever the current thread changes.  "thread
+   apply all -prefetch" sets this while it runs, so that the stacks it
+   reads ahead are still cached when the command uses them.  */
+
+extern bool dcache_keep_on_thread_switch;
+
+/* Read the LEN bytes of memory at MEMADDR into DCACHE ahead of their
+   use.  Each run of lines not cached yet is read from OPS with a
+   single request.  Unreadable memory is silently not cached.  */
+
+void dcache_prefetch (struct target_ops *ops, DCACHE *dcache,
+		      CORE_ADDR memaddr, ULONGEST len);
+
 #endif /* DCACHE_H */
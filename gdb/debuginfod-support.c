@@ -21,6 +21,20 @@
 #include "cli/cli-style.h"
 #include "gdbsupport/scoped_fd.h"
 #include "debuginfod-support.h"
+#include "gdbcmd.h"
+#if defined (HAVE_LIBDEBUGINFOD) && CXX_STD_THREAD
+#include "gdbsupport/block-signals.h"
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <mutex>
+#include <thread>
+#endif
+
+/* The maximum number of separate debug info files that a
+   debuginfod_prefetcher downloads at a time.  Zero disables
+   prefetching.  */
+static unsigned int debuginfod_parallel_downloads = 8;
 
 #ifndef HAVE_LIBDEBUGINFOD
 scoped_fd
@@ -43,6 +57,233 @@ debuginfod_debuginfo_query (const unsigned char *build_id,
 #else
 #include <elfutils/debuginfod.h>
 
+#if CXX_STD_THREAD
+
+/* A download started by a debuginfod_prefetcher.  */
+
+struct debuginfod_download
+{
+  explicit debuginfod_download (gdb::byte_vector &&id)
+    : build_id (std::move (id))
+  {
+  }
+
+  gdb::byte_vector build_id;
+
+  /* Set by the worker thread once the server has the file, that is,
+     once it reports a size.  */
+  std::atomic<bool> started { false };
+
+  /* Set by the main thread to abort the download.  */
+  std::atomic<bool> cancel { false };
+
+  /* The following are protected by the mutex of the state.  DONE is
+     set once FD and DNAME hold the result of the download; TAKEN once
+     debuginfod_debuginfo_query took them over.  */
+  bool done = false;
+  bool taken = false;
+  int fd = -1;
+  char *dname = nullptr;
+};
+
+struct debuginfod_prefetch_state
+{
+  std::vector<std::unique_ptr<debuginfod_download>> downloads;
+
+  /* The index of the next download a worker thread starts.  */
+  size_t next = 0;
+
+  std::mutex mutex;
+  std::condition_variable cv;
+
+  std::vector<std::thread> workers;
+
+  /* Return the download of BUILD_ID, or NULL.  */
+  debuginfod_download *find (const unsigned char *build_id, int build_id_len)
+  {
+    for (auto &d : downloads)
+      if (d->build_id.size () == build_id_len
+	  && memcmp (d->build_id.data (), build_id, build_id_len) == 0)
+	return d.get ();
+    return nullptr;
+  }
+
+  void worker ();
+};
+
+/* The prefetcher that debuginfod_debuginfo_query waits for, if any.  */
+static debuginfod_prefetch_state *current_prefetch;
+
+/* The download of the calling worker thread.  */
+static thread_local debuginfod_download *worker_download;
+
+static int
+prefetch_progressfn (debuginfod_client *c, long cur, long total)
+{
+  debuginfod_download *d = worker_download;
+
+  if (d->cancel)
+    return 1;
+
+  if (total != 0)
+    d->started = true;
+
+  return 0;
+}
+
+/* The body of the worker threads: run the downloads one after the
+   other until none is left, each with the worker's own client.  */
+
+void
+debuginfod_prefetch_state::worker ()
+{
+  debuginfod_client *c = debuginfod_begin ();
+  if (c != nullptr)
+    debuginfod_set_progressfn (c, prefetch_progressfn);
+
+  while (true)
+    {
+      debuginfod_download *d;
+      {
+	std::lock_guard<std::mutex> guard (mutex);
+	if (next == downloads.size ())
+	  break;
+	d = downloads[next++].get ();
+      }
+
+      int fd;
+      char *dname = nullptr;
+      if (c == nullptr)
+	fd = -ENOMEM;
+      else if (d->cancel)
+	fd = -ECANCELED;
+      else
+	{
+	  worker_download = d;
+	  fd = debuginfod_find_debuginfo (c, d->build_id.data (),
+					  d->build_id.size (), &dname);
+	}
+
+      {
+	std::lock_guard<std::mutex> guard (mutex);
+	d->fd = fd;
+	d->dname = dname;
+	d->done = true;
+      }
+      cv.notify_all ();
+    }
+
+  if (c != nullptr)
+    debuginfod_end (c);
+}
+
+/* See debuginfod-support.h  */
+
+bool
+debuginfod_prefetcher::enabled ()
+{
+  return (current_prefetch == nullptr
+	  && getenv (DEBUGINFOD_URLS_ENV_VAR) != NULL
+	  && debuginfod_parallel_downloads > 0);
+}
+
+/* See debuginfod-support.h  */
+
+debuginfod_prefetcher::debuginfod_prefetcher
+  (std::vector<gdb::byte_vector> &&build_ids)
+{
+  if (!enabled () || build_ids.size () < 2)
+    return;
+
+  m_state.reset (new debuginfod_prefetch_state);
+  for (gdb::byte_vector &id : build_ids)
+    m_state->downloads.emplace_back (new debuginfod_download (std::move (id)));
+
+  size_t num_workers = std::min<size_t> (debuginfod_parallel_downloads,
+					 build_ids.size ());
+  {
+    gdb::block_signals blocker;
+
+    for (size_t i = 0; i < num_workers; i++)
+      m_state->workers.emplace_back (&debuginfod_prefetch_state::worker,
+				     m_state.get ());
+  }
+
+  current_prefetch = m_state.get ();
+}
+
+debuginfod_prefetcher::~debuginfod_prefetcher ()
+{
+  if (m_state == nullptr)
+    return;
+
+  current_prefetch = nullptr;
+  for (auto &d : m_state->downloads)
+    d->cancel = true;
+
+  for (std::thread &thread : m_state->workers)
+    thread.join ();
+
+  for (auto &d : m_state->downloads)
+    if (!d->taken)
+      {
+	if (d->fd >= 0)
+	  close (d->fd);
+	xfree (d->dname);
+      }
+}
+
+/* Wait for the prefetched download D of the separate debug info for
+   FILENAME, reporting its progress like progressfn does.  Store its
+   result in *FD and *DNAME.  */
+
+static void
+wait_for_prefetch (debuginfod_prefetch_state *state, debuginfod_download *d,
+		   const char *filename, int *fd, char **dname)
+{
+  bool printed = false;
+  bool cancelling = false;
+  std::unique_lock<std::mutex> lock (state->mutex);
+
+  while (true)
+    {
+      bool done = d->done;
+
+      /* Print without holding the lock, so that the worker threads
+	 are not held up by the pager.  The download may well have
+	 finished while GDB was reading other symbols; it is still
+	 reported, since it was made.  */
+      lock.unlock ();
+      if (!printed && d->started)
+	{
+	  printed = true;
+	  printf_filtered ("Downloading separate debug info for %ps...\n",
+			   styled_string (file_name_style.style (), filename));
+	}
+      if (done)
+	break;
+      if (!cancelling && check_quit_flag ())
+	{
+	  cancelling = true;
+	  printf_filtered ("Cancelling download of separate debug info "
+			   "for %ps...\n",
+			   styled_string (file_name_style.style (), filename));
+	  d->cancel = true;
+	}
+      lock.lock ();
+
+      if (!d->done)
+	state->cv.wait_for (lock, std::chrono::milliseconds (100));
+    }
+
+  lock.lock ();
+  d->taken = true;
+  *fd = d->fd;
+  *dname = d->dname;
+}
+
+#endif /* CXX_STD_THREAD */
+
 /* TODO: Use debuginfod API extensions instead of these globals.  */
 static std::string desc;
 static std::string fname;
@@ -131,25 +372,91 @@ debuginfod_debuginfo_query (const unsigned char *build_id,
   if (getenv (DEBUGINFOD_URLS_ENV_VAR) == NULL)
     return scoped_fd (-ENOSYS);
 
-  debuginfod_client *c = debuginfod_init ();
+  char *dname = nullptr;
+  int result;
 
-  if (c == nullptr)
-    return scoped_fd (-ENOMEM);
+#if CXX_STD_THREAD
+  debuginfod_download *d = nullptr;
+  if (current_prefetch != nullptr && build_id_len > 0)
+    d = current_prefetch->find (build_id, build_id_len);
 
-  desc = std::string ("separate debug info for");
-  fname = std::string (filename);
-  has_printed = false;
-  char *dname = nullptr;
+  if (d != nullptr && !d->taken)
+    wait_for_prefetch (current_prefetch, d, filename, &result, &dname);
+  else
+#endif
+    {
+      debuginfod_client *c = debuginfod_init ();
+
+      if (c == nullptr)
+	return scoped_fd (-ENOMEM);
 
-  scoped_fd fd (debuginfod_find_debuginfo (c, build_id, build_id_len, &dname));
+      desc = std::string ("separate debug info for");
+      fname = std::string (filename);
+      has_printed = false;
+
+      result = debuginfod_find_debuginfo (c, build_id, build_id_len, &dname);
+      debuginfod_end (c);
+    }
 
+  scoped_fd fd (result);
   if (fd.get () < 0 && fd.get () != -ENOENT)
     printf_filtered (_("Download failed: %s.  Continuing without debug info for %ps.\n"),
 		     safe_strerror (-fd.get ()),
 		     styled_string (file_name_style.style (),  filename));
 
   destname->reset (dname);
-  debuginfod_end (c);
   return fd;
 }
 #endif
+
+#if !defined (HAVE_LIBDEBUGINFOD) || !CXX_STD_THREAD
+/* Without debuginfod or threads, nothing is prefetched.  */
+
+struct debuginfod_prefetch_state
+{
+};
+
+/* See debuginfod-support.h  */
+
+debuginfod_prefetcher::debuginfod_prefetcher
+  (std::vector<gdb::byte_vector> &&build_ids)
+{
+}
+
+debuginfod_prefetcher::~debuginfod_prefetcher ()
+{
+}
+
+bool
+debuginfod_prefetcher::enabled ()
+{
+  return false;
+}
+#endif
+
+static void
+show_debuginfod_parallel_downloads (struct ui_file *file, int from_tty,
+				    struct cmd_list_element *c,
+				    const char *value)
+{
+  fprintf_filtered (file,
+		    _("The number of separate debug info files downloaded "
+		      "at a time from debuginfod servers is %s.\n"),
+		    value);
+}
+
+void _initialize_debuginfod_support ();
+void
+_initialize_debuginfod_support ()
+{
+  add_setshow_zuinteger_cmd ("debuginfod-parallel-downloads", class_support,
+			     &debuginfod_parallel_downloads, _("\
+Set the number of separate debug info files downloaded at a time."), _("\
+Show the number of separate debug info files downloaded at a time."), _("\
+When GDB loads several shared libraries at once, it downloads their\n\
+separate debug info files from debuginfod servers in parallel, at most\n\
+this many at a time.  Zero downloads them one by one."),
+			     NULL,
+			     show_debuginfod_parallel_downloads,
+			     &setlist, &showlist);
+}
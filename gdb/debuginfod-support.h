@@ -19,6 +19,8 @@
 #ifndef DEBUGINFOD_SUPPORT_H
 #define DEBUGINFOD_SUPPORT_H
 
+#include "gdbsupport/byte-vector.h"
+
 /* Query debuginfod servers for a source file associated with an
    executable with BUILD_ID.  BUILD_ID can be given as a binary blob or
    a null-terminated string.  If given as a binary blob, BUILD_ID_LEN
@@ -59,4 +61,40 @@ debuginfod_debuginfo_query (const unsigned char *build_id,
 			    const char *filename,
 			    gdb::unique_xmalloc_ptr<char> *destname);
 
+struct debuginfod_prefetch_state;
+
+/* Downloads the separate debug info files of several executables from
+   debuginfod servers at once, in worker threads, before GDB reads
+   their symbols.  At most "set debuginfod-parallel-downloads" files
+   are downloaded at a time.  While a prefetcher exists,
+   debuginfod_debuginfo_query waits for the download of a build-id it
+   was given, and reports its progress, instead of downloading the
+   file again.
+
+   Nothing is downloaded if GDB is not built with debuginfod, if
+   DEBUGINFOD_URLS is not set, or if another prefetcher exists.  */
+
+class debuginfod_prefetcher
+{
+public:
+
+  /* Start downloading the separate debug info of each of BUILD_IDS,
+     in the given order.  */
+  explicit debuginfod_prefetcher (std::vector<gdb::byte_vector> &&build_ids);
+
+  /* Cancel the downloads that debuginfod_debuginfo_query did not wait
+     for, and wait for the worker threads to exit.  */
+  ~debuginfod_prefetcher ();
+
+  DISABLE_COPY_AND_ASSIGN (debuginfod_prefetcher);
+
+  /* Return true if a prefetcher created now could download files, so
+     that callers can avoid looking for the build-ids to give it.  */
+  static bool enabled ();
+
+private:
+
+  std::unique_ptr<debuginfod_prefetch_state> m_state;
+};
+
 #endif /* DEBUGINFOD_SUPPORT_H */
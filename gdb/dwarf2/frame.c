@@ -107,6 +107,45 @@ struct dwarf2_cie
    discarded.  It maps from the CIE's offset to the CIE.  */
 typedef std::unordered_map<ULONGEST, dwarf2_cie *> dwarf2_cie_table;
 
+/* A row of the CFI table of an FDE: the CFA and register rules in
+   effect from address START up to the start of the next row.  */
+
+struct dwarf2_frame_row
+{
+  /* The first address covered by this row, not relocated.  */
+  CORE_ADDR start;
+
+  /* The CFA rule; see struct dwarf2_frame_state_reg_info.  */
+  enum cfa_how_kind cfa_how;
+  LONGEST cfa_offset;
+  ULONGEST cfa_reg;
+  const gdb_byte *cfa_exp;
+
+  /* The register rules, indexed by DWARF register number.  */
+  int num_regs;
+  struct dwarf2_frame_state_reg *reg;
+};
+
+/* The CFI table of an FDE, i.e. the result of executing the CIE and
+   FDE programs for every address range of the FDE.  Built lazily, the
+   first time a frame is unwound through the FDE, so that further
+   unwinds only need a binary search instead of interpreting the CFA
+   program again.  */
+
+struct dwarf2_frame_rows
+{
+  /* The architecture the programs were executed for.  */
+  struct gdbarch *gdbarch;
+
+  /* Producer quirks, see struct dwarf2_frame_state.  */
+  bool armcc_cfa_offsets_sf;
+  bool armcc_cfa_offsets_reversed;
+
+  /* The rows, sorted by START.  */
+  int num_rows;
+  struct dwarf2_frame_row *rows;
+};
+
 /* Frame Description Entry (FDE).  */
 
 struct dwarf2_fde
@@ -127,6 +166,13 @@ struct dwarf2_fde
   /* True if this FDE is read from a .eh_frame instead of a .debug_frame
      section.  */
   unsigned char eh_frame_p;
+
+  /* True if the CFI table of this FDE can't be built; its programs are
+     then interpreted for each frame.  */
+  unsigned char rows_failed;
+
+  /* The CFI table of this FDE, or NULL if not built yet.  */
+  struct dwarf2_frame_rows *rows;
 };
 
 typedef std::vector<dwarf2_fde *> dwarf2_fde_table;
@@ -162,6 +208,27 @@ struct comp_unit
   /* The FDE table.  */
   dwarf2_fde_table fde_table;
 
+  /* The binary search table of the .eh_frame_hdr section, used instead
+     of FDE_TABLE to find the FDEs of .eh_frame when not NULL.  Each
+     entry is a pair of DW_EH_PE_datarel | DW_EH_PE_sdata4 values: the
+     initial location of an FDE, and the address of the FDE.  */
+  const gdb_byte *eh_frame_hdr_table = nullptr;
+
+  /* Number of entries in EH_FRAME_HDR_TABLE.  */
+  size_t eh_frame_hdr_count = 0;
+
+  /* Address of the .eh_frame_hdr section, the base of the values in
+     EH_FRAME_HDR_TABLE.  */
+  CORE_ADDR eh_frame_hdr_addr = 0;
+
+  /* The CIEs decoded so far through EH_FRAME_HDR_TABLE.  */
+  dwarf2_cie_table eh_frame_hdr_cies;
+
+  /* The FDEs decoded so far through EH_FRAME_HDR_TABLE, indexed by
+     their entry in the table.  NULL if the entry has no usable
+     FDE.  */
+  std::unordered_map<size_t, dwarf2_fde *> eh_frame_hdr_fdes;
+
   /* Hold data used by this module.  */
   auto_obstack obstack;
 };
@@ -181,6 +248,11 @@ static CORE_ADDR read_encoded_value (struct comp_unit *unit, gdb_byte encoding,
 /* See dwarf2-frame.h.  */
 bool dwarf2_frame_unwinders_enabled_p = true;
 
+/* When true, look up the FDEs of .eh_frame sections through their
+   .eh_frame_hdr binary search table, decoding them on demand, instead
+   of reading all of them at once.  */
+static bool dwarf2_frame_use_eh_frame_hdr = true;
+
 /* Store the length the expression for the CFA in the `cfa_reg' field,
    which is unused in that case.  */
 #define cfa_exp_len cfa_reg
@@ -390,12 +462,18 @@ execute_cfa_program (struct dwarf2_fde *fde, const gdb_byte *insn_ptr,
 	  switch (insn)
 	    {
 	    case DW_CFA_set_loc:
-	      fs->pc = read_encoded_value (fde->cie->unit, fde->cie->encoding,
-					   fde->cie->ptr_size, insn_ptr,
-					   &bytes_read, fde->initial_location);
-	      /* Apply the text offset for relocatable objects.  */
-	      fs->pc += text_offset;
-	      insn_ptr += bytes_read;
+	      {
+		CORE_ADDR loc
+		  = read_encoded_value (fde->cie->unit, fde->cie->encoding,
+					fde->cie->ptr_size, insn_ptr,
+					&bytes_read, fde->initial_location);
+		/* Apply the text offset for relocatable objects.  */
+		loc += text_offset;
+		if (loc < fs->pc)
+		  fs->pc_moved_backwards = true;
+		fs->pc = loc;
+		insn_ptr += bytes_read;
+	      }
 	      break;
 
 	    case DW_CFA_advance_loc1:
@@ -940,6 +1018,287 @@ dwarf2_fetch_cfa_info (struct gdbarch *gdbarch, CORE_ADDR pc,
 }
 
 
+/* Append the rules of FS, in effect from address START, to ROWS.
+   Consecutive rows with the same rules are merged.  */
+
+static void
+dwarf2_frame_add_row (std::vector<dwarf2_frame_row> &rows,
+		      std::vector<std::vector<dwarf2_frame_state_reg>> &regs,
+		      CORE_ADDR start, const struct dwarf2_frame_state &fs)
+{
+  if (!rows.empty ())
+    {
+      const dwarf2_frame_row &last = rows.back ();
+      const std::vector<dwarf2_frame_state_reg> &last_regs = regs.back ();
+
+      if (last.cfa_how == fs.regs.cfa_how
+	  && last.cfa_offset == fs.regs.cfa_offset
+	  && last.cfa_reg == fs.regs.cfa_reg
+	  && last.cfa_exp == fs.regs.cfa_exp
+	  && last_regs.size () == fs.regs.reg.size ()
+	  && (last_regs.empty ()
+	      || memcmp (last_regs.data (), fs.regs.reg.data (),
+			 last_regs.size () * sizeof (last_regs[0])) == 0))
+	return;
+    }
+
+  dwarf2_frame_row row;
+  row.start = start;
+  row.cfa_how = fs.regs.cfa_how;
+  row.cfa_offset = fs.regs.cfa_offset;
+  row.cfa_reg = fs.regs.cfa_reg;
+  row.cfa_exp = fs.regs.cfa_exp;
+  row.num_regs = fs.regs.reg.size ();
+  row.reg = NULL;
+  rows.push_back (row);
+  regs.push_back (fs.regs.reg);
+}
+
+/* Execute the CIE and FDE programs of FDE for all the addresses the
+   FDE covers, and return the resulting CFI table, allocated on
+   OBSTACK.  PC is the relocated initial location of FDE, used to find
+   producer quirks.  Return NULL if the programs can't be described by
+   a table.  */
+
+static struct dwarf2_frame_rows *
+dwarf2_frame_build_rows (struct gdbarch *gdbarch, struct dwarf2_fde *fde,
+			 CORE_ADDR pc, struct obstack *obstack)
+{
+  struct dwarf2_frame_state fs (pc, fde->cie);
+
+  dwarf2_frame_find_quirks (&fs, fde);
+
+  /* The table is built for unrelocated addresses; so start from the
+     unrelocated initial location, and use a zero text offset.  */
+  fs.pc = fde->initial_location;
+  const gdb_byte *insn = execute_cfa_program (fde,
+					      fde->cie->initial_instructions,
+					      fde->cie->end, gdbarch,
+					      fs.pc, &fs, 0);
+
+  /* A CIE program is not supposed to advance the location.  Also,
+     execute_cfa_program discards remembered states at the end of each
+     call when the CIE left no register rules, so remember/restore
+     pairs that span several rows wouldn't work.  */
+  if (insn != fde->cie->end || fs.pc != fde->initial_location
+      || fs.regs.reg.empty ())
+    return NULL;
+
+  fs.initial = fs.regs;
+
+  std::vector<dwarf2_frame_row> rows;
+  std::vector<std::vector<dwarf2_frame_state_reg>> regs;
+
+  insn = fde->instructions;
+  while (true)
+    {
+      CORE_ADDR start = fs.pc;
+
+      /* Run the program until the location advances past START; the
+	 rules in FS are then the ones in effect at START.  */
+      insn = execute_cfa_program (fde, insn, fde->end, gdbarch, start, &fs, 0);
+      dwarf2_frame_add_row (rows, regs, start, fs);
+
+      /* Rows can only describe a program whose location moves
+	 forward; leave the others to execute_cfa_program.  */
+      if (fs.pc_moved_backwards
+	  || (insn < fde->end && fs.pc <= start))
+	return NULL;
+
+      if (insn >= fde->end)
+	break;
+    }
+
+  struct dwarf2_frame_rows *result = XOBNEW (obstack, struct dwarf2_frame_rows);
+  result->gdbarch = gdbarch;
+  result->armcc_cfa_offsets_sf = fs.armcc_cfa_offsets_sf;
+  result->armcc_cfa_offsets_reversed = fs.armcc_cfa_offsets_reversed;
+  result->num_rows = rows.size ();
+  result->rows = XOBNEWVEC (obstack, struct dwarf2_frame_row, rows.size ());
+  for (int i = 0; i < rows.size (); i++)
+    {
+      result->rows[i] = rows[i];
+      result->rows[i].reg
+	= XOBNEWVEC (obstack, struct dwarf2_frame_state_reg, regs[i].size ());
+      std::copy (regs[i].begin (), regs[i].end (), result->rows[i].reg);
+    }
+
+  return result;
+}
+
+/* Return the CFI table of FDE for GDBARCH, building it if needed.  PC
+   is the relocated initial location of FDE.  Return NULL if FDE has no
+   usable table.  */
+
+static const struct dwarf2_frame_rows *
+dwarf2_frame_fde_rows (struct gdbarch *gdbarch, struct dwarf2_fde *fde,
+		       CORE_ADDR pc)
+{
+  if (fde->rows == NULL && !fde->rows_failed)
+    {
+      try
+	{
+	  fde->rows = dwarf2_frame_build_rows (gdbarch, fde, pc,
+					       &fde->cie->unit->obstack);
+	}
+      catch (const gdb_exception_error &ex)
+	{
+	  fde->rows = NULL;
+	}
+
+      if (fde->rows == NULL)
+	fde->rows_failed = 1;
+    }
+
+  if (fde->rows == NULL || fde->rows->gdbarch != gdbarch)
+    return NULL;
+  return fde->rows;
+}
+
+/* Return the row of ROWS in effect at the unrelocated address PC.  */
+
+static const struct dwarf2_frame_row *
+dwarf2_frame_find_row (const struct dwarf2_frame_rows *rows, CORE_ADDR pc)
+{
+  const dwarf2_frame_row *begin = rows->rows;
+  const dwarf2_frame_row *end = rows->rows + rows->num_rows;
+  const dwarf2_frame_row *it
+    = std::upper_bound (begin, end, pc,
+			[] (CORE_ADDR addr, const dwarf2_frame_row &row)
+			{
+			  return addr < row.start;
+			});
+
+  /* The first row starts at the initial location of the FDE, which is
+     never above PC.  */
+  if (it != begin)
+    --it;
+  return it;
+}
+
+/* Set the register rules of FS to those of ROW.  */
+
+static void
+dwarf2_frame_apply_row (struct dwarf2_frame_state *fs,
+			const struct dwarf2_frame_row *row)
+{
+  fs->regs.reg.assign (row->reg, row->reg + row->num_regs);
+  fs->regs.cfa_how = row->cfa_how;
+  fs->regs.cfa_offset = row->cfa_offset;
+  fs->regs.cfa_reg = row->cfa_reg;
+  fs->regs.cfa_exp = row->cfa_exp;
+}
+
+#if GDB_SELF_TEST
+
+namespace selftests {
+
+/* Unit test for the CFI tables built by dwarf2_frame_build_rows: the
+   row found for each address of the FDE must hold the same rules as
+   the interpretation of the programs up to that address.  */
+
+static void
+dwarf2_frame_rows_test (struct gdbarch *gdbarch)
+{
+  struct dwarf2_fde fde;
+  struct dwarf2_cie cie;
+
+  memset (&fde, 0, sizeof fde);
+  memset (&cie, 0, sizeof cie);
+
+  gdb_byte cie_insns[] =
+    {
+      DW_CFA_def_cfa, 7, 8,	/* DW_CFA_def_cfa: r7 ofs 8 */
+      DW_CFA_offset | 16, 1,	/* DW_CFA_offset: r16 at cfa-8 */
+    };
+
+  gdb_byte fde_insns[] =
+    {
+      DW_CFA_advance_loc | 1,
+      DW_CFA_def_cfa_offset, 16,
+      DW_CFA_offset | 6, 2,	/* DW_CFA_offset: r6 at cfa-16 */
+      DW_CFA_advance_loc | 3,
+      DW_CFA_def_cfa_register, 6,
+      DW_CFA_advance_loc | 4,	/* No change of rules.  */
+      DW_CFA_nop,
+      DW_CFA_advance_loc | 2,
+      DW_CFA_remember_state,
+      DW_CFA_def_cfa, 7, 8,
+      DW_CFA_advance_loc | 1,
+      DW_CFA_restore_state,
+      DW_CFA_advance_loc2, 4, 0,
+      DW_CFA_restore | 6,
+    };
+
+  cie.data_alignment_factor = -8;
+  cie.code_alignment_factor = 1;
+  cie.return_address_register = 16;
+  cie.initial_instructions = cie_insns;
+  cie.end = cie_insns + sizeof (cie_insns);
+  fde.cie = &cie;
+  fde.initial_location = 0x1000;
+  fde.address_range = 0x20;
+  fde.instructions = fde_insns;
+  fde.end = fde_insns + sizeof (fde_insns);
+
+  auto_obstack obstack;
+  struct dwarf2_frame_rows *rows
+    = dwarf2_frame_build_rows (gdbarch, &fde, fde.initial_location,
+			       &obstack);
+
+  SELF_CHECK (rows != NULL);
+  /* The advance that doesn't change any rule is merged.  */
+  SELF_CHECK (rows->num_rows == 6);
+
+  for (CORE_ADDR pc = fde.initial_location;
+       pc < fde.initial_location + fde.address_range;
+       pc++)
+    {
+      dwarf2_frame_state fs (fde.initial_location, fde.cie);
+
+      execute_cfa_program (&fde, cie.initial_instructions, cie.end, gdbarch,
+			   pc, &fs, 0);
+      fs.initial = fs.regs;
+      execute_cfa_program (&fde, fde.instructions, fde.end, gdbarch,
+			   pc, &fs, 0);
+
+      const struct dwarf2_frame_row *row = dwarf2_frame_find_row (rows, pc);
+
+      SELF_CHECK (row->start <= pc);
+      SELF_CHECK (row->cfa_how == fs.regs.cfa_how);
+      SELF_CHECK (row->cfa_reg == fs.regs.cfa_reg);
+      SELF_CHECK (row->cfa_offset == fs.regs.cfa_offset);
+      SELF_CHECK (row->num_regs == fs.regs.reg.size ());
+      for (int i = 0; i < row->num_regs; i++)
+	{
+	  SELF_CHECK (row->reg[i].how == fs.regs.reg[i].how);
+	  if (row->reg[i].how == DWARF2_FRAME_REG_SAVED_OFFSET)
+	    SELF_CHECK (row->reg[i].loc.offset == fs.regs.reg[i].loc.offset);
+	}
+    }
+
+  /* A DW_CFA_set_loc that moves the location backwards can't be
+     described by rows; such an FDE is left to execute_cfa_program.  */
+  gdb_byte backwards_insns[] =
+    {
+      DW_CFA_advance_loc | 8,
+      DW_CFA_def_cfa_offset, 16,
+      DW_CFA_set_loc, 0x84, 0x20,	/* DW_CFA_set_loc: 0x1004 */
+      DW_CFA_def_cfa_offset, 24,
+    };
+
+  cie.encoding = DW_EH_PE_uleb128;
+  fde.instructions = backwards_insns;
+  fde.end = backwards_insns + sizeof (backwards_insns);
+
+  rows = dwarf2_frame_build_rows (gdbarch, &fde, fde.initial_location,
+				  &obstack);
+  SELF_CHECK (rows == NULL);
+}
+
+} // namespace selftests
+#endif /* GDB_SELF_TEST */
+
 struct dwarf2_frame_cache
 {
   /* DWARF Call Frame Address.  */
@@ -1018,48 +1377,86 @@ dwarf2_frame_cache (struct frame_info *this_frame, void **this_cache)
 
   cache->addr_size = fde->cie->addr_size;
 
-  /* Check for "quirks" - known bugs in producers.  */
-  dwarf2_frame_find_quirks (&fs, fde);
-
-  /* First decode all the insns in the CIE.  */
-  execute_cfa_program (fde, fde->cie->initial_instructions,
-		       fde->cie->end, gdbarch,
-		       get_frame_address_in_block (this_frame), &fs,
-		       cache->per_objfile->objfile->text_section_offset ());
-
-  /* Save the initialized register set.  */
-  fs.initial = fs.regs;
-
-  /* Fetching the entry pc for THIS_FRAME won't necessarily result
-     in an address that's within the range of FDE locations.  This
-     is due to the possibility of the function occupying non-contiguous
-     ranges.  */
   LONGEST entry_cfa_sp_offset;
   int entry_cfa_sp_offset_p = 0;
-  if (get_frame_func_if_available (this_frame, &entry_pc)
-      && fde->initial_location <= entry_pc
-      && entry_pc < fde->initial_location + fde->address_range)
+  CORE_ADDR text_offset = cache->per_objfile->objfile->text_section_offset ();
+  const struct dwarf2_frame_rows *rows
+    = dwarf2_frame_fde_rows (gdbarch, fde, pc1);
+
+  if (rows != NULL)
     {
-      /* Decode the insns in the FDE up to the entry PC.  */
-      instr = execute_cfa_program
-	(fde, fde->instructions, fde->end, gdbarch, entry_pc, &fs,
-	 cache->per_objfile->objfile->text_section_offset ());
-
-      if (fs.regs.cfa_how == CFA_REG_OFFSET
-	  && (dwarf_reg_to_regnum (gdbarch, fs.regs.cfa_reg)
-	      == gdbarch_sp_regnum (gdbarch)))
+      /* Use the precomputed CFI table.  This is equivalent to the
+	 interpretation of the programs below: the rules in effect at
+	 the PC of this frame, or at the entry PC if it is within the
+	 FDE and beyond the PC of this frame.  */
+      CORE_ADDR pc = get_frame_address_in_block (this_frame) - text_offset;
+
+      fs.armcc_cfa_offsets_sf = rows->armcc_cfa_offsets_sf;
+      fs.armcc_cfa_offsets_reversed = rows->armcc_cfa_offsets_reversed;
+
+      if (get_frame_func_if_available (this_frame, &entry_pc)
+	  && fde->initial_location <= entry_pc
+	  && entry_pc < fde->initial_location + fde->address_range)
 	{
-	  entry_cfa_sp_offset = fs.regs.cfa_offset;
-	  entry_cfa_sp_offset_p = 1;
+	  const struct dwarf2_frame_row *entry_row
+	    = dwarf2_frame_find_row (rows, entry_pc - text_offset);
+
+	  if (entry_row->cfa_how == CFA_REG_OFFSET
+	      && (dwarf_reg_to_regnum (gdbarch, entry_row->cfa_reg)
+		  == gdbarch_sp_regnum (gdbarch)))
+	    {
+	      entry_cfa_sp_offset = entry_row->cfa_offset;
+	      entry_cfa_sp_offset_p = 1;
+	    }
+
+	  pc = std::max (pc, entry_pc - text_offset);
 	}
+
+      dwarf2_frame_apply_row (&fs, dwarf2_frame_find_row (rows, pc));
     }
   else
-    instr = fde->instructions;
+    {
+      /* Check for "quirks" - known bugs in producers.  */
+      dwarf2_frame_find_quirks (&fs, fde);
+
+      /* First decode all the insns in the CIE.  */
+      execute_cfa_program (fde, fde->cie->initial_instructions,
+			   fde->cie->end, gdbarch,
+			   get_frame_address_in_block (this_frame), &fs,
+			   text_offset);
+
+      /* Save the initialized register set.  */
+      fs.initial = fs.regs;
+
+      /* Fetching the entry pc for THIS_FRAME won't necessarily result
+	 in an address that's within the range of FDE locations.  This
+	 is due to the possibility of the function occupying non-contiguous
+	 ranges.  */
+      if (get_frame_func_if_available (this_frame, &entry_pc)
+	  && fde->initial_location <= entry_pc
+	  && entry_pc < fde->initial_location + fde->address_range)
+	{
+	  /* Decode the insns in the FDE up to the entry PC.  */
+	  instr = execute_cfa_program
+	    (fde, fde->instructions, fde->end, gdbarch, entry_pc, &fs,
+	     text_offset);
+
+	  if (fs.regs.cfa_how == CFA_REG_OFFSET
+	      && (dwarf_reg_to_regnum (gdbarch, fs.regs.cfa_reg)
+		  == gdbarch_sp_regnum (gdbarch)))
+	    {
+	      entry_cfa_sp_offset = fs.regs.cfa_offset;
+	      entry_cfa_sp_offset_p = 1;
+	    }
+	}
+      else
+	instr = fde->instructions;
 
-  /* Then decode the insns in the FDE up to our target PC.  */
-  execute_cfa_program (fde, instr, fde->end, gdbarch,
-		       get_frame_address_in_block (this_frame), &fs,
-		       cache->per_objfile->objfile->text_section_offset ());
+      /* Then decode the insns in the FDE up to our target PC.  */
+      execute_cfa_program (fde, instr, fde->end, gdbarch,
+			   get_frame_address_in_block (this_frame), &fs,
+			   text_offset);
+    }
 
   try
     {
@@ -1656,6 +2053,10 @@ set_comp_unit (struct objfile *objfile, struct comp_unit *unit)
   return dwarf2_frame_objfile_data.set (objfile, unit);
 }
 
+static struct dwarf2_fde *eh_frame_hdr_find_fde (struct gdbarch *gdbarch,
+						 struct comp_unit *unit,
+						 CORE_ADDR seek_pc);
+
 /* Find the FDE for *PC.  Return a pointer to the FDE, and store the
    initial location associated with it into *PC.  */
 
@@ -1675,14 +2076,30 @@ dwarf2_frame_find_fde (CORE_ADDR *pc, dwarf2_per_objfile **out_per_objfile)
 	}
       gdb_assert (unit != NULL);
 
+      gdb_assert (!objfile->section_offsets.empty ());
+      offset = objfile->text_section_offset ();
+
+      if (unit->eh_frame_hdr_table != NULL)
+	{
+	  if (*pc < offset)
+	    continue;
+
+	  struct dwarf2_fde *fde
+	    = eh_frame_hdr_find_fde (objfile->arch (), unit, *pc - offset);
+	  if (fde == NULL)
+	    continue;
+
+	  *pc = fde->initial_location + offset;
+	  if (out_per_objfile != nullptr)
+	    *out_per_objfile = get_dwarf2_per_objfile (objfile);
+
+	  return fde;
+	}
+
       dwarf2_fde_table *fde_table = &unit->fde_table;
       if (fde_table->empty ())
 	continue;
 
-      gdb_assert (!objfile->section_offsets.empty ());
-      offset = objfile->text_section_offset ();
-
-      gdb_assert (!fde_table->empty ());
       if (*pc < offset + (*fde_table)[0]->initial_location)
         continue;
 
@@ -1984,6 +2401,8 @@ decode_frame_entry_1 (struct gdbarch *gdbarch,
 	return NULL;
 
       fde = XOBNEW (&unit->obstack, struct dwarf2_fde);
+      fde->rows_failed = 0;
+      fde->rows = NULL;
       fde->cie = find_cie (cie_table, cie_pointer);
       if (fde->cie == NULL)
 	{
@@ -2133,6 +2552,105 @@ Corrupt data in %s:%s; align 8 workaround apparently succeeded"),
   return ret;
 }
 
+/* Return the initial location of the FDE of entry INDEX of the
+   .eh_frame_hdr table of UNIT.  */
+
+static CORE_ADDR
+eh_frame_hdr_entry_location (struct gdbarch *gdbarch, struct comp_unit *unit,
+			     size_t index)
+{
+  const gdb_byte *entry = unit->eh_frame_hdr_table + index * 8;
+  CORE_ADDR addr = (unit->eh_frame_hdr_addr
+		    + bfd_get_signed_32 (unit->abfd, entry));
+
+  return gdbarch_adjust_dwarf2_addr (gdbarch, addr);
+}
+
+/* Decode the FDE of entry INDEX of the .eh_frame_hdr table of UNIT.
+   Return NULL if it is invalid or covers no address.  */
+
+static struct dwarf2_fde *
+eh_frame_hdr_decode_fde (struct gdbarch *gdbarch, struct comp_unit *unit,
+			 size_t index)
+{
+  const gdb_byte *entry = unit->eh_frame_hdr_table + index * 8;
+  CORE_ADDR fde_addr = (unit->eh_frame_hdr_addr
+			+ bfd_get_signed_32 (unit->abfd, entry + 4));
+  CORE_ADDR fde_offset
+    = fde_addr - bfd_section_vma (unit->dwarf_frame_section);
+
+  if (fde_offset >= unit->dwarf_frame_size)
+    {
+      complaint (_("Invalid FDE address %s in .eh_frame_hdr of %s"),
+		 paddress (gdbarch, fde_addr),
+		 bfd_get_filename (unit->abfd));
+      return NULL;
+    }
+
+  dwarf2_fde_table fde_table;
+  try
+    {
+      decode_frame_entry (gdbarch, unit,
+			  unit->dwarf_frame_buffer + fde_offset, 1,
+			  unit->eh_frame_hdr_cies, &fde_table,
+			  EH_FDE_TYPE_ID);
+    }
+  catch (const gdb_exception_error &e)
+    {
+      complaint (_("skipping .eh_frame FDE at %s of %s: %s"),
+		 paddress (gdbarch, fde_addr),
+		 bfd_get_filename (unit->abfd), e.what ());
+      return NULL;
+    }
+
+  if (fde_table.empty ())
+    return NULL;
+  return fde_table[0];
+}
+
+/* Find the FDE covering the unrelocated address SEEK_PC through the
+   .eh_frame_hdr table of UNIT, decoding it if needed.  Return NULL if
+   there is none.  */
+
+static struct dwarf2_fde *
+eh_frame_hdr_find_fde (struct gdbarch *gdbarch, struct comp_unit *unit,
+		       CORE_ADDR seek_pc)
+{
+  /* Find the last entry whose initial location is not above
+     SEEK_PC.  */
+  size_t low = 0;
+  size_t high = unit->eh_frame_hdr_count;
+  while (low < high)
+    {
+      size_t mid = low + (high - low) / 2;
+
+      if (eh_frame_hdr_entry_location (gdbarch, unit, mid) <= seek_pc)
+	low = mid + 1;
+      else
+	high = mid;
+    }
+
+  if (low == 0)
+    return NULL;
+
+  size_t index = low - 1;
+  struct dwarf2_fde *fde;
+  auto it = unit->eh_frame_hdr_fdes.find (index);
+  if (it != unit->eh_frame_hdr_fdes.end ())
+    fde = it->second;
+  else
+    {
+      fde = eh_frame_hdr_decode_fde (gdbarch, unit, index);
+      unit->eh_frame_hdr_fdes[index] = fde;
+    }
+
+  if (fde == NULL
+      || seek_pc < fde->initial_location
+      || seek_pc >= fde->initial_location + fde->address_range)
+    return NULL;
+  return fde;
+}
+
 static bool
 fde_is_less_than (const dwarf2_fde *aa, const dwarf2_fde *bb)
 {
@@ -2151,6 +2669,103 @@ fde_is_less_than (const dwarf2_fde *aa, const dwarf2_fde *bb)
   return aa->initial_location < bb->initial_location;
 }
 
+/* Set the bases of the DW_EH_PE_datarel and DW_EH_PE_textrel encodings
+   used in the .eh_frame section of UNIT.  */
+
+static void
+set_eh_frame_bases (struct comp_unit *unit)
+{
+  asection *got, *txt;
+
+  /* FIXME: kettenis/20030602: This is the DW_EH_PE_datarel base
+     that is used for the i386/amd64 target, which currently is
+     the only target in GCC that supports/uses the
+     DW_EH_PE_datarel encoding.  */
+  got = bfd_get_section_by_name (unit->abfd, ".got");
+  if (got)
+    unit->dbase = got->vma;
+
+  /* GCC emits the DW_EH_PE_textrel encoding type on sh and ia64
+     so far.  */
+  txt = bfd_get_section_by_name (unit->abfd, ".text");
+  if (txt)
+    unit->tbase = txt->vma;
+}
+
+/* Try to set up UNIT to look up the FDEs of the .eh_frame section of
+   OBJFILE through its .eh_frame_hdr binary search table.  Return false
+   if the table is missing or can't be used, in which case the whole
+   section must be read.  */
+
+static bool
+read_eh_frame_hdr (struct objfile *objfile, struct comp_unit *unit)
+{
+  if (!dwarf2_frame_use_eh_frame_hdr
+      || objfile->separate_debug_objfile_backlink != NULL
+      || gdb_bfd_requires_relocations (unit->abfd))
+    return false;
+
+  asection *hdr = bfd_get_section_by_name (unit->abfd, ".eh_frame_hdr");
+  if (hdr == NULL || (bfd_section_flags (hdr) & SEC_HAS_CONTENTS) == 0)
+    return false;
+
+  /* The FDEs of a .debug_frame section would have to be merged with
+     those found through the table; just read everything then.  */
+  asection *debug_frame_section;
+  const gdb_byte *debug_frame_buffer;
+  bfd_size_type debug_frame_size;
+  dwarf2_get_section_info (objfile, DWARF2_DEBUG_FRAME,
+			   &debug_frame_section, &debug_frame_buffer,
+			   &debug_frame_size);
+  if (debug_frame_size != 0)
+    return false;
+
+  dwarf2_get_section_info (objfile, DWARF2_EH_FRAME,
+			   &unit->dwarf_frame_section,
+			   &unit->dwarf_frame_buffer,
+			   &unit->dwarf_frame_size);
+  if (unit->dwarf_frame_size == 0)
+    return false;
+
+  bfd_size_type hdr_size;
+  const gdb_byte *hdr_buffer;
+  try
+    {
+      hdr_buffer = gdb_bfd_map_section (hdr, &hdr_size);
+    }
+  catch (const gdb_exception_error &e)
+    {
+      return false;
+    }
+
+  /* Only the encodings produced by the GNU linkers are supported: the
+     header is version 1, followed by the pc-relative address of
+     .eh_frame, the number of entries, and the table of sorted
+     DW_EH_PE_datarel | DW_EH_PE_sdata4 pairs.  */
+  if (hdr_size < 12
+      || hdr_buffer[0] != 1
+      || hdr_buffer[1] != (DW_EH_PE_pcrel | DW_EH_PE_sdata4)
+      || hdr_buffer[2] != DW_EH_PE_udata4
+      || hdr_buffer[3] != (DW_EH_PE_datarel | DW_EH_PE_sdata4))
+    return false;
+
+  CORE_ADDR hdr_addr = bfd_section_vma (hdr);
+  CORE_ADDR eh_frame_addr
+    = hdr_addr + 4 + bfd_get_signed_32 (unit->abfd, hdr_buffer + 4);
+  if (eh_frame_addr != bfd_section_vma (unit->dwarf_frame_section))
+    return false;
+
+  ULONGEST count = bfd_get_32 (unit->abfd, hdr_buffer + 8);
+  if (count == 0 || count > (hdr_size - 12) / 8)
+    return false;
+
+  set_eh_frame_bases (unit);
+  unit->eh_frame_hdr_table = hdr_buffer + 12;
+  unit->eh_frame_hdr_count = count;
+  unit->eh_frame_hdr_addr = hdr_addr;
+  return true;
+}
+
 void
 dwarf2_build_frame_info (struct objfile *objfile)
 {
@@ -2163,6 +2778,13 @@ dwarf2_build_frame_info (struct objfile *objfile)
   /* Build a minimal decoding of the DWARF2 compilation unit.  */
   std::unique_ptr<comp_unit> unit (new comp_unit (objfile));
 
+  /* If possible, decode the FDEs lazily when they are looked up.  */
+  if (read_eh_frame_hdr (objfile, unit.get ()))
+    {
+      set_comp_unit (objfile, unit.release ());
+      return;
+    }
+
   if (objfile->separate_debug_objfile_backlink == NULL)
     {
       /* Do not read .eh_frame from separate file as they must be also
@@ -2173,21 +2795,7 @@ dwarf2_build_frame_info (struct objfile *objfile)
                                &unit->dwarf_frame_size);
       if (unit->dwarf_frame_size)
         {
-          asection *got, *txt;
-
-          /* FIXME: kettenis/20030602: This is the DW_EH_PE_datarel base
-             that is used for the i386/amd64 target, which currently is
-             the only target in GCC that supports/uses the
-             DW_EH_PE_datarel encoding.  */
-          got = bfd_get_section_by_name (unit->abfd, ".got");
-          if (got)
-            unit->dbase = got->vma;
-
-          /* GCC emits the DW_EH_PE_textrel encoding type on sh and ia64
-             so far.  */
-          txt = bfd_get_section_by_name (unit->abfd, ".text");
-          if (txt)
-            unit->tbase = txt->vma;
+	  set_eh_frame_bases (unit.get ());
 
 	  try
 	    {
@@ -2299,6 +2907,18 @@ show_dwarf_unwinders_enabled_p (struct ui_file *file, int from_tty,
 		    value);
 }
 
+/* Handle 'maintenance show dwarf eh-frame-hdr'.  */
+
+static void
+show_dwarf_eh_frame_hdr (struct ui_file *file, int from_tty,
+			 struct cmd_list_element *c, const char *value)
+{
+  fprintf_filtered (file,
+		    _("Use of .eh_frame_hdr tables to find frame "
+		      "descriptions is %s.\n"),
+		    value);
+}
+
 void _initialize_dwarf2_frame ();
 void
 _initialize_dwarf2_frame ()
@@ -2317,8 +2937,23 @@ architecture that doesn't support them will have no effect."),
 			   &set_dwarf_cmdlist,
 			   &show_dwarf_cmdlist);
 
+  add_setshow_boolean_cmd ("eh-frame-hdr", class_obscure,
+			   &dwarf2_frame_use_eh_frame_hdr, _("\
+Set whether .eh_frame_hdr tables are used to find frame descriptions."), _("\
+Show whether .eh_frame_hdr tables are used to find frame descriptions."), _("\
+When enabled, the frame descriptions of the .eh_frame section of an object\n\
+file are looked up in its .eh_frame_hdr binary search table and decoded\n\
+when first needed, instead of all being read at once.  This only affects\n\
+object files whose frame information has not been read yet."),
+			   NULL,
+			   show_dwarf_eh_frame_hdr,
+			   &set_dwarf_cmdlist,
+			   &show_dwarf_cmdlist);
+
 #if GDB_SELF_TEST
   selftests::register_test_foreach_arch ("execute_cfa_program",
 					 selftests::execute_cfa_program_test);
+  selftests::register_test_foreach_arch ("dwarf2_frame_rows",
+					 selftests::dwarf2_frame_rows_test);
 #endif
 }
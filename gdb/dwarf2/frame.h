@@ -185,6 +185,9 @@ struct dwarf2_frame_state
   const ULONGEST code_align;
   const ULONGEST retaddr_column;
 
+  /* True if a DW_CFA_set_loc moved the location backwards.  */
+  bool pc_moved_backwards = false;
+
   /* Flags for known producer quirks.  */
 
   /* The ARM compilers, in DWARF2 mode, assume that DW_CFA_def_cfa
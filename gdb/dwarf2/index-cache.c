@@ -30,9 +30,16 @@
 #include "dwarf2/dwz.h"
 #include "objfiles.h"
 #include "gdbsupport/selftest.h"
+#include "gdbsupport/filestuff.h"
+#include "gdbsupport/gdb_unlinker.h"
+#include "gdbsupport/scoped_fd.h"
 #include <string>
 #include <stdlib.h>
 
+/* The suffix of the files holding decompressed .gnu_debugdata
+   sections.  */
+#define DEBUGDATA_SUFFIX ".gnu_debugdata"
+
 /* When set to true, show debug messages about the index cache.  */
 static bool debug_index_cache = false;
 
@@ -161,6 +168,92 @@ index_cache::store (dwarf2_per_objfile *per_objfile)
     }
 }
 
+/* See dwarf-index-cache.h.  */
+
+void
+index_cache::store_debugdata (const bfd_build_id *build_id,
+			      gdb::array_view<const gdb_byte> contents)
+{
+  if (!enabled ())
+    return;
+
+  if (m_dir.empty ())
+    {
+      warning (_("The index cache directory name is empty, skipping store."));
+      return;
+    }
+
+  std::string filename = make_index_filename (build_id, DEBUGDATA_SUFFIX);
+
+  try
+    {
+      if (!mkdir_recursive (m_dir.c_str ()))
+	{
+	  warning (_("index cache: could not make cache directory: %s"),
+		   safe_strerror (errno));
+	  return;
+	}
+
+      if (debug_index_cache)
+	printf_unfiltered ("index cache: writing %s\n", filename.c_str ());
+
+      /* Write to a temporary file and rename it, so that other GDBs
+	 never see a partial file.  */
+      gdb::char_vector filename_temp = make_temp_filename (filename);
+      scoped_fd fd (gdb_mkostemp_cloexec (filename_temp.data (), O_BINARY));
+      if (fd.get () == -1)
+	perror_with_name (("mkstemp"));
+
+      gdb::unlinker unlink_file (filename_temp.data ());
+
+      const gdb_byte *p = contents.data ();
+      size_t left = contents.size ();
+      while (left > 0)
+	{
+	  ssize_t n = write (fd.get (), p, left);
+	  if (n < 0)
+	    perror_with_name (("write"));
+	  p += n;
+	  left -= n;
+	}
+
+      if (close (fd.release ()) != 0)
+	perror_with_name (("close"));
+
+      unlink_file.keep ();
+      if (rename (filename_temp.data (), filename.c_str ()) != 0)
+	{
+	  unlink (filename_temp.data ());
+	  perror_with_name (("rename"));
+	}
+    }
+  catch (const gdb_exception_error &except)
+    {
+      if (debug_index_cache)
+	printf_unfiltered ("index cache: couldn't store %s: %s\n",
+			   filename.c_str (), except.what ());
+    }
+}
+
+/* See dwarf-index-cache.h.  */
+
+std::string
+index_cache::lookup_debugdata (const bfd_build_id *build_id)
+{
+  if (!enabled () || m_dir.empty ())
+    return {};
+
+  std::string filename = make_index_filename (build_id, DEBUGDATA_SUFFIX);
+
+  if (debug_index_cache)
+    printf_unfiltered ("index cache: trying to read %s\n", filename.c_str ());
+
+  if (access (filename.c_str (), R_OK) != 0)
+    return {};
+
+  return filename;
+}
+
 #if HAVE_SYS_MMAN_H
 
 /* Hold the resources for an mmapped index file.  */
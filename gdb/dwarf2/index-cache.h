@@ -65,6 +65,16 @@ class index_cache
   lookup_gdb_index (const bfd_build_id *build_id,
 		    std::unique_ptr<index_cache_resource> *resource);
 
+  /* Store CONTENTS, the decompressed .gnu_debugdata section of the
+     object file with build id BUILD_ID, in the cache.  */
+  void store_debugdata (const bfd_build_id *build_id,
+			gdb::array_view<const gdb_byte> contents);
+
+  /* Return the name of the file holding the decompressed
+     .gnu_debugdata section of the object file with build id BUILD_ID,
+     or an empty string if the cache does not have it.  */
+  std::string lookup_debugdata (const bfd_build_id *build_id);
+
   /* Return the number of cache hits.  */
   unsigned int n_hits () const
   { return m_n_hits; }
@@ -7997,6 +7997,34 @@ set_partial_user (dwarf2_per_objfile *per_objfile)
     }
 }
 
+/* Decompress at once the compressed sections of PER_BFD that building
+   its partial symbols reads, so that they are decompressed in
+   parallel rather than one after the other.  */
+
+static void
+decompress_psymtab_sections (dwarf2_per_bfd *per_bfd)
+{
+  std::vector<dwarf2_section_info *> infos
+    = { &per_bfd->info, &per_bfd->abbrev, &per_bfd->line, &per_bfd->str,
+	&per_bfd->str_offsets, &per_bfd->line_str, &per_bfd->ranges,
+	&per_bfd->rnglists, &per_bfd->addr };
+  for (dwarf2_section_info &section : per_bfd->types)
+    infos.push_back (&section);
+
+  std::vector<asection *> sections;
+  for (dwarf2_section_info *info : infos)
+    {
+      if (info->readin || info->is_virtual || info->empty ())
+	continue;
+
+      asection *sectp = info->get_bfd_section ();
+      if ((sectp->flags & SEC_RELOC) == 0)
+	sections.push_back (sectp);
+    }
+
+  gdb_bfd_decompress_sections (sections);
+}
+
 /* Build the partial symbol table by doing a quick pass through the
    .debug_info and .debug_abbrev sections.  */
 
@@ -8015,6 +8043,7 @@ dwarf2_build_psymtabs_hard (dwarf2_per_objfile *per_objfile)
     = make_scoped_restore (&per_objfile->per_bfd->reading_partial_symbols,
 			   true);
 
+  decompress_psymtab_sections (per_objfile->per_bfd);
   per_objfile->per_bfd->info.read (objfile);
 
   /* Any cached compilation units will be linked by the per-objfile
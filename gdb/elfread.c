@@ -50,6 +50,7 @@
 #include "ctfread.h"
 #include "gdbsupport/gdb_string_view.h"
 #include "gdbsupport/scoped_fd.h"
+#include "gdbsupport/parallel-for.h"
 #include "debuginfod-support.h"
 
 /* Forward declarations.  */
@@ -195,12 +196,15 @@ elf_locate_sections (bfd *ignore_abfd, asection *sectp, void *eip)
     }
 }
 
-static struct minimal_symbol *
-record_minimal_symbol (minimal_symbol_reader &reader,
-		       gdb::string_view name, bool copy_name,
-		       CORE_ADDR address,
-		       enum minimal_symbol_type ms_type,
-		       asection *bfd_section, struct objfile *objfile)
+/* Return the address to record for a minimal symbol of type MS_TYPE at
+   ADDRESS in BFD_SECTION of OBJFILE, and set *SECTION_INDEX to the index
+   of the section to record it in.  This does not modify anything, so
+   it can be called from worker threads.  */
+
+static CORE_ADDR
+elf_msymbol_location (struct objfile *objfile, CORE_ADDR address,
+		      enum minimal_symbol_type ms_type,
+		      asection *bfd_section, int *section_index)
 {
   struct gdbarch *gdbarch = objfile->arch ();
 
@@ -212,10 +216,22 @@ record_minimal_symbol (minimal_symbol_reader &reader,
      we'd only expect to find msymbols for allocatable sections, but if the
      ELF is malformed then this might not be the case.  In that case don't
      create an msymbol that references an uninitialised section object.  */
-  int section_index = 0;
+  *section_index = 0;
   if ((bfd_section_flags (bfd_section) & SEC_ALLOC) == SEC_ALLOC)
-    section_index = gdb_bfd_section_index (objfile->obfd, bfd_section);
+    *section_index = gdb_bfd_section_index (objfile->obfd, bfd_section);
+
+  return address;
+}
+
+/* Record a minimal symbol whose location was computed by
+   elf_msymbol_location.  */
 
+static struct minimal_symbol *
+elf_record_msymbol (minimal_symbol_reader &reader,
+		    gdb::string_view name, bool copy_name,
+		    CORE_ADDR address, enum minimal_symbol_type ms_type,
+		    int section_index, struct objfile *objfile)
+{
   struct minimal_symbol *result
     = reader.record_full (name, copy_name, address, ms_type, section_index);
   if ((objfile->flags & OBJF_MAINLINE) == 0
@@ -225,6 +241,21 @@ record_minimal_symbol (minimal_symbol_reader &reader,
   return result;
 }
 
+static struct minimal_symbol *
+record_minimal_symbol (minimal_symbol_reader &reader,
+		       gdb::string_view name, bool copy_name,
+		       CORE_ADDR address,
+		       enum minimal_symbol_type ms_type,
+		       asection *bfd_section, struct objfile *objfile)
+{
+  int section_index;
+
+  address = elf_msymbol_location (objfile, address, ms_type, bfd_section,
+				  &section_index);
+  return elf_record_msymbol (reader, name, copy_name, address, ms_type,
+			     section_index, objfile);
+}
+
 /* Read the symbol table of an ELF file.
 
    Given an objfile, a symbol table, and a flag indicating whether the
@@ -241,299 +272,422 @@ record_minimal_symbol (minimal_symbol_reader &reader,
 #define ST_DYNAMIC 1
 #define ST_SYNTHETIC 2
 
+/* What elf_symtab_read does with an ELF symbol.  */
+
+enum elf_symbol_action
+{
+  /* Ignore the symbol.  */
+  ELF_SYMBOL_SKIP,
+
+  /* Pass the symbol to gdbarch_record_special_symbol.  */
+  ELF_SYMBOL_SPECIAL,
+
+  /* The symbol names the file of the symbols that follow it.  */
+  ELF_SYMBOL_FILE,
+
+  /* Record a minimal symbol for the symbol.  */
+  ELF_SYMBOL_RECORD
+};
+
+/* How elf_symtab_read records an ELF symbol.  This is worked out by
+   elf_classify_symbol, in worker threads, and then acted upon in
+   symbol table order.  */
+
+struct elf_symbol_info
+{
+  enum elf_symbol_action action;
+
+  /* The rest is only meaningful for ELF_SYMBOL_RECORD.  */
+
+  enum minimal_symbol_type ms_type;
+
+  /* Whether the size of the ELF symbol is the size of the minimal
+     symbol.  */
+  bool set_size;
+
+  /* The address of the ELF symbol, and the address and section index
+     to record the minimal symbol with.  */
+  CORE_ADDR symaddr;
+  CORE_ADDR address;
+  int section_index;
+
+  /* If the symbol is a default versioned symbol, the length of its
+     version-less name, under which it is also recorded; zero
+     otherwise.  */
+  size_t versionless_len;
+
+  /* If the symbol is an @plt symbol, the length of the name of the
+     destination symbol, for which a trampoline is also recorded; zero
+     otherwise.  */
+  size_t trampoline_len;
+};
+
+/* Work out what elf_symtab_read does with SYM, from a symbol table of
+   type TYPE of OBJFILE, and store it in *INFO.  STRIPPED is true if
+   OBJFILE has no regular symbols, and PLT is its ".plt" section, if
+   any.  This does not modify anything, so it can be called from worker
+   threads.  */
+
 static void
-elf_symtab_read (minimal_symbol_reader &reader,
-		 struct objfile *objfile, int type,
-		 long number_of_symbols, asymbol **symbol_table,
-		 bool copy_names)
+elf_classify_symbol (struct objfile *objfile, int type, bool stripped,
+		     asection *plt, asymbol *sym,
+		     struct elf_symbol_info *info)
 {
   struct gdbarch *gdbarch = objfile->arch ();
-  asymbol *sym;
-  long i;
-  CORE_ADDR symaddr;
   enum minimal_symbol_type ms_type;
-  /* Name of the last file symbol.  This is either a constant string or is
-     saved on the objfile's filename cache.  */
-  const char *filesymname = "";
-  int stripped = (bfd_get_symcount (objfile->obfd) == 0);
-  int elf_make_msymbol_special_p
-    = gdbarch_elf_make_msymbol_special_p (gdbarch);
+  CORE_ADDR symaddr;
+
+  info->action = ELF_SYMBOL_SKIP;
 
-  for (i = 0; i < number_of_symbols; i++)
+  if (sym->name == NULL || *sym->name == '\0')
     {
-      sym = symbol_table[i];
-      if (sym->name == NULL || *sym->name == '\0')
-	{
-	  /* Skip names that don't exist (shouldn't happen), or names
-	     that are null strings (may happen).  */
-	  continue;
-	}
+      /* Skip names that don't exist (shouldn't happen), or names
+	 that are null strings (may happen).  */
+      return;
+    }
 
-      /* Skip "special" symbols, e.g. ARM mapping symbols.  These are
-	 symbols which do not correspond to objects in the symbol table,
-	 but have some other target-specific meaning.  */
-      if (bfd_is_target_special_symbol (objfile->obfd, sym))
-	{
-	  if (gdbarch_record_special_symbol_p (gdbarch))
-	    gdbarch_record_special_symbol (gdbarch, objfile, sym);
-	  continue;
-	}
+  /* Skip "special" symbols, e.g. ARM mapping symbols.  These are
+     symbols which do not correspond to objects in the symbol table,
+     but have some other target-specific meaning.  */
+  if (bfd_is_target_special_symbol (objfile->obfd, sym))
+    {
+      if (gdbarch_record_special_symbol_p (gdbarch))
+	info->action = ELF_SYMBOL_SPECIAL;
+      return;
+    }
+
+  if (type == ST_DYNAMIC
+      && sym->section == bfd_und_section_ptr
+      && (sym->flags & BSF_FUNCTION))
+    {
+      bfd *abfd = objfile->obfd;
+      asection *sect;
+
+      /* Symbol is a reference to a function defined in
+	 a shared library.
+	 If its value is non zero then it is usually the address
+	 of the corresponding entry in the procedure linkage table,
+	 plus the desired section offset.
+	 If its value is zero then the dynamic linker has to resolve
+	 the symbol.  We are unable to find any meaningful address
+	 for this symbol in the executable file, so we skip it.  */
+      symaddr = sym->value;
+      if (symaddr == 0)
+	return;
 
-      if (type == ST_DYNAMIC
-	  && sym->section == bfd_und_section_ptr
-	  && (sym->flags & BSF_FUNCTION))
+      /* sym->section is the undefined section.  However, we want to
+	 record the section where the PLT stub resides with the
+	 minimal symbol.  Search the section table for the one that
+	 covers the stub's address.  */
+      for (sect = abfd->sections; sect != NULL; sect = sect->next)
 	{
-	  struct minimal_symbol *msym;
-	  bfd *abfd = objfile->obfd;
-	  asection *sect;
-
-	  /* Symbol is a reference to a function defined in
-	     a shared library.
-	     If its value is non zero then it is usually the address
-	     of the corresponding entry in the procedure linkage table,
-	     plus the desired section offset.
-	     If its value is zero then the dynamic linker has to resolve
-	     the symbol.  We are unable to find any meaningful address
-	     for this symbol in the executable file, so we skip it.  */
-	  symaddr = sym->value;
-	  if (symaddr == 0)
+	  if ((bfd_section_flags (sect) & SEC_ALLOC) == 0)
 	    continue;
 
-	  /* sym->section is the undefined section.  However, we want to
-	     record the section where the PLT stub resides with the
-	     minimal symbol.  Search the section table for the one that
-	     covers the stub's address.  */
-	  for (sect = abfd->sections; sect != NULL; sect = sect->next)
-	    {
-	      if ((bfd_section_flags (sect) & SEC_ALLOC) == 0)
-		continue;
-
-	      if (symaddr >= bfd_section_vma (sect)
-		  && symaddr < bfd_section_vma (sect)
-			       + bfd_section_size (sect))
-		break;
-	    }
-	  if (!sect)
-	    continue;
+	  if (symaddr >= bfd_section_vma (sect)
+	      && symaddr < bfd_section_vma (sect)
+			   + bfd_section_size (sect))
+	    break;
+	}
+      if (!sect)
+	return;
 
-	  /* On ia64-hpux, we have discovered that the system linker
-	     adds undefined symbols with nonzero addresses that cannot
-	     be right (their address points inside the code of another
-	     function in the .text section).  This creates problems
-	     when trying to determine which symbol corresponds to
-	     a given address.
-
-	     We try to detect those buggy symbols by checking which
-	     section we think they correspond to.  Normally, PLT symbols
-	     are stored inside their own section, and the typical name
-	     for that section is ".plt".  So, if there is a ".plt"
-	     section, and yet the section name of our symbol does not
-	     start with ".plt", we ignore that symbol.  */
-	  if (!startswith (sect->name, ".plt")
-	      && bfd_get_section_by_name (abfd, ".plt") != NULL)
-	    continue;
+      /* On ia64-hpux, we have discovered that the system linker
+	 adds undefined symbols with nonzero addresses that cannot
+	 be right (their address points inside the code of another
+	 function in the .text section).  This creates problems
+	 when trying to determine which symbol corresponds to
+	 a given address.
+
+	 We try to detect those buggy symbols by checking which
+	 section we think they correspond to.  Normally, PLT symbols
+	 are stored inside their own section, and the typical name
+	 for that section is ".plt".  So, if there is a ".plt"
+	 section, and yet the section name of our symbol does not
+	 start with ".plt", we ignore that symbol.  */
+      if (!startswith (sect->name, ".plt") && plt != NULL)
+	return;
 
-	  msym = record_minimal_symbol
-	    (reader, sym->name, copy_names,
-	     symaddr, mst_solib_trampoline, sect, objfile);
-	  if (msym != NULL)
-	    {
-	      msym->filename = filesymname;
-	      if (elf_make_msymbol_special_p)
-		gdbarch_elf_make_msymbol_special (gdbarch, sym, msym);
-	    }
-	  continue;
-	}
+      info->action = ELF_SYMBOL_RECORD;
+      info->ms_type = mst_solib_trampoline;
+      info->set_size = false;
+      info->symaddr = symaddr;
+      info->address = elf_msymbol_location (objfile, symaddr,
+					    mst_solib_trampoline, sect,
+					    &info->section_index);
+      info->versionless_len = 0;
+      info->trampoline_len = 0;
+      return;
+    }
 
-      /* If it is a nonstripped executable, do not enter dynamic
-	 symbols, as the dynamic symbol table is usually a subset
-	 of the main symbol table.  */
-      if (type == ST_DYNAMIC && !stripped)
-	continue;
-      if (sym->flags & BSF_FILE)
-	filesymname = objfile->intern (sym->name);
-      else if (sym->flags & BSF_SECTION_SYM)
-	continue;
-      else if (sym->flags & (BSF_GLOBAL | BSF_LOCAL | BSF_WEAK
-			     | BSF_GNU_UNIQUE))
-	{
-	  struct minimal_symbol *msym;
+  /* If it is a nonstripped executable, do not enter dynamic
+     symbols, as the dynamic symbol table is usually a subset
+     of the main symbol table.  */
+  if (type == ST_DYNAMIC && !stripped)
+    return;
+  if (sym->flags & BSF_FILE)
+    {
+      info->action = ELF_SYMBOL_FILE;
+      return;
+    }
+  else if (sym->flags & BSF_SECTION_SYM)
+    return;
+  else if ((sym->flags & (BSF_GLOBAL | BSF_LOCAL | BSF_WEAK
+			  | BSF_GNU_UNIQUE)) == 0)
+    return;
 
-	  /* Select global/local/weak symbols.  Note that bfd puts abs
-	     symbols in their own section, so all symbols we are
-	     interested in will have a section.  */
-	  /* Bfd symbols are section relative.  */
-	  symaddr = sym->value + sym->section->vma;
-	  /* For non-absolute symbols, use the type of the section
-	     they are relative to, to intuit text/data.  Bfd provides
-	     no way of figuring this out for absolute symbols.  */
-	  if (sym->section == bfd_abs_section_ptr)
-	    {
-	      /* This is a hack to get the minimal symbol type
-		 right for Irix 5, which has absolute addresses
-		 with special section indices for dynamic symbols.
+  /* Select global/local/weak symbols.  Note that bfd puts abs
+     symbols in their own section, so all symbols we are
+     interested in will have a section.  */
+  /* Bfd symbols are section relative.  */
+  symaddr = sym->value + sym->section->vma;
+  /* For non-absolute symbols, use the type of the section
+     they are relative to, to intuit text/data.  Bfd provides
+     no way of figuring this out for absolute symbols.  */
+  if (sym->section == bfd_abs_section_ptr)
+    {
+      /* This is a hack to get the minimal symbol type
+	 right for Irix 5, which has absolute addresses
+	 with special section indices for dynamic symbols.
 
-		 NOTE: uweigand-20071112: Synthetic symbols do not
-		 have an ELF-private part, so do not touch those.  */
-	      unsigned int shndx = type == ST_SYNTHETIC ? 0 :
-		((elf_symbol_type *) sym)->internal_elf_sym.st_shndx;
+	 NOTE: uweigand-20071112: Synthetic symbols do not
+	 have an ELF-private part, so do not touch those.  */
+      unsigned int shndx = type == ST_SYNTHETIC ? 0 :
+	((elf_symbol_type *) sym)->internal_elf_sym.st_shndx;
 
-	      switch (shndx)
-		{
-		case SHN_MIPS_TEXT:
-		  ms_type = mst_text;
-		  break;
-		case SHN_MIPS_DATA:
-		  ms_type = mst_data;
-		  break;
-		case SHN_MIPS_ACOMMON:
-		  ms_type = mst_bss;
-		  break;
-		default:
-		  ms_type = mst_abs;
-		}
+      switch (shndx)
+	{
+	case SHN_MIPS_TEXT:
+	  ms_type = mst_text;
+	  break;
+	case SHN_MIPS_DATA:
+	  ms_type = mst_data;
+	  break;
+	case SHN_MIPS_ACOMMON:
+	  ms_type = mst_bss;
+	  break;
+	default:
+	  ms_type = mst_abs;
+	}
 
-	      /* If it is an Irix dynamic symbol, skip section name
-		 symbols, relocate all others by section offset.  */
-	      if (ms_type != mst_abs)
-		{
-		  if (sym->name[0] == '.')
-		    continue;
-		}
+      /* If it is an Irix dynamic symbol, skip section name
+	 symbols, relocate all others by section offset.  */
+      if (ms_type != mst_abs)
+	{
+	  if (sym->name[0] == '.')
+	    return;
+	}
+    }
+  else if (sym->section->flags & SEC_CODE)
+    {
+      if (sym->flags & (BSF_GLOBAL | BSF_WEAK | BSF_GNU_UNIQUE))
+	{
+	  if (sym->flags & BSF_GNU_INDIRECT_FUNCTION)
+	    ms_type = mst_text_gnu_ifunc;
+	  else
+	    ms_type = mst_text;
+	}
+      /* The BSF_SYNTHETIC check is there to omit ppc64 function
+	 descriptors mistaken for static functions starting with 'L'.
+	 */
+      else if ((sym->name[0] == '.' && sym->name[1] == 'L'
+		&& (sym->flags & BSF_SYNTHETIC) == 0)
+	       || ((sym->flags & BSF_LOCAL)
+		   && sym->name[0] == '$'
+		   && sym->name[1] == 'L'))
+	/* Looks like a compiler-generated label.  Skip
+	   it.  The assembler should be skipping these (to
+	   keep executables small), but apparently with
+	   gcc on the (deleted) delta m88k SVR4, it loses.
+	   So to have us check too should be harmless (but
+	   I encourage people to fix this in the assembler
+	   instead of adding checks here).  */
+	return;
+      else
+	{
+	  ms_type = mst_file_text;
+	}
+    }
+  else if (sym->section->flags & SEC_ALLOC)
+    {
+      if (sym->flags & (BSF_GLOBAL | BSF_WEAK | BSF_GNU_UNIQUE))
+	{
+	  if (sym->flags & BSF_GNU_INDIRECT_FUNCTION)
+	    {
+	      ms_type = mst_data_gnu_ifunc;
 	    }
-	  else if (sym->section->flags & SEC_CODE)
+	  else if (sym->section->flags & SEC_LOAD)
 	    {
-	      if (sym->flags & (BSF_GLOBAL | BSF_WEAK | BSF_GNU_UNIQUE))
-		{
-		  if (sym->flags & BSF_GNU_INDIRECT_FUNCTION)
-		    ms_type = mst_text_gnu_ifunc;
-		  else
-		    ms_type = mst_text;
-		}
-	      /* The BSF_SYNTHETIC check is there to omit ppc64 function
-		 descriptors mistaken for static functions starting with 'L'.
-		 */
-	      else if ((sym->name[0] == '.' && sym->name[1] == 'L'
-			&& (sym->flags & BSF_SYNTHETIC) == 0)
-		       || ((sym->flags & BSF_LOCAL)
-			   && sym->name[0] == '$'
-			   && sym->name[1] == 'L'))
-		/* Looks like a compiler-generated label.  Skip
-		   it.  The assembler should be skipping these (to
-		   keep executables small), but apparently with
-		   gcc on the (deleted) delta m88k SVR4, it loses.
-		   So to have us check too should be harmless (but
-		   I encourage people to fix this in the assembler
-		   instead of adding checks here).  */
-		continue;
-	      else
-		{
-		  ms_type = mst_file_text;
-		}
+	      ms_type = mst_data;
 	    }
-	  else if (sym->section->flags & SEC_ALLOC)
+	  else
 	    {
-	      if (sym->flags & (BSF_GLOBAL | BSF_WEAK | BSF_GNU_UNIQUE))
-		{
-		  if (sym->flags & BSF_GNU_INDIRECT_FUNCTION)
-		    {
-		      ms_type = mst_data_gnu_ifunc;
-		    }
-		  else if (sym->section->flags & SEC_LOAD)
-		    {
-		      ms_type = mst_data;
-		    }
-		  else
-		    {
-		      ms_type = mst_bss;
-		    }
-		}
-	      else if (sym->flags & BSF_LOCAL)
-		{
-		  if (sym->section->flags & SEC_LOAD)
-		    {
-		      ms_type = mst_file_data;
-		    }
-		  else
-		    {
-		      ms_type = mst_file_bss;
-		    }
-		}
-	      else
-		{
-		  ms_type = mst_unknown;
-		}
+	      ms_type = mst_bss;
+	    }
+	}
+      else if (sym->flags & BSF_LOCAL)
+	{
+	  if (sym->section->flags & SEC_LOAD)
+	    {
+	      ms_type = mst_file_data;
 	    }
 	  else
 	    {
-	      /* FIXME:  Solaris2 shared libraries include lots of
-		 odd "absolute" and "undefined" symbols, that play
-		 hob with actions like finding what function the PC
-		 is in.  Ignore them if they aren't text, data, or bss.  */
-	      /* ms_type = mst_unknown; */
-	      continue;	/* Skip this symbol.  */
+	      ms_type = mst_file_bss;
 	    }
-	  msym = record_minimal_symbol
-	    (reader, sym->name, copy_names, symaddr,
-	     ms_type, sym->section, objfile);
+	}
+      else
+	{
+	  ms_type = mst_unknown;
+	}
+    }
+  else
+    {
+      /* FIXME:  Solaris2 shared libraries include lots of
+	 odd "absolute" and "undefined" symbols, that play
+	 hob with actions like finding what function the PC
+	 is in.  Ignore them if they aren't text, data, or bss.  */
+      /* ms_type = mst_unknown; */
+      return;	/* Skip this symbol.  */
+    }
+
+  info->action = ELF_SYMBOL_RECORD;
+  info->ms_type = ms_type;
+  /* NOTE: uweigand-20071112: A synthetic symbol does not have an
+     ELF-private part.  */
+  info->set_size = type != ST_SYNTHETIC;
+  info->symaddr = symaddr;
+  info->address = elf_msymbol_location (objfile, symaddr, ms_type,
+					sym->section, &info->section_index);
+
+  /* If we see a default versioned symbol, install it under
+     its version-less name.  */
+  const char *atsign = strchr (sym->name, '@');
+
+  info->versionless_len = 0;
+  if (atsign != NULL && atsign[1] == '@' && atsign > sym->name)
+    info->versionless_len = atsign - sym->name;
+
+  /* For @plt symbols, also record a trampoline to the
+     destination symbol.  The @plt symbol will be used in
+     disassembly, and the trampoline will be used when we are
+     trying to find the target.  */
+  info->trampoline_len = 0;
+  if (ms_type == mst_text && type == ST_SYNTHETIC)
+    {
+      size_t len = strlen (sym->name);
+
+      if (len > 4 && strcmp (sym->name + len - 4, "@plt") == 0)
+	info->trampoline_len = len - 4;
+    }
+}
+
+/* The number of ELF symbols elf_symtab_read classifies at once.  This
+   bounds the memory used for the results.  */
+
+#define ELF_SYMBOL_BLOCK_SIZE 65536
+
+static void
+elf_symtab_read (minimal_symbol_reader &reader,
+		 struct objfile *objfile, int type,
+		 long number_of_symbols, asymbol **symbol_table,
+		 bool copy_names)
+{
+  struct gdbarch *gdbarch = objfile->arch ();
+  /* Name of the last file symbol.  This is either a constant string or is
+     saved on the objfile's filename cache.  */
+  const char *filesymname = "";
+  bool stripped = (bfd_get_symcount (objfile->obfd) == 0);
+  asection *plt = bfd_get_section_by_name (objfile->obfd, ".plt");
+  int elf_make_msymbol_special_p
+    = gdbarch_elf_make_msymbol_special_p (gdbarch);
+
+  if (number_of_symbols <= 0)
+    return;
+
+  /* Classifying the symbols is done in worker threads, but recording
+     them allocates from the objfile and depends on the file symbols
+     that precede them, so it is done here, in symbol table order.  */
+  std::vector<elf_symbol_info> infos (std::min (number_of_symbols,
+						(long) ELF_SYMBOL_BLOCK_SIZE));
 
-	  if (msym)
+  for (long start = 0; start < number_of_symbols; start += infos.size ())
+    {
+      long count = std::min (number_of_symbols - start, (long) infos.size ());
+      elf_symbol_info *first = infos.data ();
+
+      gdb::parallel_for_each
+	(first, first + count,
+	 [&] (elf_symbol_info *begin, elf_symbol_info *end)
+	 {
+	   for (elf_symbol_info *info = begin; info < end; ++info)
+	     elf_classify_symbol (objfile, type, stripped, plt,
+				  symbol_table[start + (info - first)], info);
+	 });
+
+      for (long i = 0; i < count; i++)
+	{
+	  const elf_symbol_info &info = infos[i];
+	  asymbol *sym = symbol_table[start + i];
+	  struct minimal_symbol *msym;
+
+	  switch (info.action)
 	    {
-	      /* NOTE: uweigand-20071112: A synthetic symbol does not have an
-		 ELF-private part.  */
-	      if (type != ST_SYNTHETIC)
-		{
-		  /* Pass symbol size field in via BFD.  FIXME!!!  */
-		  elf_symbol_type *elf_sym = (elf_symbol_type *) sym;
-		  SET_MSYMBOL_SIZE (msym, elf_sym->internal_elf_sym.st_size);
-		}
+	    case ELF_SYMBOL_SKIP:
+	      continue;
 
-	      msym->filename = filesymname;
-	      if (elf_make_msymbol_special_p)
-		gdbarch_elf_make_msymbol_special (gdbarch, sym, msym);
+	    case ELF_SYMBOL_SPECIAL:
+	      gdbarch_record_special_symbol (gdbarch, objfile, sym);
+	      continue;
+
+	    case ELF_SYMBOL_FILE:
+	      filesymname = objfile->intern (sym->name);
+	      continue;
+
+	    case ELF_SYMBOL_RECORD:
+	      break;
 	    }
 
-	  /* If we see a default versioned symbol, install it under
-	     its version-less name.  */
-	  if (msym != NULL)
+	  msym = elf_record_msymbol (reader, sym->name, copy_names,
+				     info.address, info.ms_type,
+				     info.section_index, objfile);
+	  if (msym == NULL)
+	    continue;
+
+	  if (info.set_size)
 	    {
-	      const char *atsign = strchr (sym->name, '@');
+	      /* Pass symbol size field in via BFD.  FIXME!!!  */
+	      elf_symbol_type *elf_sym = (elf_symbol_type *) sym;
+	      SET_MSYMBOL_SIZE (msym, elf_sym->internal_elf_sym.st_size);
+	    }
 
-	      if (atsign != NULL && atsign[1] == '@' && atsign > sym->name)
-		{
-		  int len = atsign - sym->name;
+	  msym->filename = filesymname;
+	  if (elf_make_msymbol_special_p)
+	    gdbarch_elf_make_msymbol_special (gdbarch, sym, msym);
 
-		  record_minimal_symbol (reader,
-					 gdb::string_view (sym->name, len),
-					 true, symaddr, ms_type, sym->section,
-					 objfile);
-		}
-	    }
+	  if (info.versionless_len != 0)
+	    elf_record_msymbol (reader,
+				gdb::string_view (sym->name,
+						  info.versionless_len),
+				true, info.address, info.ms_type,
+				info.section_index, objfile);
 
-	  /* For @plt symbols, also record a trampoline to the
-	     destination symbol.  The @plt symbol will be used in
-	     disassembly, and the trampoline will be used when we are
-	     trying to find the target.  */
-	  if (msym && ms_type == mst_text && type == ST_SYNTHETIC)
+	  if (info.trampoline_len != 0)
 	    {
-	      int len = strlen (sym->name);
+	      struct minimal_symbol *mtramp;
 
-	      if (len > 4 && strcmp (sym->name + len - 4, "@plt") == 0)
+	      mtramp = record_minimal_symbol
+		(reader, gdb::string_view (sym->name, info.trampoline_len),
+		 true, info.symaddr, mst_solib_trampoline, sym->section,
+		 objfile);
+	      if (mtramp)
 		{
-		  struct minimal_symbol *mtramp;
-
-		  mtramp = record_minimal_symbol
-		    (reader, gdb::string_view (sym->name, len - 4), true,
-		     symaddr, mst_solib_trampoline, sym->section, objfile);
-		  if (mtramp)
-		    {
-		      SET_MSYMBOL_SIZE (mtramp, MSYMBOL_SIZE (msym));
-		      mtramp->created_by_gdb = 1;
-		      mtramp->filename = filesymname;
-		      if (elf_make_msymbol_special_p)
-			gdbarch_elf_make_msymbol_special (gdbarch,
-							  sym, mtramp);
-		    }
+		  SET_MSYMBOL_SIZE (mtramp, MSYMBOL_SIZE (msym));
+		  mtramp->created_by_gdb = 1;
+		  mtramp->filename = filesymname;
+		  if (elf_make_msymbol_special_p)
+		    gdbarch_elf_make_msymbol_special (gdbarch,
+						      sym, mtramp);
 		}
 	    }
 	}
@@ -43,6 +43,7 @@
 #include "hashtab.h"
 #include "valprint.h"
 #include "cli/cli-option.h"
+#include "gdbsupport/byte-vector.h"
 
 /* The sentinel frame terminates the innermost end of the frame chain.
    If unwound, it returns the information needed to construct an
@@ -161,6 +162,21 @@ struct frame_info
   /* A frame specific string describing the STOP_REASON in more detail.
      Only valid when PREV_P is set, but even then may still be NULL.  */
   const char *stop_string;
+
+  /* A cheap summary of the state this frame was unwound from: its
+     stack pointer, a hash of its general purpose registers, and a
+     hash of the stack memory between its stack pointer and its frame
+     ID's stack address.  Only computed when the persistent frame
+     cache is enabled; used to decide whether this frame, and the
+     frames outer to it, can be reused after the inferior stops
+     again.  */
+  struct
+  {
+    int p;
+    CORE_ADDR sp;
+    hashval_t regs;
+    hashval_t stack;
+  } fingerprint;
 };
 
 /* See frame.h.  */
@@ -1582,6 +1598,382 @@ create_sentinel_frame (struct program_space *pspace, struct regcache *regcache)
   return frame;
 }
 
+/* Release the unwinder caches of frame FI.  The memory of FI itself
+   lives on a frame cache obstack and is released with it.  */
+
+static void
+frame_dealloc_caches (struct frame_info *fi)
+{
+  if (fi->prologue_cache && fi->unwind->dealloc_cache)
+    fi->unwind->dealloc_cache (fi, fi->prologue_cache);
+  if (fi->base_cache && fi->base->unwind->dealloc_cache)
+    fi->base->unwind->dealloc_cache (fi, fi->base_cache);
+}
+
+/* Release the unwinder caches of FROM and of all the frames outer to
+   it, stopping before UNTIL (which may be NULL).  */
+
+static void
+frame_dealloc_chain (struct frame_info *from, struct frame_info *until)
+{
+  for (struct frame_info *fi = from; fi != until; fi = fi->prev)
+    frame_dealloc_caches (fi);
+}
+
+/* Persistent frame cache.
+
+   When the inferior resumes, or another thread is selected, the
+   frames of the thread that was current can optionally be kept
+   around instead of being thrown away.  The next time a frame chain
+   is built for that thread, get_prev_frame_if_no_cycle compares each
+   newly unwound frame against the retained chain; when a frame with
+   the same ID, stack pointer, registers and stack contents is found,
+   the retained frame and the frames outer to it are spliced into the
+   new chain, so that only the frames that actually changed need to
+   be unwound again.  Each retained frame outer to the splice point
+   is only kept if the stack memory it was unwound from still has the
+   same contents.  */
+
+/* Whether the persistent frame cache is enabled.  */
+
+static bool persistent_frame_cache = false;
+
+/* Implementation of "maint show persistent-frame-cache".  */
+
+static void
+show_persistent_frame_cache (struct ui_file *file, int from_tty,
+			     struct cmd_list_element *c, const char *value)
+{
+  fprintf_filtered (file,
+		    _("The persistent frame cache is %s.\n"), value);
+}
+
+/* The maximum number of retained chains; one per thread.  */
+
+#define MAX_RETAINED_FRAME_CHAINS 1024
+
+/* The maximum number of obstacks a chain may span before it is no
+   longer retained.  Each reuse of a chain keeps the obstacks of the
+   previous stops alive, so this bounds the memory held by frames
+   that were discarded after a splice.  */
+
+#define MAX_RETAINED_FRAME_ARENAS 8
+
+/* The largest stack region hashed for a single frame.  Frames with a
+   bigger stack slice are never reused.  */
+
+#define MAX_FRAME_FINGERPRINT_STACK 65536
+
+/* A frame chain retained from a previous stop of a thread.  */
+
+struct retained_frame_chain
+{
+  /* The thread the chain belongs to.  */
+  process_stratum_target *target;
+  ptid_t ptid;
+
+  /* The sentinel frame of the chain.  The other frames are reachable
+     through the PREV links.  NULL once the frames have been spliced
+     into the current chain or deallocated.  */
+  struct frame_info *sentinel;
+
+  /* The obstacks holding the frames of the chain.  */
+  std::vector<std::unique_ptr<auto_obstack>> arenas;
+};
+
+typedef std::unique_ptr<retained_frame_chain> retained_frame_chain_up;
+
+/* The retained chains, oldest first.  */
+
+static std::vector<retained_frame_chain_up> retained_frame_chains;
+
+/* The retained chain of the thread whose frames are being built, if
+   any.  Taken out of RETAINED_FRAME_CHAINS when the sentinel frame
+   is created.  */
+
+static retained_frame_chain_up pending_frame_chain;
+
+/* Obstacks of previous stops that hold frames spliced into the
+   current chain.  */
+
+static std::vector<std::unique_ptr<auto_obstack>> frame_cache_adopted_arenas;
+
+/* The thread the current frame chain belongs to.  */
+
+static process_stratum_target *sentinel_frame_target;
+static ptid_t sentinel_frame_ptid;
+
+/* Deallocate the frames of CHAIN that were not spliced into the
+   current chain.  */
+
+static void
+discard_retained_frame_chain (retained_frame_chain *chain)
+{
+  if (chain->sentinel != NULL)
+    frame_dealloc_chain (chain->sentinel, NULL);
+  chain->sentinel = NULL;
+}
+
+/* Discard all retained frame chains.  */
+
+static void
+discard_retained_frame_chains ()
+{
+  for (const retained_frame_chain_up &chain : retained_frame_chains)
+    discard_retained_frame_chain (chain.get ());
+  retained_frame_chains.clear ();
+
+  if (pending_frame_chain != nullptr)
+    discard_retained_frame_chain (pending_frame_chain.get ());
+  pending_frame_chain.reset ();
+}
+
+/* Observer for events after which retained frames can no longer be
+   trusted, because unwinders or the symbols they rely on changed.  */
+
+static void
+frame_observer_discard_retained (struct objfile *objfile)
+{
+  discard_retained_frame_chains ();
+}
+
+/* Take the retained chain of the thread TARGET/PTID out of the list
+   of retained chains, and make it the pending chain.  */
+
+static void
+take_retained_frame_chain (process_stratum_target *target, ptid_t ptid)
+{
+  if (pending_frame_chain != nullptr)
+    discard_retained_frame_chain (pending_frame_chain.get ());
+  pending_frame_chain.reset ();
+
+  for (auto it = retained_frame_chains.begin ();
+       it != retained_frame_chains.end ();
+       ++it)
+    if ((*it)->target == target && (*it)->ptid == ptid)
+      {
+	pending_frame_chain = std::move (*it);
+	retained_frame_chains.erase (it);
+	return;
+      }
+}
+
+/* Hash the stack memory of frame FI, a frame whose stack pointer is
+   SP, into *HASH.  Return false if the memory can't be read or is too
+   large to be worth hashing.  */
+
+static bool
+frame_stack_fingerprint (struct frame_info *fi, CORE_ADDR sp,
+			 hashval_t *hash)
+{
+  CORE_ADDR stack_addr = fi->this_id.value.stack_addr;
+  CORE_ADDR lo = std::min (sp, stack_addr);
+  CORE_ADDR hi = std::max (sp, stack_addr);
+
+  if (hi - lo > MAX_FRAME_FINGERPRINT_STACK)
+    return false;
+
+  gdb::byte_vector buf (hi - lo);
+  if (hi > lo && target_read_stack (lo, buf.data (), hi - lo) != 0)
+    return false;
+
+  *hash = iterative_hash (buf.data (), buf.size (), 0);
+  return true;
+}
+
+/* Compute the fingerprint of frame FI, whose ID has already been
+   computed.  Frames whose fingerprint can't be computed are never
+   reused.  */
+
+static void
+compute_frame_fingerprint (struct frame_info *fi)
+{
+  gdb_assert (fi->this_id.p);
+
+  if (!persistent_frame_cache
+      || fi->this_id.value.stack_status != FID_STACK_VALID)
+    return;
+
+  /* Only reuse frames whose unwinding depends on nothing but
+     registers and stack memory.  Dummy frames refer to inferior call
+     state, and tail call frames to their bottom frame, which can both
+     go away while the inferior runs.  */
+  if (fi->unwind->type != NORMAL_FRAME && fi->unwind->type != INLINE_FRAME)
+    return;
+
+  try
+    {
+      struct gdbarch *gdbarch = get_frame_arch (fi);
+      CORE_ADDR sp = get_frame_sp (fi);
+      hashval_t stack_hash;
+
+      if (!frame_stack_fingerprint (fi, sp, &stack_hash))
+	return;
+
+      hashval_t regs_hash = 0;
+      scoped_value_mark mark;
+      for (int regnum = 0; regnum < gdbarch_num_regs (gdbarch); regnum++)
+	{
+	  /* Registers the callee may clobber pass through unchanged to
+	     outer frames and change on every step; they don't affect
+	     how the outer frames unwind.  */
+	  if (!gdbarch_call_preserved_register_p (gdbarch, regnum))
+	    continue;
+
+	  struct value *value = get_frame_register_value (fi, regnum);
+	  if (value_optimized_out (value)
+	      || !value_entirely_available (value))
+	    regs_hash = iterative_hash_object (regnum, regs_hash);
+	  else
+	    regs_hash = iterative_hash (value_contents (value),
+					TYPE_LENGTH (value_type (value)),
+					regs_hash);
+	}
+
+      fi->fingerprint.sp = sp;
+      fi->fingerprint.regs = regs_hash;
+      fi->fingerprint.stack = stack_hash;
+      fi->fingerprint.p = 1;
+    }
+  catch (const gdb_exception_error &ex)
+    {
+      /* Leave the fingerprint unset; the frame won't be reused.  */
+    }
+}
+
+/* Return true if retained frame OLD_FI was unwound from the same state
+   as frame NEW_FI of the current chain.  */
+
+static bool
+frame_fingerprints_match (struct frame_info *old_fi,
+			  struct frame_info *new_fi)
+{
+  return (old_fi->fingerprint.p
+	  && new_fi->fingerprint.p
+	  && old_fi->unwind == new_fi->unwind
+	  && frame_id_eq (old_fi->this_id.value, new_fi->this_id.value)
+	  && old_fi->fingerprint.sp == new_fi->fingerprint.sp
+	  && old_fi->fingerprint.regs == new_fi->fingerprint.regs
+	  && old_fi->fingerprint.stack == new_fi->fingerprint.stack);
+}
+
+/* Return true if retained frame FI, outer to a frame that was spliced
+   into the current chain, can itself be reused: its stack memory must
+   not have changed, and it must not already be in the current
+   chain.  */
+
+static bool
+retained_frame_reusable_p (struct frame_info *fi)
+{
+  hashval_t stack_hash;
+
+  if (!fi->this_id.p || !fi->fingerprint.p)
+    return false;
+
+  if (frame_stash_find (fi->this_id.value) != NULL)
+    return false;
+
+  try
+    {
+      if (!frame_stack_fingerprint (fi, fi->fingerprint.sp, &stack_hash))
+	return false;
+    }
+  catch (const gdb_exception_error &ex)
+    {
+      return false;
+    }
+
+  return stack_hash == fi->fingerprint.stack;
+}
+
+/* PREV_FRAME has just been unwound from THIS_FRAME, and stashed.  If
+   the pending retained chain contains a matching frame, splice that
+   frame and the reusable frames outer to it into the current chain in
+   place of PREV_FRAME, and return it.  Otherwise, return
+   PREV_FRAME.  */
+
+static struct frame_info *
+splice_retained_frames (struct frame_info *this_frame,
+			struct frame_info *prev_frame)
+{
+  if (pending_frame_chain == nullptr || pending_frame_chain->sentinel == NULL)
+    return prev_frame;
+
+  if (!prev_frame->fingerprint.p)
+    return prev_frame;
+
+  struct frame_info *old_fi;
+  for (old_fi = pending_frame_chain->sentinel->prev;
+       old_fi != NULL;
+       old_fi = old_fi->prev)
+    {
+      if (frame_fingerprints_match (old_fi, prev_frame))
+	break;
+      if (!old_fi->prev_p)
+	return prev_frame;
+    }
+  if (old_fi == NULL)
+    return prev_frame;
+
+  /* Find how many of the frames outer to OLD_FI can be reused.  */
+  struct frame_info *last = old_fi;
+  while (last->prev_p
+	 && last->prev != NULL
+	 && retained_frame_reusable_p (last->prev))
+    last = last->prev;
+
+  /* The frames of the retained chain that are not reused.  */
+  struct frame_info *inner_unused = pending_frame_chain->sentinel;
+  struct frame_info *outer_unused = last->prev_p ? last->prev : NULL;
+
+  frame_dealloc_chain (inner_unused, old_fi);
+  if (outer_unused != NULL)
+    frame_dealloc_chain (outer_unused, NULL);
+  frame_dealloc_caches (prev_frame);
+
+  /* Link the retained frames in.  */
+  this_frame->prev = old_fi;
+  old_fi->next = this_frame;
+  if (outer_unused != NULL)
+    {
+      last->prev_p = 0;
+      last->prev = NULL;
+      last->stop_reason = UNWIND_NO_REASON;
+      last->stop_string = NULL;
+    }
+
+  /* Replace PREV_FRAME in the stash, and stash the outer frames.  */
+  void **slot = htab_find_slot (frame_stash, prev_frame, NO_INSERT);
+  gdb_assert (slot != NULL);
+  *slot = old_fi;
+
+  int level = this_frame->level + 1;
+  for (struct frame_info *fi = old_fi; ; fi = fi->prev)
+    {
+      fi->level = level++;
+      if (fi != old_fi)
+	{
+	  int stashed = frame_stash_add (fi);
+	  gdb_assert (stashed);
+	}
+      if (fi == last)
+	break;
+    }
+
+  /* The retained frames now belong to the current chain.  */
+  for (auto &arena : pending_frame_chain->arenas)
+    frame_cache_adopted_arenas.push_back (std::move (arena));
+  pending_frame_chain.reset ();
+
+  if (frame_debug)
+    fprintf_unfiltered (gdb_stdlog,
+			"{ splice_retained_frames (this_frame=%d) "
+			"-> reused frames %d to %d }\n",
+			this_frame->level, old_fi->level, last->level);
+
+  return old_fi;
+}
+
 /* Cache for frame addresses already read by gdb.  Valid only while
    inferior is stopped.  Control variables for the frame cache should
    be local to this module.  */
@@ -1620,8 +2012,15 @@ get_current_frame (void)
     validate_registers_access ();
 
   if (sentinel_frame == NULL)
-    sentinel_frame =
-      create_sentinel_frame (current_program_space, get_current_regcache ());
+    {
+      sentinel_frame =
+	create_sentinel_frame (current_program_space, get_current_regcache ());
+
+      sentinel_frame_target = current_inferior ()->process_target ();
+      sentinel_frame_ptid = inferior_ptid;
+      if (persistent_frame_cache)
+	take_retained_frame_chain (sentinel_frame_target, sentinel_frame_ptid);
+    }
 
   /* Set the current frame before computing the frame id, to avoid
      recursion inside compute_frame_id, in case the frame's
@@ -1844,25 +2243,64 @@ frame_observer_target_changed (struct target_ops *target)
   reinit_frame_cache ();
 }
 
-/* Flush the entire frame cache.  */
+/* Tear down the current frame chain.  If RETAIN, keep the frames
+   around so that they can be reused the next time a chain is built
+   for the same thread.  */
 
-void
-reinit_frame_cache (void)
+static void
+reinit_frame_cache_1 (bool retain)
 {
-  struct frame_info *fi;
+  if (sentinel_frame != NULL
+      && retain
+      && frame_cache_adopted_arenas.size () < MAX_RETAINED_FRAME_ARENAS)
+    {
+      retained_frame_chain_up chain (new retained_frame_chain);
+
+      chain->target = sentinel_frame_target;
+      chain->ptid = sentinel_frame_ptid;
+      chain->sentinel = sentinel_frame;
+      chain->arenas = std::move (frame_cache_adopted_arenas);
+
+      /* Hand the current obstack over to the chain, and continue with
+	 a fresh one.  */
+      std::unique_ptr<auto_obstack> arena (new auto_obstack);
+      std::swap (*(struct obstack *) arena.get (), frame_cache_obstack);
+      chain->arenas.push_back (std::move (arena));
 
-  /* Tear down all frame caches.  */
-  for (fi = sentinel_frame; fi != NULL; fi = fi->prev)
+      take_retained_frame_chain (chain->target, chain->ptid);
+      if (pending_frame_chain != nullptr)
+	discard_retained_frame_chain (pending_frame_chain.get ());
+      pending_frame_chain.reset ();
+
+      if (retained_frame_chains.size () >= MAX_RETAINED_FRAME_CHAINS)
+	{
+	  discard_retained_frame_chain (retained_frame_chains.front ().get ());
+	  retained_frame_chains.erase (retained_frame_chains.begin ());
+	}
+      retained_frame_chains.push_back (std::move (chain));
+    }
+  else
     {
-      if (fi->prologue_cache && fi->unwind->dealloc_cache)
-	fi->unwind->dealloc_cache (fi, fi->prologue_cache);
-      if (fi->base_cache && fi->base->unwind->dealloc_cache)
-	fi->base->unwind->dealloc_cache (fi, fi->base_cache);
+      /* Tear down all frame caches.  */
+      if (sentinel_frame != NULL)
+	frame_dealloc_chain (sentinel_frame, NULL);
+
+      /* Since we can't really be sure what the first object allocated
+	 was.  */
+      obstack_free (&frame_cache_obstack, 0);
+      obstack_init (&frame_cache_obstack);
+      frame_cache_adopted_arenas.clear ();
+
+      if (!retain)
+	discard_retained_frame_chains ();
     }
 
-  /* Since we can't really be sure what the first object allocated was.  */
-  obstack_free (&frame_cache_obstack, 0);
-  obstack_init (&frame_cache_obstack);
+  if (pending_frame_chain != nullptr)
+    {
+      /* The current thread's retained chain was not reused; give it
+	 back so that it can be tried again.  */
+      retained_frame_chains.push_back (std::move (pending_frame_chain));
+    }
 
   if (sentinel_frame != NULL)
     annotate_frames_invalid ();
@@ -1871,7 +2309,24 @@ reinit_frame_cache (void)
   select_frame (NULL);
   frame_stash_invalidate ();
   if (frame_debug)
-    fprintf_unfiltered (gdb_stdlog, "{ reinit_frame_cache () }\n");
+    fprintf_unfiltered (gdb_stdlog, "{ reinit_frame_cache (%s) }\n",
+			retain ? "retain" : "");
+}
+
+/* Flush the entire frame cache.  */
+
+void
+reinit_frame_cache (void)
+{
+  reinit_frame_cache_1 (false);
+}
+
+/* See frame.h.  */
+
+void
+reinit_frame_cache_retaining (void)
+{
+  reinit_frame_cache_1 (persistent_frame_cache);
 }
 
 /* Find where a register is saved (in memory or another register).
@@ -1949,6 +2404,14 @@ get_prev_frame_if_no_cycle (struct frame_info *this_frame)
 	  this_frame->prev = NULL;
 	  prev_frame = NULL;
 	}
+      else
+	{
+	  /* If this frame was already unwound at a previous stop, and
+	     nothing it depends on changed since, reuse the frames
+	     unwound back then.  */
+	  compute_frame_fingerprint (prev_frame);
+	  prev_frame = splice_retained_frames (this_frame, prev_frame);
+	}
     }
   catch (const gdb_exception &ex)
     {
@@ -2963,6 +3426,8 @@ _initialize_frame ()
   frame_stash_create ();
 
   gdb::observers::target_changed.attach (frame_observer_target_changed);
+  gdb::observers::new_objfile.attach (frame_observer_discard_retained);
+  gdb::observers::free_objfile.attach (frame_observer_discard_retained);
 
   add_basic_prefix_cmd ("backtrace", class_maintenance, _("\
 Set backtrace specific variables.\n\
@@ -2998,4 +3463,17 @@ When non-zero, frame specific internal debugging is enabled."),
 			     NULL,
 			     show_frame_debug,
 			     &setdebuglist, &showdebuglist);
+
+  add_setshow_boolean_cmd ("persistent-frame-cache", class_maintenance,
+			   &persistent_frame_cache, _("\
+Set whether frames are reused across inferior stops."), _("\
+Show whether frames are reused across inferior stops."), _("\
+When on, the frames of a thread are kept when the inferior resumes or\n\
+another thread is selected.  The next backtrace of that thread reuses\n\
+the outer frames whose registers and stack memory did not change,\n\
+instead of unwinding them again."),
+			   NULL,
+			   show_persistent_frame_cache,
+			   &maintenance_set_cmdlist,
+			   &maintenance_show_cmdlist);
 }
@@ -318,6 +318,14 @@ extern int has_stack_frames (void);
    modifies the target invalidating the frame cache).  */
 extern void reinit_frame_cache (void);
 
+/* Like reinit_frame_cache, but for when only the registers and memory
+   of the inferior may have changed, e.g., because the inferior was
+   resumed or another thread was selected.  If the persistent frame
+   cache is enabled ("maint set persistent-frame-cache"), the frames
+   of the current thread are kept, and reused by the next unwind of
+   that thread wherever they are still valid.  */
+extern void reinit_frame_cache_retaining (void);
+
 /* On demand, create the selected frame and then return it.  If the
    selected frame can not be created, this function prints then throws
    an error.  When MESSAGE is non-NULL, use it for the error message,
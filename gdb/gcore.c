@@ -38,6 +38,21 @@
 #include "gdbsupport/gdb_unlinker.h"
 #include "gdbsupport/byte-vector.h"
 #include "gdbsupport/scope-exit.h"
+#include "gdbsupport/scoped_fd.h"
+#include "gdbsupport/filestuff.h"
+#include "gdbsupport/pathstuff.h"
+#include "gdbsupport/parallel-for.h"
+#include "gdbsupport/function-view.h"
+#include "breakpoint.h"
+#include "record.h"
+#include "gdbcmd.h"
+#include "cli/cli-option.h"
+#include "completer.h"
+#include "compressed-core.h"
+#include "gdbsupport/thread-pool.h"
+#include <sys/stat.h>
+#include <algorithm>
+#include <zlib.h>
 
 /* The largest amount of memory to read from the target at once.  We
    must throttle it to limit the amount of memory used by GDB during
@@ -47,7 +62,7 @@
 static const char *default_gcore_target (void);
 static enum bfd_architecture default_gcore_arch (void);
 static unsigned long default_gcore_mach (void);
-static int gcore_memory_sections (bfd *);
+static int gcore_memory_sections (bfd *, bool);
 
 /* create_gcore_bfd -- helper for gcore_command (exported).
    Open a new bfd core file for output, and return the handle.  */
@@ -67,7 +82,7 @@ create_gcore_bfd (const char *filename)
 /* write_gcore_file_1 -- do the actual work of write_gcore_file.  */
 
 static void
-write_gcore_file_1 (bfd *obfd)
+write_gcore_file_1 (bfd *obfd, bool compress)
 {
   gdb::unique_xmalloc_ptr<char> note_data;
   int note_size = 0;
@@ -100,7 +115,7 @@ write_gcore_file_1 (bfd *obfd)
   bfd_set_section_size (note_sec, note_size);
 
   /* Now create the memory/load sections.  */
-  if (gcore_memory_sections (obfd) == 0)
+  if (gcore_memory_sections (obfd, compress) == 0)
     error (_("gcore: failed to get corefile memory sections from target."));
 
   /* Write out the contents of the note section.  */
@@ -110,14 +125,57 @@ write_gcore_file_1 (bfd *obfd)
 }
 
 /* write_gcore_file -- helper for gcore_command (exported).
-   Compose and write the corefile data to the core file.  */
+   Compose and write the corefile data to the core file.  If COMPRESS,
+   write the memory compressed, see compressed-core.h.  */
 
 void
-write_gcore_file (bfd *obfd)
+write_gcore_file (bfd *obfd, bool compress)
 {
   target_prepare_to_generate_core ();
   SCOPE_EXIT { target_done_generating_core (); };
-  write_gcore_file_1 (obfd);
+  write_gcore_file_1 (obfd, compress);
+}
+
+/* The options of the "gcore" command.  */
+
+struct gcore_options
+{
+  bool compress = false;
+};
+
+static const gdb::option::option_def gcore_option_defs[] = {
+
+  gdb::option::flag_option_def<gcore_options> {
+    "compress",
+    [] (gcore_options *opts) { return &opts->compress; },
+    N_("Compress the memory saved in the core file."),
+  },
+
+};
+
+/* Create an option_def_group for the "gcore" options, with OPTS as
+   context.  */
+
+static inline gdb::option::option_def_group
+make_gcore_options_def_group (gcore_options *opts)
+{
+  return {{gcore_option_defs}, opts};
+}
+
+/* Completer for the "gcore" command.  */
+
+static void
+gcore_command_completer (struct cmd_list_element *ignore,
+			 completion_tracker &tracker,
+			 const char *text, const char *word)
+{
+  const auto group = make_gcore_options_def_group (nullptr);
+  if (gdb::option::complete_options
+      (tracker, &text, gdb::option::PROCESS_OPTIONS_UNKNOWN_IS_ERROR, group))
+    return;
+
+  word = advance_to_filename_complete_word_point (tracker, text);
+  filename_completer (ignore, tracker, text, word);
 }
 
 /* gcore_command -- implements the 'gcore' command.
@@ -127,6 +185,11 @@ static void
 gcore_command (const char *args, int from_tty)
 {
   gdb::unique_xmalloc_ptr<char> corefilename;
+  gcore_options opts;
+
+  auto group = make_gcore_options_def_group (&opts);
+  gdb::option::process_options
+    (&args, gdb::option::PROCESS_OPTIONS_UNKNOWN_IS_ERROR, group);
 
   /* No use generating a corefile without a target process.  */
   if (!target_has_execution)
@@ -152,7 +215,7 @@ gcore_command (const char *args, int from_tty)
   gdb::unlinker unlink_file (corefilename.get ());
 
   /* Call worker function.  */
-  write_gcore_file (obfd.get ());
+  write_gcore_file (obfd.get (), opts.compress);
 
   /* Succeeded.  */
   unlink_file.keep ();
@@ -569,8 +632,519 @@ gcore_copy_callback (bfd *obfd, asection *osec, void *ignored)
     }
 }
 
+/* Whether "gcore" writes the memory of the inferior directly to the
+   core file, from worker threads, leaving its all-zero pages as
+   holes.  */
+
+static bool gcore_streaming = false;
+
+static void
+show_gcore_streaming (struct ui_file *file, int from_tty,
+		      struct cmd_list_element *c, const char *value)
+{
+  fprintf_filtered (file, _("Streaming of core file memory is %s.\n"),
+		    value);
+}
+
+/* The granularity with which all-zero memory is left as holes in the
+   core file when streaming.  */
+#define GCORE_ZERO_BLOCK_SIZE 4096
+
+/* A piece of a memory section of the core file being streamed.  */
+
+struct gcore_stream_chunk
+{
+  asection *osec;
+  bfd_size_type offset;
+  bfd_size_type size;
+
+  /* Set if the chunk could not be read.  */
+  bool read_failed;
+
+  /* The errno value if the chunk could not be written, or zero.  */
+  int write_errno;
+};
+
+/* Write the LEN bytes at BUF to FD at OFFSET.  Return false on
+   error.  Without pwrite, this moves the file offset of FD, so it
+   must not be called for the same FD from several threads.  */
+
+static bool
+gcore_pwrite (int fd, const gdb_byte *buf, size_t len, file_ptr offset)
+{
+#ifndef HAVE_PWRITE
+  if (lseek (fd, offset, SEEK_SET) == -1)
+    return false;
+#endif
+
+  while (len > 0)
+    {
+#ifdef HAVE_PWRITE
+      ssize_t ret = pwrite (fd, buf, len, offset);
+#else
+      ssize_t ret = write (fd, buf, len);
+#endif
+
+      if (ret == 0)
+	errno = ENOSPC;
+      if (ret <= 0)
+	return false;
+      buf += ret;
+      len -= ret;
+      offset += ret;
+    }
+
+  return true;
+}
+
+/* Read up to LEN bytes from FD at OFFSET into BUF.  Return the number
+   of bytes read, zero at the end of the file or -1 on error.  Like
+   gcore_pwrite, this may move the file offset of FD.  */
+
+static ssize_t
+gcore_pread (int fd, gdb_byte *buf, size_t len, file_ptr offset)
+{
+#if defined (HAVE_PREAD64)
+  return pread64 (fd, buf, len, offset);
+#elif defined (HAVE_PREAD)
+  return pread (fd, buf, len, offset);
+#else
+  if (lseek (fd, offset, SEEK_SET) == -1)
+    return -1;
+  return read (fd, buf, len);
+#endif
+}
+
+/* Return true if the LEN bytes at BUF are all zero.  */
+
+static bool
+gcore_zero_p (const gdb_byte *buf, size_t len)
+{
+  return len == 0 || (buf[0] == 0 && memcmp (buf, buf + 1, len - 1) == 0);
+}
+
+/* Copy CHUNK of memory to the core file FD, using BUF to hold it.
+   READ reads the memory.  The blocks of the chunk that are all zero
+   are not written, so they become holes in the file.  This can be
+   called from worker threads if READ can.  */
+
+static void
+gcore_write_chunk (struct gcore_stream_chunk *chunk, int fd, gdb_byte *buf,
+		   gdb::function_view<bool (CORE_ADDR, gdb_byte *,
+					    size_t)> read)
+{
+  CORE_ADDR vma = bfd_section_vma (chunk->osec) + chunk->offset;
+  file_ptr filepos = chunk->osec->filepos + chunk->offset;
+
+  if (!read (vma, buf, chunk->size))
+    {
+      chunk->read_failed = true;
+      return;
+    }
+
+  /* Write the runs of blocks that are not all zero.  */
+  size_t run_start = 0, run_len = 0;
+  for (size_t offset = 0; offset < chunk->size;
+       offset += GCORE_ZERO_BLOCK_SIZE)
+    {
+      size_t len = std::min ((size_t) chunk->size - offset,
+			     (size_t) GCORE_ZERO_BLOCK_SIZE);
+
+      if (!gcore_zero_p (buf + offset, len))
+	{
+	  if (run_len == 0)
+	    run_start = offset;
+	  run_len += len;
+	  continue;
+	}
+
+      if (run_len != 0
+	  && !gcore_pwrite (fd, buf + run_start, run_len,
+			    filepos + run_start))
+	{
+	  chunk->write_errno = errno;
+	  return;
+	}
+      run_len = 0;
+    }
+
+  if (run_len != 0
+      && !gcore_pwrite (fd, buf + run_start, run_len, filepos + run_start))
+    chunk->write_errno = errno;
+}
+
+/* Called with the location BL of a breakpoint.  If it is inserted in
+   memory that was streamed to the core file FD with a
+   concurrent_memory_reader, which does not hide breakpoints, write
+   the original contents of the memory over it.  */
+
+static void
+gcore_unstream_breakpoint (int fd, const std::vector<asection *> &sections,
+			   struct bp_location *bl)
+{
+  if (!bl->inserted || bl->loc_type != bp_loc_software_breakpoint
+      || bl->target_info.shadow_len == 0)
+    return;
+
+  CORE_ADDR addr = bl->target_info.placed_address;
+  int len = bl->target_info.shadow_len;
+
+  for (asection *osec : sections)
+    {
+      CORE_ADDR vma = bfd_section_vma (osec);
+
+      if (addr < vma || addr + len > vma + bfd_section_size (osec))
+	continue;
+
+      gdb::byte_vector contents (len);
+      if (target_read_memory (addr, contents.data (), len) == 0)
+	gcore_pwrite (fd, contents.data (), len,
+		      osec->filepos + (addr - vma));
+    }
+}
+
+/* Copy the memory of the "load" sections of OBFD to the core file by
+   streaming, see gcore_streaming.  Return false if that cannot be
+   done, in which case nothing was written.  */
+
+static bool
+gcore_stream_sections (bfd *obfd)
+{
+  if (bfd_get_flavour (obfd) != bfd_target_elf_flavour)
+    return false;
+
+#ifndef HAVE_PWRITE
+  /* The worker threads write their chunks with gcore_pwrite, which
+     needs pwrite to be used from several threads.  */
+  return false;
+#endif
+
+  std::vector<asection *> sections;
+  for (asection *osec = obfd->sections; osec != NULL; osec = osec->next)
+    if ((bfd_section_flags (osec) & SEC_LOAD) != 0
+	&& startswith (bfd_section_name (osec), "load")
+	&& bfd_section_size (osec) > 0)
+      sections.push_back (osec);
+
+  if (sections.empty ())
+    return true;
+
+  /* Have BFD lay out the file, so that the position of each section
+     is known.  */
+  gdb_byte dummy = 0;
+  if (!bfd_set_section_contents (obfd, sections[0], &dummy, 0, 0))
+    return false;
+
+  scoped_fd fd (gdb_open_cloexec (bfd_get_filename (obfd),
+				  O_WRONLY | O_BINARY, 0));
+  if (fd.get () < 0)
+    return false;
+
+  std::vector<gcore_stream_chunk> chunks;
+  file_ptr end = 0;
+  for (asection *osec : sections)
+    {
+      bfd_size_type size = bfd_section_size (osec);
+
+      for (bfd_size_type offset = 0; offset < size; offset += MAX_COPY_BYTES)
+	chunks.push_back ({ osec, offset,
+			    std::min (size - offset,
+				      (bfd_size_type) MAX_COPY_BYTES),
+			    false, 0 });
+      end = std::max (end, (file_ptr) (osec->filepos + size));
+    }
+
+  /* The memory of the inferior can only be read from worker threads
+     if the target provides a way to; record targets are left out
+     since the memory they show is not the inferior's.  */
+  std::unique_ptr<concurrent_memory_reader> reader;
+  if (find_record_target () == NULL)
+    reader = target_make_concurrent_memory_reader ();
+
+  if (reader != nullptr)
+    {
+      auto read = [&] (CORE_ADDR memaddr, gdb_byte *myaddr, size_t len)
+	{
+	  return reader->read (memaddr, myaddr, len);
+	};
+
+      gdb::parallel_for_each
+	(chunks.begin (), chunks.end (),
+	 [&] (std::vector<gcore_stream_chunk>::iterator first,
+	      std::vector<gcore_stream_chunk>::iterator last)
+	 {
+	   gdb::byte_vector buf (MAX_COPY_BYTES);
+
+	   for (; first != last; ++first)
+	     gcore_write_chunk (&*first, fd.get (), buf.data (), read);
+	 });
+
+      /* The memory was read without hiding the inserted breakpoints;
+	 put back what they hide.  */
+      iterate_over_bp_locations ([&] (bp_location *bl)
+	{
+	  gcore_unstream_breakpoint (fd.get (), sections, bl);
+	});
+    }
+  else
+    {
+      auto read = [&] (CORE_ADDR memaddr, gdb_byte *myaddr, size_t len)
+	{
+	  return target_read_memory (memaddr, myaddr, len) == 0;
+	};
+      gdb::byte_vector buf (MAX_COPY_BYTES);
+
+      for (gcore_stream_chunk &chunk : chunks)
+	gcore_write_chunk (&chunk, fd.get (), buf.data (), read);
+    }
+
+  /* Warn once per section, like gcore_copy_callback.  */
+  asection *warned = NULL;
+  for (const gcore_stream_chunk &chunk : chunks)
+    {
+      if (chunk.osec == warned
+	  || (!chunk.read_failed && chunk.write_errno == 0))
+	continue;
+
+      warned = chunk.osec;
+      if (chunk.read_failed)
+	warning (_("Memory read failed for corefile "
+		   "section, %s bytes at %s."),
+		 plongest (chunk.size),
+		 paddress (target_gdbarch (),
+			   bfd_section_vma (chunk.osec) + chunk.offset));
+      else
+	warning (_("Failed to write corefile contents (%s)."),
+		 safe_strerror (chunk.write_errno));
+    }
+
+  /* If the end of the last section is a hole, the file would be too
+     short; write its last byte.  */
+  struct stat st;
+  if (fstat (fd.get (), &st) == 0 && st.st_size < end)
+    gcore_pwrite (fd.get (), &dummy, 1, end - 1);
+
+  return true;
+}
+
+/* The size of the chunks of memory that "gcore -compress" compresses
+   independently of each other.  Reading any part of a chunk from the
+   core file means decompressing all of it; larger chunks compress
+   better.  */
+#define GCORE_COMPRESS_CHUNK_SIZE (256 * 1024)
+
+/* A piece of a memory section of a core file being compressed.  */
+
+struct gcore_compressed_chunk
+{
+  asection *osec;
+  bfd_size_type offset;
+  bfd_size_type size;
+
+  /* The memory, and then the data of the chunk, see
+     compressed-core.h.  */
+  gdb::byte_vector data;
+};
+
+/* Replace the memory of CHUNK with its compressed form, or with
+   nothing if it is all zero.  This can be called from worker
+   threads.  */
+
+static void
+gcore_compress_chunk_data (gcore_compressed_chunk *chunk)
+{
+  if (gcore_zero_p (chunk->data.data (), chunk->size))
+    {
+      chunk->data.clear ();
+      return;
+    }
+
+  uLongf compressed_len = compressBound (chunk->size);
+  gdb::byte_vector compressed (compressed_len);
+
+  /* Keep the memory uncompressed if it does not compress.  */
+  if (compress2 (compressed.data (), &compressed_len, chunk->data.data (),
+		 chunk->size, Z_DEFAULT_COMPRESSION) == Z_OK
+      && compressed_len < chunk->size)
+    {
+      compressed.resize (compressed_len);
+      chunk->data = std::move (compressed);
+    }
+}
+
+/* Write the memory of the "load" sections of OBFD compressed, in a
+   PT_GDB_COMPRESSED_MEMORY segment, instead of as the contents of the
+   sections; see compressed-core.h.  The chunks of memory are read in
+   batches, and the chunks of each batch are compressed by worker
+   threads.  The compressed data is staged in a temporary file, since
+   its size must be known before BFD lays out the core file.  */
+
+static void
+gcore_compress_sections (bfd *obfd)
+{
+  if (bfd_get_flavour (obfd) != bfd_target_elf_flavour)
+    error (_("Compressed core files can only be written in ELF format."));
+
+  std::vector<asection *> sections;
+  for (asection *osec = obfd->sections; osec != NULL; osec = osec->next)
+    if ((bfd_section_flags (osec) & SEC_LOAD) != 0
+	&& startswith (bfd_section_name (osec), "load")
+	&& bfd_section_size (osec) > 0)
+      sections.push_back (osec);
+
+  std::sort (sections.begin (), sections.end (),
+	     [] (asection *a, asection *b)
+	     {
+	       return bfd_section_vma (a) < bfd_section_vma (b);
+	     });
+
+  std::vector<gcore_compressed_chunk> chunks;
+  for (asection *osec : sections)
+    {
+      bfd_size_type size = bfd_section_size (osec);
+
+      for (bfd_size_type offset = 0; offset < size;
+	   offset += GCORE_COMPRESS_CHUNK_SIZE)
+	chunks.push_back ({ osec, offset,
+			    std::min (size - offset,
+				      (bfd_size_type) GCORE_COMPRESS_CHUNK_SIZE),
+			    {} });
+
+      /* The PT_LOAD segment of the section keeps its address and size,
+	 but has no contents in the file.  */
+      bfd_set_section_flags (osec, (bfd_section_flags (osec)
+				    & ~(SEC_LOAD | SEC_HAS_CONTENTS)));
+    }
+
+  /* Use a fresh file next to the core file, rather than one with a
+     fixed name that could already exist.  */
+  gdb::char_vector tmp_name = make_temp_filename (bfd_get_filename (obfd));
+  int fd = gdb_mkostemp_cloexec (tmp_name.data (), O_BINARY);
+  if (fd < 0)
+    perror_with_name (tmp_name.data ());
+  gdb::unlinker unlink_tmp (tmp_name.data ());
+  scoped_fd tmp_fd (fd);
+
+  /* The offset and size of the data of each chunk in the temporary
+     file.  */
+  std::vector<std::pair<ULONGEST, ULONGEST>> chunk_data;
+  ULONGEST data_size = 0;
+
+  size_t batch_size
+    = std::max (gdb::thread_pool::g_thread_pool->thread_count (),
+		(size_t) 1) * 4;
+  asection *warned = NULL;
+  for (size_t start = 0; start < chunks.size (); start += batch_size)
+    {
+      auto first = chunks.begin () + start;
+      auto last = chunks.begin () + std::min (start + batch_size,
+					       chunks.size ());
+
+      /* The target can only be read from this thread.  */
+      for (auto iter = first; iter != last; ++iter)
+	{
+	  CORE_ADDR vma = bfd_section_vma (iter->osec) + iter->offset;
+
+	  iter->data.resize (iter->size);
+	  if (target_read_memory (vma, iter->data.data (), iter->size) != 0)
+	    {
+	      if (iter->osec != warned)
+		warning (_("Memory read failed for corefile "
+			   "section, %s bytes at %s."),
+			 plongest (iter->size),
+			 paddress (target_gdbarch (), vma));
+	      warned = iter->osec;
+	      memset (iter->data.data (), 0, iter->size);
+	    }
+	}
+
+      gdb::parallel_for_each
+	(first, last,
+	 [] (std::vector<gcore_compressed_chunk>::iterator chunk_first,
+	     std::vector<gcore_compressed_chunk>::iterator chunk_last)
+	 {
+	   for (; chunk_first != chunk_last; ++chunk_first)
+	     gcore_compress_chunk_data (&*chunk_first);
+	 });
+
+      for (auto iter = first; iter != last; ++iter)
+	{
+	  if (!gcore_pwrite (tmp_fd.get (), iter->data.data (),
+			     iter->data.size (), data_size))
+	    perror_with_name (tmp_name.data ());
+
+	  chunk_data.emplace_back (data_size, iter->data.size ());
+	  data_size += iter->data.size ();
+	  iter->data = gdb::byte_vector ();
+	}
+    }
+
+  ULONGEST tables_size = (COMPRESSED_CORE_HEADER_SIZE
+			  + sections.size () * COMPRESSED_CORE_REGION_SIZE
+			  + chunks.size () * COMPRESSED_CORE_CHUNK_SIZE);
+  asection *zsec = bfd_make_section_anyway_with_flags (obfd, "zmem",
+						       SEC_HAS_CONTENTS
+						       | SEC_READONLY);
+  if (zsec == NULL)
+    error (_("Failed to create the compressed memory section for "
+	     "corefile: %s"),
+	   bfd_errmsg (bfd_get_error ()));
+
+  bfd_set_section_size (zsec, tables_size + data_size);
+  bfd_set_section_alignment (zsec, 0);
+  if (!bfd_record_phdr (obfd, PT_GDB_COMPRESSED_MEMORY, 0, 0, 0, 0, 0, 0,
+			1, &zsec))
+    error (_("Failed to create the compressed memory segment for "
+	     "corefile: %s"),
+	   bfd_errmsg (bfd_get_error ()));
+
+  gdb::byte_vector tables (tables_size);
+  gdb_byte *p = tables.data ();
+
+  memcpy (p, COMPRESSED_CORE_MAGIC, COMPRESSED_CORE_MAGIC_SIZE);
+  bfd_put_32 (obfd, COMPRESSED_CORE_VERSION, p + 8);
+  bfd_put_32 (obfd, COMPRESSED_CORE_ZLIB, p + 12);
+  bfd_put_64 (obfd, GCORE_COMPRESS_CHUNK_SIZE, p + 16);
+  bfd_put_64 (obfd, sections.size (), p + 24);
+  bfd_put_64 (obfd, chunks.size (), p + 32);
+  p += COMPRESSED_CORE_HEADER_SIZE;
+
+  for (asection *osec : sections)
+    {
+      bfd_put_64 (obfd, bfd_section_vma (osec), p);
+      bfd_put_64 (obfd, bfd_section_size (osec), p + 8);
+      p += COMPRESSED_CORE_REGION_SIZE;
+    }
+
+  for (const std::pair<ULONGEST, ULONGEST> &entry : chunk_data)
+    {
+      bfd_put_64 (obfd, tables_size + entry.first, p);
+      bfd_put_64 (obfd, entry.second, p + 8);
+      p += COMPRESSED_CORE_CHUNK_SIZE;
+    }
+
+  if (!bfd_set_section_contents (obfd, zsec, tables.data (), 0, tables_size))
+    error (_("Failed to write corefile contents (%s)."),
+	   bfd_errmsg (bfd_get_error ()));
+
+  gdb::byte_vector buf (MAX_COPY_BYTES);
+  for (ULONGEST pos = 0; pos < data_size; )
+    {
+      size_t len = std::min (data_size - pos, (ULONGEST) MAX_COPY_BYTES);
+      ssize_t ret = gcore_pread (tmp_fd.get (), buf.data (), len, pos);
+      if (ret <= 0)
+	perror_with_name (tmp_name.data ());
+
+      if (!bfd_set_section_contents (obfd, zsec, buf.data (),
+				     tables_size + pos, ret))
+	error (_("Failed to write corefile contents (%s)."),
+	       bfd_errmsg (bfd_get_error ()));
+      pos += ret;
+    }
+}
+
 static int
-gcore_memory_sections (bfd *obfd)
+gcore_memory_sections (bfd *obfd, bool compress)
 {
   /* Try gdbarch method first, then fall back to target method.  */
   if (!gdbarch_find_memory_regions_p (target_gdbarch ())
@@ -585,7 +1159,10 @@ gcore_memory_sections (bfd *obfd)
   bfd_map_over_sections (obfd, make_output_phdrs, NULL);
 
   /* Copy memory region contents.  */
-  bfd_map_over_sections (obfd, gcore_copy_callback, NULL);
+  if (compress)
+    gcore_compress_sections (obfd);
+  else if (!gcore_streaming || !gcore_stream_sections (obfd))
+    bfd_map_over_sections (obfd, gcore_copy_callback, NULL);
 
   return 1;
 }
@@ -594,10 +1171,32 @@ void _initialize_gcore ();
 void
 _initialize_gcore ()
 {
-  add_com ("generate-core-file", class_files, gcore_command, _("\
+  const auto gcore_opts = make_gcore_options_def_group (nullptr);
+
+  static std::string gcore_help
+    = gdb::option::build_help (_("\
 Save a core file with the current state of the debugged process.\n\
-Usage: generate-core-file [FILENAME]\n\
-Argument is optional filename.  Default filename is 'core.PROCESS_ID'."));
+Usage: generate-core-file [OPTION]... [FILENAME]\n\
+Argument is optional filename.  Default filename is 'core.PROCESS_ID'.\n\
+\n\
+Options:\n\
+%OPTIONS%"),
+			       gcore_opts);
+
+  struct cmd_list_element *c
+    = add_com ("generate-core-file", class_files, gcore_command,
+	       gcore_help.c_str ());
+  set_cmd_completer_handle_brkchars (c, gcore_command_completer);
 
   add_com_alias ("gcore", "generate-core-file", class_files, 1);
+
+  add_setshow_boolean_cmd ("gcore-streaming", class_files,
+			   &gcore_streaming, _("\
+Set whether gcore streams the memory of the inferior to the core file."), _("\
+Show whether gcore streams the memory of the inferior to the core file."), _("\
+When on, gcore writes the memory of the inferior directly to the core\n\
+file, reading it from worker threads if the target allows it, and leaves\n\
+the pages of memory that are all zero as holes in the file."),
+			   NULL, show_gcore_streaming,
+			   &setlist, &showlist);
 }
@@ -23,7 +23,7 @@
 #include "gdb_bfd.h"
 
 extern gdb_bfd_ref_ptr create_gcore_bfd (const char *filename);
-extern void write_gcore_file (bfd *obfd);
+extern void write_gcore_file (bfd *obfd, bool compress = false);
 extern bfd *load_corefile (char *filename, int from_tty);
 extern int objfile_find_memory_regions (struct target_ops *self,
 					find_memory_region_ftype func,
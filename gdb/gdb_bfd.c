@@ -23,6 +23,7 @@
 #include "gdbcmd.h"
 #include "hashtab.h"
 #include "gdbsupport/filestuff.h"
+#include "gdbsupport/thread-pool.h"
 #ifdef HAVE_MMAP
 #include <sys/mman.h>
 #ifndef MAP_FAILED
@@ -32,6 +33,12 @@
 #include "target.h"
 #include "gdb/fileio.h"
 #include "inferior.h"
+#include <algorithm>
+#include <zlib.h>
+#ifdef HAVE_ZSTD
+#include <zstd.h>
+#endif
+#include "elf/common.h"
 
 /* An object of this type is stored in the section's user data when
    mapping a section.  */
@@ -113,6 +120,12 @@ struct gdb_bfd_data
   /* The file's CRC.  */
   unsigned long crc = 0;
 
+  /* The number of bytes of section contents that gdb_bfd_map_section
+     mapped from the file, and that it read or decompressed into
+     memory instead.  */
+  bfd_size_type mapped_bytes = 0;
+  bfd_size_type copied_bytes = 0;
+
   /* If the BFD comes from an archive, this points to the archive's
      BFD.  Otherwise, this is NULL.  */
   bfd *archive_bfd = nullptr;
@@ -144,6 +157,17 @@ show_bfd_sharing  (struct ui_file *file, int from_tty,
   fprintf_filtered (file, _("BFD sharing is %s.\n"), value);
 }
 
+/* When true, gdb_bfd_map_section maps the uncompressed sections of
+   files rather than reading them into memory.  */
+
+static bool bfd_mmap_sections = true;
+static void
+show_bfd_mmap_sections (struct ui_file *file, int from_tty,
+			struct cmd_list_element *c, const char *value)
+{
+  fprintf_filtered (file, _("Mapping of BFD sections is %s.\n"), value);
+}
+
 /* When non-zero debugging of the bfd caches is enabled.  */
 
 static unsigned int debug_bfd_cache;
@@ -645,6 +669,287 @@ get_section_descriptor (asection *section)
   return result;
 }
 
+#ifdef HAVE_MMAP
+
+/* The amount of compressed data given to zlib or zstd at a time.  The
+   pages of the compressed data are released after each chunk.  */
+
+#define DECOMPRESS_CHUNK_SIZE (1024 * 1024)
+
+/* A compressed section, decompressed straight from a mapping of its
+   compressed data in the file.  This avoids reading the compressed
+   data into memory, as bfd_get_full_section_contents does, so that
+   only the decompressed data stays resident.  */
+
+struct mapped_compressed_section
+{
+  explicit mapped_compressed_section (asection *sectp)
+    : sectp (sectp)
+  {
+  }
+
+  ~mapped_compressed_section ()
+  {
+    if (map_addr != NULL)
+      munmap (map_addr, map_len);
+  }
+
+  DISABLE_COPY_AND_ASSIGN (mapped_compressed_section);
+
+  /* Map the compressed data of SECTP and allocate the buffer for its
+     decompressed data.  Return false if the section is not compressed
+     or its data cannot be mapped.  */
+  bool map ();
+
+  /* Decompress the section into OUTPUT.  This does not call into BFD
+     or throw, so it can be called from a worker thread.  */
+  void decompress ();
+
+  /* Release the pages of the mapping before NEXT_IN, which the
+     decompressor is done with.  RELEASED is the start of the pages
+     not yet released.  */
+  void release_input (const gdb_byte *next_in, gdb_byte **released);
+
+  /* Hand the decompressed data over to the section descriptor, and
+     return true, or return false if decompression failed.  */
+  bool install ();
+
+  asection *sectp;
+
+  /* The compressed data, without the compression header, and whether
+     it is compressed with zstd rather than zlib.  */
+  const gdb_byte *input = nullptr;
+  bool is_zstd = false;
+  bfd_size_type input_size = 0;
+
+  /* The mapping of the compressed data.  */
+  void *map_addr = nullptr;
+  bfd_size_type map_len = 0;
+
+  /* The decompressed data, and whether decompressing it succeeded.  */
+  gdb::unique_xmalloc_ptr<gdb_byte> output;
+  bool decompressed = false;
+};
+
+bool
+mapped_compressed_section::map ()
+{
+  bfd *abfd = sectp->owner;
+
+  /* BFD sets up the sections to be decompressed when they are read;
+     do not handle the ones it has already read.  */
+  if (sectp->compress_status != DECOMPRESS_SECTION_SIZED
+      || (abfd->flags & BFD_IN_MEMORY) != 0
+      || bfd_section_size (sectp) == 0)
+    return false;
+
+  /* A SHF_COMPRESSED section starts with an ELF compression header,
+     and a .zdebug section with "ZLIB" and the 8-byte size.  */
+  bfd_size_type header_size = bfd_get_compression_header_size (abfd, sectp);
+  if (header_size == 0)
+    header_size = 12;
+  if (sectp->compressed_size <= header_size)
+    return false;
+
+  void *data = bfd_mmap (abfd, 0, sectp->compressed_size, PROT_READ,
+			 MAP_PRIVATE, sectp->filepos, &map_addr, &map_len);
+  if ((caddr_t) data == MAP_FAILED)
+    {
+      map_addr = NULL;
+      return false;
+    }
+
+  /* The ELF compression header starts with ch_type in both its 32-bit
+     and 64-bit forms.  */
+  if (header_size != 12)
+    {
+      unsigned int ch_type = bfd_get_32 (abfd, (bfd_byte *) data);
+
+      if (ch_type == ELFCOMPRESS_ZSTD)
+	{
+#ifdef HAVE_ZSTD
+	  is_zstd = true;
+#else
+	  return false;
+#endif
+	}
+      else if (ch_type != ELFCOMPRESS_ZLIB)
+	return false;
+    }
+
+#ifdef HAVE_POSIX_MADVISE
+  posix_madvise (map_addr, map_len, POSIX_MADV_SEQUENTIAL);
+#endif
+
+  input = (const gdb_byte *) data + header_size;
+  input_size = sectp->compressed_size - header_size;
+  output.reset ((gdb_byte *) xmalloc (bfd_section_size (sectp)));
+  return true;
+}
+
+void
+mapped_compressed_section::release_input (const gdb_byte *next_in,
+					  gdb_byte **released)
+{
+#ifdef MADV_DONTNEED
+  /* This runs in worker threads; a function-local static is
+     initialized only once, safely.  */
+  static const uintptr_t pagesize_m1 = getpagesize () - 1;
+
+  gdb_byte *consumed = (gdb_byte *) ((uintptr_t) next_in & ~pagesize_m1);
+  if (consumed > *released)
+    {
+      madvise (*released, consumed - *released, MADV_DONTNEED);
+      *released = consumed;
+    }
+#endif
+}
+
+void
+mapped_compressed_section::decompress ()
+{
+  bfd_size_type output_size = bfd_section_size (sectp);
+  gdb_byte *released = (gdb_byte *) map_addr;
+
+#ifdef HAVE_ZSTD
+  if (is_zstd)
+    {
+      ZSTD_DStream *dstream = ZSTD_createDStream ();
+      if (dstream == NULL)
+	return;
+
+      /* A zstd stream may hold several frames; ZSTD_decompressStream
+	 moves on to the next one by itself.  */
+      ZSTD_inBuffer in = { input, 0, 0 };
+      ZSTD_outBuffer out = { output.get (), 0, 0 };
+      size_t ret = 0;
+      while (out.pos < output_size)
+	{
+	  if (in.pos == in.size && in.size < input_size)
+	    in.size = std::min (input_size, in.size + DECOMPRESS_CHUNK_SIZE);
+	  out.size = std::min (output_size, out.pos + DECOMPRESS_CHUNK_SIZE);
+
+	  size_t out_pos = out.pos;
+	  ret = ZSTD_decompressStream (dstream, &out, &in);
+	  if (ZSTD_isError (ret)
+	      || (out.pos == out_pos && in.pos == input_size))
+	    break;
+
+	  release_input (input + in.pos, &released);
+	}
+
+      ZSTD_freeDStream (dstream);
+      decompressed = !ZSTD_isError (ret) && out.pos == output_size;
+      return;
+    }
+#endif
+
+  z_stream strm;
+  memset (&strm, 0, sizeof (strm));
+  if (inflateInit (&strm) != Z_OK)
+    return;
+
+  /* Like BFD, accept several zlib streams concatenated together.  */
+  bfd_size_type in_pos = 0, out_pos = 0;
+  int status = Z_OK;
+  while (out_pos < output_size)
+    {
+      if (strm.avail_in == 0)
+	{
+	  if (in_pos == input_size)
+	    break;
+	  bfd_size_type n = std::min (input_size - in_pos,
+				      (bfd_size_type) DECOMPRESS_CHUNK_SIZE);
+	  strm.next_in = (Bytef *) input + in_pos;
+	  strm.avail_in = n;
+	  in_pos += n;
+	}
+      bfd_size_type n = std::min (output_size - out_pos,
+				  (bfd_size_type) DECOMPRESS_CHUNK_SIZE);
+      strm.next_out = output.get () + out_pos;
+      strm.avail_out = n;
+
+      status = inflate (&strm, Z_NO_FLUSH);
+      out_pos += n - strm.avail_out;
+      if (status == Z_STREAM_END)
+	status = inflateReset (&strm);
+      if (status != Z_OK)
+	break;
+
+      release_input (strm.next_in, &released);
+    }
+
+  inflateEnd (&strm);
+  decompressed = status == Z_OK && out_pos == output_size;
+}
+
+bool
+mapped_compressed_section::install ()
+{
+  if (!decompressed)
+    return false;
+
+  struct gdb_bfd_section_data *descriptor = get_section_descriptor (sectp);
+  descriptor->size = bfd_section_size (sectp);
+  descriptor->data = output.release ();
+  GDB_BFD_DATA_ACCESSOR (sectp->owner)->copied_bytes += descriptor->size;
+  return true;
+}
+
+#endif /* HAVE_MMAP */
+
+/* See gdb_bfd.h.  */
+
+void
+gdb_bfd_decompress_sections (gdb::array_view<asection *const> sections)
+{
+#ifdef HAVE_MMAP
+  std::vector<std::unique_ptr<mapped_compressed_section>> compressed;
+
+  for (asection *sectp : sections)
+    {
+      gdb_assert ((sectp->flags & SEC_RELOC) == 0);
+
+      if (get_section_descriptor (sectp)->data != NULL)
+	continue;
+
+      std::unique_ptr<mapped_compressed_section> section
+	(new mapped_compressed_section (sectp));
+      if (section->map ())
+	compressed.push_back (std::move (section));
+    }
+
+  /* Give the largest sections to the worker threads first, and
+     decompress the smallest one in this thread.  */
+  std::sort (compressed.begin (), compressed.end (),
+	     [] (const std::unique_ptr<mapped_compressed_section> &a,
+		 const std::unique_ptr<mapped_compressed_section> &b)
+	     {
+	       return a->input_size > b->input_size;
+	     });
+
+  std::vector<std::future<void>> futures;
+  for (size_t i = 0; i + 1 < compressed.size (); i++)
+    {
+      mapped_compressed_section *section = compressed[i].get ();
+      futures.push_back (gdb::thread_pool::g_thread_pool->post_task
+			 ([=] ()
+			  {
+			    section->decompress ();
+			  }));
+    }
+  if (!compressed.empty ())
+    compressed.back ()->decompress ();
+  for (std::future<void> &future : futures)
+    future.wait ();
+
+  /* Sections that failed are left to gdb_bfd_map_section, which
+     warns about them.  */
+  for (const auto &section : compressed)
+    section->install ();
+#endif /* HAVE_MMAP */
+}
+
 /* See gdb_bfd.h.  */
 
 const gdb_byte *
@@ -666,7 +971,7 @@ gdb_bfd_map_section (asection *sectp, bfd_size_type *size)
     goto done;
 
 #ifdef HAVE_MMAP
-  if (!bfd_is_section_compressed (abfd, sectp))
+  if (bfd_mmap_sections && !bfd_is_section_compressed (abfd, sectp))
     {
       /* The page size, used when mmapping.  */
       static int pagesize;
@@ -674,14 +979,19 @@ gdb_bfd_map_section (asection *sectp, bfd_size_type *size)
       if (pagesize == 0)
 	pagesize = getpagesize ();
 
-      /* Only try to mmap sections which are large enough: we don't want
-	 to waste space due to fragmentation.  */
+      /* Map every section of at least a page.  A smaller one would
+	 take a whole page of address space and a mapping of its own,
+	 and the number of mappings of a process is limited.
+
+	 The mapping is shared: its pages are those of the page cache,
+	 so every GDB reading the same file, and the inferiors running
+	 it, use the same memory.  Nothing is ever written to it.  */
 
-      if (bfd_section_size (sectp) > 4 * pagesize)
+      if (bfd_section_size (sectp) >= pagesize)
 	{
 	  descriptor->size = bfd_section_size (sectp);
 	  descriptor->data = bfd_mmap (abfd, 0, descriptor->size, PROT_READ,
-				       MAP_PRIVATE, sectp->filepos,
+				       MAP_SHARED, sectp->filepos,
 				       &descriptor->map_addr,
 				       &descriptor->map_len);
 
@@ -691,6 +1001,7 @@ gdb_bfd_map_section (asection *sectp, bfd_size_type *size)
 	      posix_madvise (descriptor->map_addr, descriptor->map_len,
 			     POSIX_MADV_WILLNEED);
 #endif
+	      GDB_BFD_DATA_ACCESSOR (abfd)->mapped_bytes += descriptor->size;
 	      goto done;
 	    }
 
@@ -700,8 +1011,21 @@ gdb_bfd_map_section (asection *sectp, bfd_size_type *size)
     }
 #endif /* HAVE_MMAP */
 
-  /* Handle compressed sections, or ordinary uncompressed sections in
-     the no-mmap case.  */
+#ifdef HAVE_MMAP
+  {
+    mapped_compressed_section section (sectp);
+
+    if (section.map ())
+      {
+	section.decompress ();
+	if (section.install ())
+	  goto done;
+      }
+  }
+#endif /* HAVE_MMAP */
+
+  /* Handle compressed sections that could not be mapped, or ordinary
+     uncompressed sections in the no-mmap case.  */
 
   descriptor->size = bfd_section_size (sectp);
   descriptor->data = NULL;
@@ -718,6 +1042,7 @@ gdb_bfd_map_section (asection *sectp, bfd_size_type *size)
       return NULL;
     }
   descriptor->data = data;
+  GDB_BFD_DATA_ACCESSOR (abfd)->copied_bytes += descriptor->size;
 
  done:
   gdb_assert (descriptor->data != NULL);
@@ -960,6 +1285,8 @@ print_one_bfd (void **slot, void *data)
   ui_out_emit_tuple tuple_emitter (uiout, NULL);
   uiout->field_signed ("refcount", gdata->refc);
   uiout->field_string ("addr", host_address_to_string (abfd));
+  uiout->field_string ("mapped", pulongest (gdata->mapped_bytes));
+  uiout->field_string ("copied", pulongest (gdata->copied_bytes));
   uiout->field_string ("filename", bfd_get_filename (abfd));
   uiout->text ("\n");
 
@@ -973,9 +1300,11 @@ maintenance_info_bfds (const char *arg, int from_tty)
 {
   struct ui_out *uiout = current_uiout;
 
-  ui_out_emit_table table_emitter (uiout, 3, -1, "bfds");
+  ui_out_emit_table table_emitter (uiout, 5, -1, "bfds");
   uiout->table_header (10, ui_left, "refcount", "Refcount");
   uiout->table_header (18, ui_left, "addr", "Address");
+  uiout->table_header (12, ui_right, "mapped", "Mapped");
+  uiout->table_header (12, ui_right, "copied", "Copied");
   uiout->table_header (40, ui_left, "filename", "Filename");
 
   uiout->table_body ();
@@ -990,7 +1319,9 @@ _initialize_gdb_bfd ()
 				NULL, xcalloc, xfree);
 
   add_cmd ("bfds", class_maintenance, maintenance_info_bfds, _("\
-List the BFDs that are currently open."),
+List the BFDs that are currently open.\n\
+For each BFD, this shows how many bytes of section contents were\n\
+mapped from the file and how many were copied into memory."),
 	   &maintenanceinfolist);
 
   add_setshow_boolean_cmd ("bfd-sharing", no_class,
@@ -1005,6 +1336,19 @@ filename, file size, file modification time, and file inode."),
 			   &maintenance_set_cmdlist,
 			   &maintenance_show_cmdlist);
 
+  add_setshow_boolean_cmd ("bfd-mmap-sections", no_class,
+			   &bfd_mmap_sections, _("\
+Set whether gdb maps the sections of files into memory."), _("\
+Show whether gdb maps the sections of files into memory."), _("\
+When enabled gdb maps the uncompressed sections it reads, such as the\n\
+debug info sections, from the files, sharing their memory with the\n\
+other processes that use the same files.  When disabled gdb reads\n\
+them into memory of its own.  This only affects sections read later."),
+			   NULL,
+			   &show_bfd_mmap_sections,
+			   &maintenance_set_cmdlist,
+			   &maintenance_show_cmdlist);
+
   add_setshow_zuinteger_cmd ("bfd-cache", class_maintenance,
 			     &debug_bfd_cache, _("\
 Set bfd cache debugging."), _("\
@@ -21,6 +21,7 @@
 #define GDB_BFD_H
 
 #include "registry.h"
+#include "gdbsupport/array-view.h"
 #include "gdbsupport/byte-vector.h"
 #include "gdbsupport/gdb_ref_ptr.h"
 
@@ -119,6 +120,12 @@ void gdb_bfd_record_inclusion (bfd *includer, bfd *includee);
 
 const gdb_byte *gdb_bfd_map_section (asection *section, bfd_size_type *size);
 
+/* Decompress the compressed sections among SECTIONS that have not been
+   read yet, in parallel.  Their data is then returned by
+   gdb_bfd_map_section.  SECTIONS may not have relocations.  */
+
+void gdb_bfd_decompress_sections (gdb::array_view<asection *const> sections);
+
 /* Compute the CRC for ABFD.  The CRC is used to find and verify
    separate debug files.  When successful, this fills in *CRC_OUT and
    returns 1.  Otherwise, this issues a warning and returns 0.  */
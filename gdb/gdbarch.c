@@ -258,6 +258,7 @@ struct gdbarch
   gdbarch_skip_solib_resolver_ftype *skip_solib_resolver;
   gdbarch_in_solib_return_trampoline_ftype *in_solib_return_trampoline;
   gdbarch_in_indirect_branch_thunk_ftype *in_indirect_branch_thunk;
+  gdbarch_call_preserved_register_p_ftype *call_preserved_register_p;
   gdbarch_stack_frame_destroyed_p_ftype *stack_frame_destroyed_p;
   gdbarch_elf_make_msymbol_special_ftype *elf_make_msymbol_special;
   gdbarch_coff_make_msymbol_special_ftype *coff_make_msymbol_special;
@@ -431,6 +432,7 @@ gdbarch_alloc (const struct gdbarch_info *info,
   gdbarch->skip_solib_resolver = generic_skip_solib_resolver;
   gdbarch->in_solib_return_trampoline = generic_in_solib_return_trampoline;
   gdbarch->in_indirect_branch_thunk = default_in_indirect_branch_thunk;
+  gdbarch->call_preserved_register_p = default_call_preserved_register_p;
   gdbarch->stack_frame_destroyed_p = generic_stack_frame_destroyed_p;
   gdbarch->coff_make_msymbol_special = default_coff_make_msymbol_special;
   gdbarch->make_symbol_special = default_make_symbol_special;
@@ -622,6 +624,7 @@ verify_gdbarch (struct gdbarch *gdbarch)
   /* Skip verify of skip_solib_resolver, invalid_p == 0 */
   /* Skip verify of in_solib_return_trampoline, invalid_p == 0 */
   /* Skip verify of in_indirect_branch_thunk, invalid_p == 0 */
+  /* Skip verify of call_preserved_register_p, invalid_p == 0 */
   /* Skip verify of stack_frame_destroyed_p, invalid_p == 0 */
   /* Skip verify of elf_make_msymbol_special, has predicate.  */
   /* Skip verify of coff_make_msymbol_special, invalid_p == 0 */
@@ -822,6 +825,9 @@ gdbarch_dump (struct gdbarch *gdbarch, struct ui_file *file)
   fprintf_unfiltered (file,
                       "gdbarch_dump: call_dummy_location = %s\n",
                       plongest (gdbarch->call_dummy_location));
+  fprintf_unfiltered (file,
+                      "gdbarch_dump: call_preserved_register_p = <%s>\n",
+                      host_address_to_string (gdbarch->call_preserved_register_p));
   fprintf_unfiltered (file,
                       "gdbarch_dump: cannot_fetch_register = <%s>\n",
                       host_address_to_string (gdbarch->cannot_fetch_register));
@@ -3345,6 +3351,23 @@ set_gdbarch_in_indirect_branch_thunk (struct gdbarch *gdbarch,
   gdbarch->in_indirect_branch_thunk = in_indirect_branch_thunk;
 }
 
+int
+gdbarch_call_preserved_register_p (struct gdbarch *gdbarch, int regnum)
+{
+  gdb_assert (gdbarch != NULL);
+  gdb_assert (gdbarch->call_preserved_register_p != NULL);
+  if (gdbarch_debug >= 2)
+    fprintf_unfiltered (gdb_stdlog, "gdbarch_call_preserved_register_p called\n");
+  return gdbarch->call_preserved_register_p (gdbarch, regnum);
+}
+
+void
+set_gdbarch_call_preserved_register_p (struct gdbarch *gdbarch,
+                                       gdbarch_call_preserved_register_p_ftype call_preserved_register_p)
+{
+  gdbarch->call_preserved_register_p = call_preserved_register_p;
+}
+
 int
 gdbarch_stack_frame_destroyed_p (struct gdbarch *gdbarch, CORE_ADDR addr)
 {
@@ -767,6 +767,17 @@ typedef bool (gdbarch_in_indirect_branch_thunk_ftype) (struct gdbarch *gdbarch,
 extern bool gdbarch_in_indirect_branch_thunk (struct gdbarch *gdbarch, CORE_ADDR pc);
 extern void set_gdbarch_in_indirect_branch_thunk (struct gdbarch *gdbarch, gdbarch_in_indirect_branch_thunk_ftype *in_indirect_branch_thunk);
 
+/* Return true if the ABI requires register REGNUM to be preserved
+   across function calls, or if REGNUM is the stack pointer or the
+   program counter.  In frames other than the innermost one, the value
+   of the other registers is meaningless, and so can't affect how the
+   outer frames are unwound.  The default conservatively returns true
+   for all registers. */
+
+typedef int (gdbarch_call_preserved_register_p_ftype) (struct gdbarch *gdbarch, int regnum);
+extern int gdbarch_call_preserved_register_p (struct gdbarch *gdbarch, int regnum);
+extern void set_gdbarch_call_preserved_register_p (struct gdbarch *gdbarch, gdbarch_call_preserved_register_p_ftype *call_preserved_register_p);
+
 /* A target might have problems with watchpoints as soon as the stack
    frame of the current function has been destroyed.  This mostly happens
    as the first action in a function's epilogue.  stack_frame_destroyed_p()
@@ -640,6 +640,14 @@ m;int;in_solib_return_trampoline;CORE_ADDR pc, const char *name;pc, name;;generi
 # Return true if PC lies inside an indirect branch thunk.
 m;bool;in_indirect_branch_thunk;CORE_ADDR pc;pc;;default_in_indirect_branch_thunk;;0
 
+# Return true if the ABI requires register REGNUM to be preserved
+# across function calls, or if REGNUM is the stack pointer or the
+# program counter.  In frames other than the innermost one, the value
+# of the other registers is meaningless, and so can't affect how the
+# outer frames are unwound.  The default conservatively returns true
+# for all registers.
+m;int;call_preserved_register_p;int regnum;regnum;;default_call_preserved_register_p;;0
+
 # A target might have problems with watchpoints as soon as the stack
 # frame of the current function has been destroyed.  This mostly happens
 # as the first action in a function's epilogue.  stack_frame_destroyed_p()
@@ -4454,6 +4454,25 @@ i386_in_indirect_branch_thunk (struct gdbarch *gdbarch, CORE_ADDR pc)
 				       I386_EAX_REGNUM, I386_EIP_REGNUM);
 }
 
+/* Implement the "call_preserved_register_p" gdbarch method.  */
+
+static int
+i386_call_preserved_register_p (struct gdbarch *gdbarch, int regnum)
+{
+  switch (regnum)
+    {
+    case I386_EBX_REGNUM:
+    case I386_ESP_REGNUM:
+    case I386_EBP_REGNUM:
+    case I386_ESI_REGNUM:
+    case I386_EDI_REGNUM:
+    case I386_EIP_REGNUM:
+      return 1;
+    default:
+      return 0;
+    }
+}
+
 /* Generic ELF.  */
 
 void
@@ -4485,6 +4504,9 @@ i386_elf_init_abi (struct gdbarch_info info, struct gdbarch *gdbarch)
 
   set_gdbarch_in_indirect_branch_thunk (gdbarch,
 					i386_in_indirect_branch_thunk);
+
+  set_gdbarch_call_preserved_register_p (gdbarch,
+					 i386_call_preserved_register_p);
 }
 
 /* System V Release 4 (SVR4).  */
@@ -5175,7 +5175,7 @@ handle_inferior_event (struct execution_control_state *ecs)
   adjust_pc_after_break (ecs->event_thread, &ecs->ws);
 
   /* Dependent on the current PC value modified by adjust_pc_after_break.  */
-  reinit_frame_cache ();
+  reinit_frame_cache_retaining ();
 
   breakpoint_retire_moribund ();
 
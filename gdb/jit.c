@@ -37,11 +37,13 @@
 #include "symtab.h"
 #include "target.h"
 #include "gdbsupport/gdb-dlfcn.h"
+#include "gdbsupport/scope-exit.h"
 #include <sys/stat.h>
 #include "gdb_bfd.h"
 #include "readline/tilde.h"
 #include "completer.h"
 #include <forward_list>
+#include <unordered_map>
 
 static std::string jit_reader_dir;
 
@@ -71,6 +73,19 @@ show_jit_debug (struct ui_file *file, int from_tty,
   fprintf_filtered (file, _("JIT debugging is %s.\n"), value);
 }
 
+/* True if a JIT registration event registers all the new code entries
+   linked to the announced one.  */
+
+static bool jit_batch_registration = false;
+
+static void
+show_jit_batch_registration (struct ui_file *file, int from_tty,
+			     struct cmd_list_element *c, const char *value)
+{
+  fprintf_filtered (file, _("Batched JIT code registration is %s.\n"),
+		    value);
+}
+
 struct target_buffer
 {
   CORE_ADDR base;
@@ -261,6 +276,13 @@ struct jit_program_space_data
      set.  */
 
   struct breakpoint *jit_breakpoint = nullptr;
+
+  /* The objfiles created for JIT code, indexed by the address of
+     their struct jit_code_entry in the inferior.  The entries whose
+     symbol file could not be read map to nullptr, so that they are
+     only tried once.  */
+
+  std::unordered_map<CORE_ADDR, struct objfile *> entry_objfiles;
 };
 
 static program_space_key<jit_program_space_data> jit_program_space_key;
@@ -312,6 +334,12 @@ add_objfile_entry (struct objfile *objfile, CORE_ADDR entry)
 
   objf_data = get_jit_objfile_data (objfile);
   objf_data->addr = entry;
+
+  struct jit_program_space_data *ps_data
+    = jit_program_space_key.get (objfile->pspace);
+  if (ps_data == NULL)
+    ps_data = jit_program_space_key.emplace (objfile->pspace);
+  ps_data->entry_objfiles[entry] = objfile;
 }
 
 /* Return jit_program_space_data for current program space.  Allocate
@@ -817,12 +845,14 @@ jit_reader_try_read_symtab (struct jit_code_entry *code_entry,
 }
 
 /* Try to read CODE_ENTRY using BFD.  ENTRY_ADDR is the address of the
-   struct jit_code_entry in the inferior address space.  */
+   struct jit_code_entry in the inferior address space.  ADD_FLAGS is
+   passed to symbol_file_add_from_bfd.  */
 
 static void
 jit_bfd_try_read_symtab (struct jit_code_entry *code_entry,
 			 CORE_ADDR entry_addr,
-			 struct gdbarch *gdbarch)
+			 struct gdbarch *gdbarch,
+			 symfile_add_flags add_flags)
 {
   struct bfd_section *sec;
   struct objfile *objfile;
@@ -877,8 +907,8 @@ JITed symbol file is not an object file, ignoring it.\n"));
 
   /* This call does not take ownership of SAI.  */
   objfile = symbol_file_add_from_bfd (nbfd.get (),
-				      bfd_get_filename (nbfd.get ()), 0,
-				      &sai,
+				      bfd_get_filename (nbfd.get ()),
+				      add_flags, &sai,
 				      OBJF_SHARED | OBJF_NOT_FILENAME, NULL);
 
   add_objfile_entry (objfile, entry_addr);
@@ -887,11 +917,13 @@ JITed symbol file is not an object file, ignoring it.\n"));
 /* This function registers code associated with a JIT code entry.  It uses the
    pointer and size pair in the entry to read the symbol file from the remote
    and then calls symbol_file_add_from_local_memory to add it as though it were
-   a symbol file added by the user.  */
+   a symbol file added by the user.  ADD_FLAGS is passed to
+   symbol_file_add_from_bfd if the symbol file is read using BFD.  */
 
 static void
 jit_register_code (struct gdbarch *gdbarch,
-		   CORE_ADDR entry_addr, struct jit_code_entry *code_entry)
+		   CORE_ADDR entry_addr, struct jit_code_entry *code_entry,
+		   symfile_add_flags add_flags = 0)
 {
   int success;
 
@@ -905,7 +937,12 @@ jit_register_code (struct gdbarch *gdbarch,
   success = jit_reader_try_read_symtab (code_entry, entry_addr);
 
   if (!success)
-    jit_bfd_try_read_symtab (code_entry, entry_addr, gdbarch);
+    jit_bfd_try_read_symtab (code_entry, entry_addr, gdbarch, add_flags);
+
+  /* If no objfile was created, record the failure, so that later JIT
+     events skip this entry instead of reading it and warning again.  */
+  get_jit_program_space_data ()->entry_objfiles.emplace (entry_addr,
+							 nullptr);
 }
 
 /* Look up the objfile with this code entry address.  */
@@ -913,16 +950,83 @@ jit_register_code (struct gdbarch *gdbarch,
 static struct objfile *
 jit_find_objf_with_entry_addr (CORE_ADDR entry_addr)
 {
-  for (objfile *objf : current_program_space->objfiles ())
+  struct jit_program_space_data *ps_data
+    = jit_program_space_key.get (current_program_space);
+  if (ps_data == NULL)
+    return NULL;
+
+  auto iter = ps_data->entry_objfiles.find (entry_addr);
+  if (iter == ps_data->entry_objfiles.end ())
+    return NULL;
+  return iter->second;
+}
+
+/* Return true if the code entry at ENTRY_ADDR was registered, whether
+   or not an objfile could be created for it.  */
+
+static bool
+jit_entry_registered_p (CORE_ADDR entry_addr)
+{
+  struct jit_program_space_data *ps_data
+    = jit_program_space_key.get (current_program_space);
+  return (ps_data != NULL
+	  && ps_data->entry_objfiles.find (entry_addr)
+	     != ps_data->entry_objfiles.end ());
+}
+
+/* Register the code entry at ENTRY_ADDR, which the inferior has just
+   announced, together with all the entries linked to it that are not
+   registered yet.  This lets a JIT compiler add many entries to the
+   list and notify GDB only once.  The objfiles of the entries only get
+   their minimal symbols until their debug info is needed, and the
+   breakpoints are re-set once for all of them.  */
+
+static void
+jit_register_code_batch (struct gdbarch *gdbarch, CORE_ADDR entry_addr)
+{
+  std::vector<std::pair<CORE_ADDR, jit_code_entry>> batch;
+  struct jit_code_entry code_entry;
+
+  jit_read_code_entry (gdbarch, entry_addr, &code_entry);
+
+  /* The JIT compiler can either prepend or append the new entries, so
+     walk the list in both directions from ENTRY_ADDR, up to the
+     entries that are already registered.  */
+  for (CORE_ADDR addr = code_entry.prev_entry;
+       addr != 0 && !jit_entry_registered_p (addr);
+       addr = batch.back ().second.prev_entry)
     {
-      struct jit_objfile_data *objf_data;
+      batch.emplace_back (addr, jit_code_entry ());
+      jit_read_code_entry (gdbarch, addr, &batch.back ().second);
+    }
+  std::reverse (batch.begin (), batch.end ());
 
-      objf_data
-	= (struct jit_objfile_data *) objfile_data (objf, jit_objfile_data);
-      if (objf_data != NULL && objf_data->addr == entry_addr)
-	return objf;
+  if (!jit_entry_registered_p (entry_addr))
+    batch.emplace_back (entry_addr, code_entry);
+
+  for (CORE_ADDR addr = code_entry.next_entry;
+       addr != 0 && !jit_entry_registered_p (addr);
+       addr = batch.back ().second.next_entry)
+    {
+      batch.emplace_back (addr, jit_code_entry ());
+      jit_read_code_entry (gdbarch, addr, &batch.back ().second);
     }
-  return NULL;
+
+  if (jit_debug)
+    fprintf_unfiltered (gdb_stdlog,
+			"jit_register_code_batch, %s entries\n",
+			pulongest (batch.size ()));
+
+  if (batch.empty ())
+    return;
+
+  /* Re-set the breakpoints once for the whole batch, including the
+     entries registered before an error.  */
+  SCOPE_EXIT { breakpoint_re_set (); };
+
+  for (auto &entry : batch)
+    jit_register_code (gdbarch, entry.first, &entry.second,
+		       SYMFILE_DEFER_BP_RESET | SYMFILE_NO_READ);
 }
 
 /* This is called when a breakpoint is deleted.  It updates the
@@ -1279,7 +1383,7 @@ jit_inferior_init (struct gdbarch *gdbarch)
 
       /* This hook may be called many times during setup, so make sure we don't
 	 add the same symbol file twice.  */
-      if (jit_find_objf_with_entry_addr (cur_entry_addr) != NULL)
+      if (jit_entry_registered_p (cur_entry_addr))
 	continue;
 
       jit_register_code (gdbarch, cur_entry_addr, &cur_entry);
@@ -1327,6 +1431,12 @@ jit_inferior_exit_hook (struct inferior *inf)
       if (objf_data != NULL && objf_data->addr != 0)
 	objf->unlink ();
     }
+
+  /* Forget the entries that had no objfile too.  */
+  struct jit_program_space_data *ps_data
+    = jit_program_space_key.get (current_program_space);
+  if (ps_data != NULL)
+    ps_data->entry_objfiles.clear ();
 }
 
 void
@@ -1349,17 +1459,24 @@ jit_event_handler (struct gdbarch *gdbarch)
     case JIT_NOACTION:
       break;
     case JIT_REGISTER:
-      jit_read_code_entry (gdbarch, entry_addr, &code_entry);
-      jit_register_code (gdbarch, entry_addr, &code_entry);
+      if (jit_batch_registration)
+	jit_register_code_batch (gdbarch, entry_addr);
+      else
+	{
+	  jit_read_code_entry (gdbarch, entry_addr, &code_entry);
+	  jit_register_code (gdbarch, entry_addr, &code_entry);
+	}
       break;
     case JIT_UNREGISTER:
       objf = jit_find_objf_with_entry_addr (entry_addr);
-      if (objf == NULL)
+      if (objf != NULL)
+	objf->unlink ();
+      else if (jit_entry_registered_p (entry_addr))
+	get_jit_program_space_data ()->entry_objfiles.erase (entry_addr);
+      else
 	printf_unfiltered (_("Unable to find JITed code "
 			     "entry at address: %s\n"),
 			   paddress (gdbarch, entry_addr));
-      else
-	objf->unlink ();
 
       break;
     default:
@@ -1389,6 +1506,20 @@ free_objfile_data (struct objfile *objfile, void *data)
 	}
     }
 
+  if (objf_data->addr != 0)
+    {
+      struct jit_program_space_data *ps_data;
+
+      ps_data = jit_program_space_key.get (objfile->pspace);
+      if (ps_data != NULL)
+	{
+	  auto iter = ps_data->entry_objfiles.find (objf_data->addr);
+	  if (iter != ps_data->entry_objfiles.end ()
+	      && iter->second == objfile)
+	    ps_data->entry_objfiles.erase (iter);
+	}
+    }
+
   xfree (data);
 }
 
@@ -1420,6 +1551,19 @@ _initialize_jit ()
 			     show_jit_debug,
 			     &setdebuglist, &showdebuglist);
 
+  add_setshow_boolean_cmd ("jit-batch-registration", class_support,
+			   &jit_batch_registration, _("\
+Set whether JIT code registrations are processed in batches."), _("\
+Show whether JIT code registrations are processed in batches."), _("\
+When on, each registration event from a JIT compiler also registers\n\
+the code entries linked to the announced one that GDB does not know\n\
+yet, so that a JIT compiler can add many entries and notify GDB once.\n\
+The debug info of those entries is read only when it is needed, and\n\
+breakpoints are re-set once per event."),
+			   NULL,
+			   show_jit_batch_registration,
+			   &setlist, &showlist);
+
   gdb::observers::inferior_created.attach (jit_inferior_created);
   gdb::observers::inferior_exit.attach (jit_inferior_exit_hook);
   gdb::observers::breakpoint_deleted.attach (jit_breakpoint_deleted);
@@ -68,6 +68,10 @@
 #include "gdbsupport/fileio.h"
 #include "gdbsupport/scope-exit.h"
 #include "gdbsupport/gdb-sigmask.h"
+#include "gdbsupport/scoped_fd.h"
+#include <sys/uio.h>
+#include <limits.h>
+#include <atomic>
 
 /* This comment documents high-level logic of this file.
 
@@ -4018,6 +4022,239 @@ linux_proc_xfer_partial (enum target_object object,
     }
 }
 
+/* The concurrent_memory_reader of the native Linux target.  It reads
+   with process_vm_readv, in one system call for all the runs of pages
+   of a request, or from /proc/PID/mem if that is not available.  The
+   pages of private anonymous mappings that /proc/PID/pagemap reports
+   as neither present nor swapped out have never been written to, so
+   they are cleared without being read.  */
+
+class linux_concurrent_memory_reader : public concurrent_memory_reader
+{
+public:
+
+  explicit linux_concurrent_memory_reader (int pid);
+
+  bool read (CORE_ADDR memaddr, gdb_byte *myaddr, size_t len) override;
+
+private:
+
+  /* Return true if the page at ADDR is known never to have been
+     populated.  PAGEMAP_ENTRY is its entry in /proc/PID/pagemap.  */
+  bool unpopulated_p (CORE_ADDR addr, uint64_t pagemap_entry) const;
+
+  /* Read the LEN bytes at MEMADDR into MYADDR from /proc/PID/mem.  */
+  bool read_proc_mem (CORE_ADDR memaddr, gdb_byte *myaddr, size_t len);
+
+  /* The process.  */
+  int m_pid;
+
+  /* The page size.  */
+  size_t m_page_size;
+
+  /* /proc/PID/mem and /proc/PID/pagemap.  */
+  scoped_fd m_mem_fd;
+  scoped_fd m_pagemap_fd;
+
+  /* The private anonymous mappings of the process, sorted by
+     address.  */
+  std::vector<std::pair<CORE_ADDR, CORE_ADDR>> m_anon_mappings;
+
+  /* Whether process_vm_readv works.  */
+  std::atomic<bool> m_use_process_vm_readv {true};
+};
+
+linux_concurrent_memory_reader::linux_concurrent_memory_reader (int pid)
+  : m_pid (pid),
+    m_page_size (sysconf (_SC_PAGESIZE))
+{
+  char filename[64];
+
+  xsnprintf (filename, sizeof filename, "/proc/%d/mem", pid);
+  m_mem_fd = scoped_fd (gdb_open_cloexec (filename, O_RDONLY | O_LARGEFILE,
+					  0));
+
+  xsnprintf (filename, sizeof filename, "/proc/%d/pagemap", pid);
+  m_pagemap_fd = scoped_fd (gdb_open_cloexec (filename,
+					      O_RDONLY | O_LARGEFILE, 0));
+
+  xsnprintf (filename, sizeof filename, "/proc/%d/maps", pid);
+  gdb::unique_xmalloc_ptr<char> maps
+    = target_fileio_read_stralloc (NULL, filename);
+  if (maps == NULL)
+    return;
+
+  char *saveptr;
+  for (char *line = strtok_r (maps.get (), "\n", &saveptr);
+       line != NULL;
+       line = strtok_r (NULL, "\n", &saveptr))
+    {
+      /* Each line is "START-END PERMISSIONS OFFSET DEVICE INODE
+	 [FILENAME]".  */
+      const char *p = line;
+      ULONGEST start = strtoulst (p, &p, 16);
+      if (*p != '-')
+	continue;
+      ULONGEST end = strtoulst (p + 1, &p, 16);
+      const char *permissions = skip_spaces (p);
+      p = skip_spaces (skip_to_space (permissions));
+      p = skip_spaces (skip_to_space (p));
+      p = skip_spaces (skip_to_space (p));
+      ULONGEST inode = strtoulst (p, &p, 10);
+      const char *filename_p = skip_spaces (p);
+
+      if (inode == 0 && strlen (permissions) >= 4 && permissions[3] == 'p'
+	  && (*filename_p == '\0'
+	      || strcmp (filename_p, "[heap]") == 0
+	      || startswith (filename_p, "[stack")))
+	m_anon_mappings.emplace_back (start, end);
+    }
+}
+
+bool
+linux_concurrent_memory_reader::unpopulated_p (CORE_ADDR addr,
+					       uint64_t pagemap_entry) const
+{
+  /* Bit 63 is "page present", bit 62 "page swapped".  */
+  if ((pagemap_entry & (UINT64_C (3) << 62)) != 0)
+    return false;
+
+  auto iter = std::upper_bound (m_anon_mappings.begin (),
+				m_anon_mappings.end (), addr,
+				[] (CORE_ADDR a,
+				    const std::pair<CORE_ADDR, CORE_ADDR> &m)
+				{
+				  return a < m.first;
+				});
+  if (iter == m_anon_mappings.begin ())
+    return false;
+  --iter;
+  return addr >= iter->first && addr + m_page_size <= iter->second;
+}
+
+bool
+linux_concurrent_memory_reader::read_proc_mem (CORE_ADDR memaddr,
+					       gdb_byte *myaddr, size_t len)
+{
+  if (m_mem_fd.get () < 0)
+    return false;
+
+  while (len > 0)
+    {
+#ifdef HAVE_PREAD64
+      ssize_t ret = pread64 (m_mem_fd.get (), myaddr, len, memaddr);
+#else
+      ssize_t ret = pread (m_mem_fd.get (), myaddr, len, memaddr);
+#endif
+      if (ret <= 0)
+	return false;
+      memaddr += ret;
+      myaddr += ret;
+      len -= ret;
+    }
+
+  return true;
+}
+
+bool
+linux_concurrent_memory_reader::read (CORE_ADDR memaddr, gdb_byte *myaddr,
+				      size_t len)
+{
+  /* The runs of pages to read, as offsets and lengths from MEMADDR.  */
+  std::vector<std::pair<size_t, size_t>> runs;
+
+  if (m_pagemap_fd.get () >= 0 && !m_anon_mappings.empty ()
+      && memaddr % m_page_size == 0 && len % m_page_size == 0)
+    {
+      size_t num_pages = len / m_page_size;
+      std::vector<uint64_t> entries (num_pages);
+      size_t entries_len = num_pages * sizeof (uint64_t);
+      off_t entries_offset = memaddr / m_page_size * sizeof (uint64_t);
+
+      if (pread (m_pagemap_fd.get (), entries.data (), entries_len,
+		 entries_offset) != (ssize_t) entries_len)
+	runs.emplace_back (0, len);
+      else
+	for (size_t i = 0; i < num_pages; i++)
+	  {
+	    size_t offset = i * m_page_size;
+
+	    if (unpopulated_p (memaddr + offset, entries[i]))
+	      memset (myaddr + offset, 0, m_page_size);
+	    else if (!runs.empty ()
+		     && runs.back ().first + runs.back ().second == offset)
+	      runs.back ().second += m_page_size;
+	    else
+	      runs.emplace_back (offset, m_page_size);
+	  }
+    }
+  else
+    runs.emplace_back (0, len);
+
+#ifdef __NR_process_vm_readv
+  if (m_use_process_vm_readv)
+    {
+      std::vector<struct iovec> local (runs.size ());
+      std::vector<struct iovec> remote (runs.size ());
+
+      for (size_t i = 0; i < runs.size (); i++)
+	{
+	  local[i].iov_base = myaddr + runs[i].first;
+	  local[i].iov_len = runs[i].second;
+	  remote[i].iov_base = (void *) (uintptr_t) (memaddr + runs[i].first);
+	  remote[i].iov_len = runs[i].second;
+	}
+
+      /* RUNS has at most one entry per page of LEN, so its number of
+	 entries fits in IOV_MAX for the reads of gcore; split it
+	 anyway.  */
+      bool ok = true;
+      for (size_t i = 0; ok && i < runs.size (); i += IOV_MAX)
+	{
+	  size_t count = std::min (runs.size () - i, (size_t) IOV_MAX);
+	  ssize_t batch_len = 0;
+
+	  for (size_t j = i; j < i + count; j++)
+	    batch_len += runs[j].second;
+
+	  ssize_t ret = syscall (__NR_process_vm_readv, m_pid,
+				 &local[i], count, &remote[i], count, 0);
+	  if (ret == -1 && (errno == ENOSYS || errno == EPERM))
+	    {
+	      m_use_process_vm_readv = false;
+	      ok = false;
+	    }
+	  else if (ret != batch_len)
+	    ok = false;
+	}
+
+      if (ok)
+	return true;
+    }
+#endif
+
+  /* Some of the memory could not be read in one go; fall back to
+     /proc/PID/mem, which also reads what process_vm_readv cannot.  */
+  for (const std::pair<size_t, size_t> &run : runs)
+    if (!read_proc_mem (memaddr + run.first, myaddr + run.first,
+			run.second))
+      return false;
+
+  return true;
+}
+
+/* Implement the "make_concurrent_memory_reader" target method.  */
+
+std::unique_ptr<concurrent_memory_reader>
+linux_nat_target::make_concurrent_memory_reader ()
+{
+  if (inferior_ptid == null_ptid)
+    return NULL;
+
+  return std::unique_ptr<concurrent_memory_reader>
+    (new linux_concurrent_memory_reader (inferior_ptid.pid ()));
+}
+
 
 /* Parse LINE as a signal set and add its set bits to SIGS.  */
 
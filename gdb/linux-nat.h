@@ -129,6 +129,9 @@ class linux_nat_target : public inf_ptrace_target
 
   char *pid_to_exec_file (int pid) override;
 
+  std::unique_ptr<concurrent_memory_reader> make_concurrent_memory_reader ()
+    override;
+
   void post_startup_inferior (ptid_t) override;
 
   void post_attach (int) override;
@@ -22,6 +22,9 @@
 #include "symfile.h"
 #include "objfiles.h"
 #include "gdbcore.h"
+#include "build-id.h"
+#include "dwarf2/index-cache.h"
+#include "gdbsupport/thread-pool.h"
 #include <algorithm>
 
 #ifdef HAVE_LIBLZMA
@@ -71,6 +74,118 @@ struct gdb_lzma_stream
   gdb_byte *data;
 };
 
+/* Decode the block of TOTAL_SIZE bytes at COMPRESSED, header
+   included, into the UNCOMPRESSED_SIZE bytes at UNCOMPRESSED, using
+   ALLOCATOR.  Return false on failure.  */
+
+static bool
+lzma_decode_block (lzma_allocator *allocator, const gdb_byte *compressed,
+		   size_t total_size, gdb_byte *uncompressed,
+		   size_t uncompressed_size)
+{
+  lzma_filter filters[LZMA_FILTERS_MAX + 1];
+  lzma_block block;
+  size_t compressed_pos, uncompressed_pos;
+
+  memset (&block, 0, sizeof (block));
+  block.filters = filters;
+  block.header_size = lzma_block_header_size_decode (compressed[0]);
+  if (block.header_size > total_size
+      || lzma_block_header_decode (&block, allocator, compressed) != LZMA_OK)
+    return false;
+
+  compressed_pos = block.header_size;
+  uncompressed_pos = 0;
+  return (lzma_block_buffer_decode (&block, allocator,
+				    compressed, &compressed_pos, total_size,
+				    uncompressed, &uncompressed_pos,
+				    uncompressed_size)
+	  == LZMA_OK);
+}
+
+/* Decompress all the blocks of the stream of LSTREAM at once, those
+   after the first one in worker threads, and keep the whole object in
+   LSTREAM.  Return false on failure, leaving LSTREAM to decompress
+   the blocks as they are read.  */
+
+static bool
+lzma_decompress_all (struct gdb_lzma_stream *lstream)
+{
+  asection *section = lstream->section;
+  gdb::byte_vector compressed (bfd_section_size (section));
+
+  if (!bfd_get_section_contents (section->owner, section, compressed.data (),
+				 0, compressed.size ()))
+    return false;
+
+  /* A block to decompress, and whether that succeeded.  */
+  struct lzma_block_ref
+  {
+    const gdb_byte *compressed;
+    size_t total_size;
+    gdb_byte *uncompressed;
+    size_t uncompressed_size;
+    bool ok;
+  };
+
+  lzma_vli size = lzma_index_uncompressed_size (lstream->index);
+  gdb::unique_xmalloc_ptr<gdb_byte> data ((gdb_byte *) xmalloc (size));
+  std::vector<lzma_block_ref> blocks;
+  lzma_index_iter iter;
+
+  lzma_index_iter_init (&iter, lstream->index);
+  while (!lzma_index_iter_next (&iter, LZMA_INDEX_ITER_BLOCK))
+    {
+      if (iter.block.total_size == 0
+	  || iter.block.compressed_file_offset > compressed.size ()
+	  || (iter.block.total_size
+	      > compressed.size () - iter.block.compressed_file_offset)
+	  || iter.block.uncompressed_file_offset > size
+	  || (iter.block.uncompressed_size
+	      > size - iter.block.uncompressed_file_offset))
+	return false;
+
+      blocks.push_back ({ compressed.data () + iter.block.compressed_file_offset,
+			  (size_t) iter.block.total_size,
+			  data.get () + iter.block.uncompressed_file_offset,
+			  (size_t) iter.block.uncompressed_size,
+			  false });
+    }
+
+  /* The worker threads use liblzma's own allocator, which does not
+     throw.  */
+  auto decode = [] (lzma_block_ref *b)
+    {
+      b->ok = lzma_decode_block (nullptr, b->compressed, b->total_size,
+				 b->uncompressed, b->uncompressed_size);
+    };
+
+  std::vector<std::future<void>> futures;
+  for (size_t i = 1; i < blocks.size (); i++)
+    {
+      lzma_block_ref *b = &blocks[i];
+      futures.push_back (gdb::thread_pool::g_thread_pool->post_task
+			 ([=] ()
+			  {
+			    decode (b);
+			  }));
+    }
+  if (!blocks.empty ())
+    decode (&blocks[0]);
+  for (std::future<void> &future : futures)
+    future.wait ();
+
+  for (const lzma_block_ref &b : blocks)
+    if (!b.ok)
+      return false;
+
+  xfree (lstream->data);
+  lstream->data = data.release ();
+  lstream->data_start = 0;
+  lstream->data_end = size;
+  return true;
+}
+
 /* bfd_openr_iovec OPEN_P implementation for
    find_separate_debug_file_in_section.  OPEN_CLOSURE is 'asection *'
    of the section to decompress.
@@ -126,6 +241,23 @@ lzma_open (struct bfd *nbfd, void *open_closure)
   lstream->section = section;
   lstream->index = index;
 
+  /* GDB reads most of the object anyway, for its symbol table.  So if
+     the stream has several blocks, decompress them all now, in
+     parallel; and if the index cache is enabled, decompress the
+     object to store it there, so that the next GDB does not have
+     to.  */
+  if ((lzma_index_block_count (index) > 1 || global_index_cache.enabled ())
+      && lzma_decompress_all (lstream)
+      && global_index_cache.enabled ())
+    {
+      const bfd_build_id *build_id = build_id_bfd_get (section->owner);
+
+      if (build_id != nullptr)
+	global_index_cache.store_debugdata
+	  (build_id, gdb::array_view<const gdb_byte> (lstream->data,
+						      lstream->data_end));
+    }
+
   return lstream;
 }
 
@@ -142,9 +274,6 @@ lzma_pread (struct bfd *nbfd, void *stream, void *buf, file_ptr nbytes,
   lzma_index_iter iter;
   gdb_byte *compressed, *uncompressed;
   file_ptr block_offset;
-  lzma_filter filters[LZMA_FILTERS_MAX + 1];
-  lzma_block block;
-  size_t compressed_pos, uncompressed_pos;
   file_ptr res;
 
   res = 0;
@@ -171,25 +300,9 @@ lzma_pread (struct bfd *nbfd, void *stream, void *buf, file_ptr nbytes,
 
 	  uncompressed = (gdb_byte *) xmalloc (iter.block.uncompressed_size);
 
-	  memset (&block, 0, sizeof (block));
-	  block.filters = filters;
-	  block.header_size = lzma_block_header_size_decode (compressed[0]);
-	  if (lzma_block_header_decode (&block, &gdb_lzma_allocator, compressed)
-	      != LZMA_OK)
-	    {
-	      xfree (compressed);
-	      xfree (uncompressed);
-	      break;
-	    }
-
-	  compressed_pos = block.header_size;
-	  uncompressed_pos = 0;
-	  if (lzma_block_buffer_decode (&block, &gdb_lzma_allocator,
-					compressed, &compressed_pos,
-					iter.block.total_size,
-					uncompressed, &uncompressed_pos,
-					iter.block.uncompressed_size)
-	      != LZMA_OK)
+	  if (!lzma_decode_block (&gdb_lzma_allocator, compressed,
+				  iter.block.total_size, uncompressed,
+				  iter.block.uncompressed_size))
 	    {
 	      xfree (compressed);
 	      xfree (uncompressed);
@@ -277,6 +390,25 @@ find_separate_debug_file_in_section (struct objfile *objfile)
   if (shared != nullptr)
     return *shared;
 
+  /* An earlier GDB may have stored the decompressed object in the
+     index cache.  */
+  const bfd_build_id *build_id = build_id_bfd_get (objfile->obfd);
+  if (build_id != nullptr)
+    {
+      std::string cached = global_index_cache.lookup_debugdata (build_id);
+
+      if (!cached.empty ())
+	{
+	  abfd = gdb_bfd_open (cached.c_str (), gnutarget, -1, false);
+	  if (abfd != NULL && bfd_check_format (abfd.get (), bfd_object))
+	    {
+	      gnu_debug_key.emplace (objfile->obfd, abfd);
+	      return abfd;
+	    }
+	  abfd.reset (nullptr);
+	}
+    }
+
   std::string filename = string_printf (_(".gnu_debugdata for %s"),
 					objfile_name (objfile));
 
@@ -36,6 +36,7 @@
 #include "gdbcmd.h"
 #include <algorithm>
 #include <set>
+#include <unordered_map>
 
 static struct partial_symbol *lookup_partial_symbol (struct objfile *,
 						     struct partial_symtab *,
@@ -81,6 +82,7 @@ psymtab_storage::install_psymtab (partial_symtab *pst)
 {
   pst->next = psymtabs;
   psymtabs = pst;
+  invalidate_name_index ();
 }
 
 
@@ -468,6 +470,144 @@ find_pc_sect_psymbol (struct objfile *objfile,
   return best;
 }
 
+/* Build the name index of PARTIAL_SYMTABS, if it is not built
+   already.  */
+
+static void
+build_psymbol_name_index (psymtab_storage *partial_symtabs)
+{
+  if (partial_symtabs->name_index.has_value ())
+    return;
+
+  std::vector<psymtab_storage::name_index_entry> entries;
+  std::vector<partial_symtab *> &psymtabs
+    = partial_symtabs->name_index_psymtabs;
+
+  entries.reserve (partial_symtabs->global_psymbols.size ()
+		   + partial_symtabs->static_psymbols.size ());
+  for (partial_symtab *ps : partial_symtabs->range ())
+    {
+      unsigned int index = psymtabs.size ();
+
+      psymtabs.push_back (ps);
+      for (int i = 0; i < ps->n_global_syms; i++)
+	entries.push_back
+	  ({ partial_symtabs->global_psymbols[ps->globals_offset + i],
+	     index, 1 });
+      for (int i = 0; i < ps->n_static_syms; i++)
+	entries.push_back
+	  ({ partial_symtabs->static_psymbols[ps->statics_offset + i],
+	     index, 0 });
+    }
+
+  /* The names of the partial symbols are interned, and many symbols
+     share a name, so only sort the distinct names, and then place the
+     entries by the rank of their name.  Placing them in order keeps
+     the symbols with equal names in the order of their psymtabs, like
+     in the global symbols of a psymtab.  */
+  std::unordered_map<const char *, unsigned int> name_ids;
+  std::vector<const char *> names;
+  std::vector<unsigned int> entry_ids (entries.size ());
+
+  for (size_t i = 0; i < entries.size (); i++)
+    {
+      const char *name = entries[i].psym->ginfo.search_name ();
+      auto inserted = name_ids.emplace (name, names.size ());
+
+      if (inserted.second)
+	names.push_back (name);
+      entry_ids[i] = inserted.first->second;
+    }
+
+  std::vector<unsigned int> order (names.size ());
+  for (unsigned int i = 0; i < order.size (); i++)
+    order[i] = i;
+  std::stable_sort (order.begin (), order.end (),
+		    [&] (unsigned int id1, unsigned int id2)
+    {
+      return strcmp_iw_ordered (names[id1], names[id2]) < 0;
+    });
+
+  /* Turn ORDER into the position of the first entry of each name.  */
+  std::vector<size_t> counts (names.size ());
+  for (unsigned int id : entry_ids)
+    counts[id]++;
+  size_t position = 0;
+  for (unsigned int id : order)
+    {
+      size_t count = counts[id];
+      counts[id] = position;
+      position += count;
+    }
+
+  std::vector<psymtab_storage::name_index_entry> sorted (entries.size ());
+  for (size_t i = 0; i < entries.size (); i++)
+    sorted[counts[entry_ids[i]]++] = entries[i];
+  entries = std::move (sorted);
+
+  partial_symtabs->name_index.emplace (std::move (entries));
+}
+
+/* Return the psymtabs of OBJFILE that are not read in yet and have a
+   partial symbol in DOMAIN whose name matches LOOKUP_NAME, in the
+   order of the psymtab list.  Only consider global symbols if GLOBAL
+   is 1, and only static symbols if GLOBAL is 0; consider both if it is
+   -1.  */
+
+static std::vector<partial_symtab *>
+lookup_psymtabs_by_name (struct objfile *objfile,
+			 const lookup_name_info &lookup_name,
+			 int global, domain_enum domain)
+{
+  psymtab_storage *partial_symtabs = objfile->partial_symtabs.get ();
+
+  require_partial_symbols (objfile, true);
+  build_psymbol_name_index (partial_symtabs);
+
+  const std::vector<psymtab_storage::name_index_entry> &entries
+    = *partial_symtabs->name_index;
+  const char *name = lookup_name.c_str ();
+
+  /* Find the first symbol whose name might match, like
+     lookup_partial_symbol does.  */
+  auto iter = std::lower_bound
+    (entries.begin (), entries.end (), name,
+     [] (const psymtab_storage::name_index_entry &entry, const char *n)
+     {
+       return strcmp_iw_ordered (entry.psym->ginfo.search_name (), n) < 0;
+     });
+
+  /* For `case_sensitivity == case_sensitive_off' strcmp_iw_ordered will
+     search more exactly than what matches SYMBOL_MATCHES_SEARCH_NAME.  */
+  while (iter != entries.begin ()
+	 && symbol_matches_search_name (&(iter - 1)->psym->ginfo,
+					lookup_name))
+    --iter;
+
+  std::vector<unsigned int> found;
+  for (; (iter != entries.end ()
+	  && symbol_matches_search_name (&iter->psym->ginfo, lookup_name));
+       ++iter)
+    if ((global == -1 || iter->global == global)
+	&& symbol_matches_domain (iter->psym->ginfo.language (),
+				  iter->psym->domain, domain))
+      found.push_back (iter->psymtab);
+
+  std::sort (found.begin (), found.end ());
+  found.erase (std::unique (found.begin (), found.end ()), found.end ());
+
+  std::vector<partial_symtab *> result;
+  for (unsigned int index : found)
+    {
+      partial_symtab *ps = partial_symtabs->name_index_psymtabs[index];
+
+      if (!ps->readin_p (objfile))
+	result.push_back (ps);
+    }
+
+  return result;
+}
+
 /* Psymtab version of lookup_symbol.  See its definition in
    the definition of quick_symbol_functions in symfile.h.  */
 
@@ -483,17 +623,17 @@ psym_lookup_symbol (struct objfile *objfile,
 
   lookup_name_info psym_lookup_name = lookup_name.make_ignore_params ();
 
-  for (partial_symtab *ps : require_partial_symbols (objfile, true))
+  for (partial_symtab *ps : lookup_psymtabs_by_name (objfile,
+						     psym_lookup_name,
+						     psymtab_index, domain))
     {
-      if (!ps->readin_p (objfile)
-	  && lookup_partial_symbol (objfile, ps, psym_lookup_name,
-				    psymtab_index, domain))
+      if (!ps->readin_p (objfile))
 	{
 	  struct symbol *sym, *with_opaque = NULL;
 	  struct compunit_symtab *stab = psymtab_to_symtab (objfile, ps);
 	  /* Note: While psymtab_to_symtab can return NULL if the
 	     partial symtab is empty, we can assume it won't here
-	     because lookup_partial_symbol succeeded.  */
+	     because lookup_psymtabs_by_name found a symbol in it.  */
 	  const struct blockvector *bv = COMPUNIT_BLOCKVECTOR (stab);
 	  const struct block *block = BLOCKVECTOR_BLOCK (bv, block_index);
 
@@ -532,11 +672,10 @@ psym_lookup_global_symbol_language (struct objfile *objfile, const char *name,
 
   lookup_name_info lookup_name (name, symbol_name_match_type::FULL);
 
-  for (partial_symtab *ps : require_partial_symbols (objfile, true))
+  for (partial_symtab *ps : lookup_psymtabs_by_name (objfile, lookup_name,
+						     1, domain))
     {
       struct partial_symbol *psym;
-      if (ps->readin_p (objfile))
-	continue;
 
       psym = lookup_partial_symbol (objfile, ps, lookup_name, 1, domain);
       if (psym)
@@ -1008,6 +1147,9 @@ psym_print_stats (struct objfile *objfile)
 	i++;
     }
   printf_filtered (_("  Number of psym tables (not yet expanded): %d\n"), i);
+  if (objfile->partial_symtabs->name_index.has_value ())
+    printf_filtered (_("  Number of psym name index entries: %zu\n"),
+		     objfile->partial_symtabs->name_index->size ());
 }
 
 /* Psymtab version of dump.  See its definition in
@@ -1045,17 +1187,9 @@ psym_expand_symtabs_for_function (struct objfile *objfile,
   lookup_name_info base_lookup (func_name, symbol_name_match_type::FULL);
   lookup_name_info lookup_name = base_lookup.make_ignore_params ();
 
-  for (partial_symtab *ps : require_partial_symbols (objfile, true))
-    {
-      if (ps->readin_p (objfile))
-	continue;
-
-      if ((lookup_partial_symbol (objfile, ps, lookup_name, 1, VAR_DOMAIN)
-	   != NULL)
-	  || (lookup_partial_symbol (objfile, ps, lookup_name, 0, VAR_DOMAIN)
-	      != NULL))
-	psymtab_to_symtab (objfile, ps);
-    }
+  for (partial_symtab *ps : lookup_psymtabs_by_name (objfile, lookup_name,
+						     -1, VAR_DOMAIN))
+    psymtab_to_symtab (objfile, ps);
 }
 
 /* Psymtab version of expand_all_symtabs.  See its definition in
@@ -1535,6 +1669,7 @@ end_psymtab_common (struct objfile *objfile, struct partial_symtab *pst)
   delete current_static_psymbols;
 
   sort_pst_symbols (objfile, pst);
+  objfile->partial_symtabs->invalidate_name_index ();
 }
 
 /* Calculate a hash code for the given partial symbol.  The hash is
@@ -1756,6 +1891,7 @@ psymtab_storage::discard_psymtab (struct partial_symtab *pst)
     prev_pst = &((*prev_pst)->next);
   (*prev_pst) = pst->next;
   delete pst;
+  invalidate_name_index ();
 }
 
 
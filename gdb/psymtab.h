@@ -135,6 +135,42 @@ class psymtab_storage
   std::vector<std::vector<partial_symbol *>*> current_global_psymbols;
   std::vector<std::vector<partial_symbol *>*> current_static_psymbols;
 
+  /* An entry of the name index.  */
+
+  struct name_index_entry
+  {
+    /* The partial symbol.  */
+    partial_symbol *psym;
+
+    /* The position of its psymtab in NAME_INDEX_PSYMTABS.  */
+    unsigned int psymtab : 31;
+
+    /* Whether it is a global symbol.  */
+    unsigned int global : 1;
+  };
+
+  /* An index of the partial symbols of all psymtabs, global and
+     static, sorted by search name like the global symbols of each
+     psymtab, so that a name can be looked up with a single binary
+     search instead of one search per psymtab.  This is built by the
+     first lookup after the psymtabs have been read, and discarded
+     whenever they change.  */
+
+  gdb::optional<std::vector<name_index_entry>> name_index;
+
+  /* The psymtabs referred to by NAME_INDEX, in the order of the
+     PSYMTABS list.  */
+
+  std::vector<partial_symtab *> name_index_psymtabs;
+
+  /* Discard the name index.  */
+
+  void invalidate_name_index ()
+  {
+    name_index.reset ();
+    name_index_psymtabs.clear ();
+  }
+
 private:
 
   /* The obstack where allocations are made.  This is lazily allocated
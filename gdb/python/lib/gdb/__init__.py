@@ -16,6 +16,7 @@
 import traceback
 import os
 import sys
+import bisect
 import _gdb
 
 if sys.version_info[0] > 2:
@@ -74,7 +75,20 @@ frame_filters = {}
 # Initial frame unwinders.
 frame_unwinders = []
 
-def _execute_unwinders(pending_frame):
+def _unwinder_handles_pc(unwinder, pc):
+    """Internal function returning whether UNWINDER may handle PC.
+
+    An unwinder handles every PC, unless it has an "address_ranges"
+    attribute holding a sorted list of non-overlapping (START, END)
+    pairs, as gdb.unwinder.Unwinder maintains, in which case it only
+    handles the PCs in these ranges."""
+    ranges = getattr(unwinder, "address_ranges", None)
+    if ranges is None or pc is None:
+        return True
+    i = bisect.bisect_right(ranges, (pc, float("inf"))) - 1
+    return i >= 0 and pc < ranges[i][1]
+
+def _execute_unwinders(pending_frame, pc=None):
     """Internal function called from GDB to execute all unwinders.
 
     Runs each currently enabled unwinder until it finds the one that
@@ -82,24 +96,26 @@ def _execute_unwinders(pending_frame):
 
     Arguments:
         pending_frame: gdb.PendingFrame instance.
+        pc: The PC of the frame, or None if it is unavailable.  Unwinders
+            whose address ranges don't include it are skipped.
     Returns:
         gdb.UnwindInfo instance or None.
     """
     for objfile in objfiles():
         for unwinder in objfile.frame_unwinders:
-            if unwinder.enabled:
+            if unwinder.enabled and _unwinder_handles_pc(unwinder, pc):
                 unwind_info = unwinder(pending_frame)
                 if unwind_info is not None:
                     return unwind_info
 
     for unwinder in current_progspace().frame_unwinders:
-        if unwinder.enabled:
+        if unwinder.enabled and _unwinder_handles_pc(unwinder, pc):
             unwind_info = unwinder(pending_frame)
             if unwind_info is not None:
                 return unwind_info
 
     for unwinder in frame_unwinders:
-        if unwinder.enabled:
+        if unwinder.enabled and _unwinder_handles_pc(unwinder, pc):
             unwind_info = unwinder(pending_frame)
             if unwind_info is not None:
                 return unwind_info
@@ -291,6 +291,7 @@ def do_enable_pretty_printer (arg, flag):
         if object_re.match(objfile.filename):
             total += do_enable_pretty_printer_1(objfile.pretty_printers,
                                                 name_re, subname_re, flag)
+    gdb.invalidate_cached_pretty_printers()
 
     if flag:
         state = "enabled"
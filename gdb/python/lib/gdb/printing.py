@@ -153,6 +153,7 @@ def register_pretty_printer(obj, printer, replace=False):
             i = i + 1
 
     obj.pretty_printers.insert(0, printer)
+    gdb.invalidate_cached_pretty_printers()
 
 
 class RegexpCollectionPrettyPrinter(PrettyPrinter):
@@ -174,8 +175,19 @@ class RegexpCollectionPrettyPrinter(PrettyPrinter):
             self.gen_printer = gen_printer
             self.compiled_re = re.compile(regexp)
 
+    # The most type names whose matching subprinters are remembered.
+    _MAX_MATCHES = 1024
+
     def __init__(self, name):
         super(RegexpCollectionPrettyPrinter, self).__init__(name, [])
+        # Map type names to the list of subprinters whose regexp
+        # matches them, in order.  Enabling or disabling subprinters
+        # doesn't change this, adding or removing some does, so the
+        # map is only valid for the subprinters list and length it was
+        # filled for.
+        self._matches = {}
+        self._matches_subprinters = None
+        self._matches_length = 0
 
     def add_printer(self, name, regexp, gen_printer):
         """Add a printer to the list.
@@ -199,6 +211,7 @@ class RegexpCollectionPrettyPrinter(PrettyPrinter):
 
         self.subprinters.append(self.RegexpSubprinter(name, regexp,
                                                       gen_printer))
+        gdb.invalidate_cached_pretty_printers()
 
     def __call__(self, val):
         """Lookup the pretty-printer for the provided value."""
@@ -213,8 +226,22 @@ class RegexpCollectionPrettyPrinter(PrettyPrinter):
         # Iterate over table of type regexps to determine
         # if a printer is registered for that type.
         # Return an instantiation of the printer if found.
-        for printer in self.subprinters:
-            if printer.enabled and printer.compiled_re.search(typename):
+        if (self.subprinters is not self._matches_subprinters
+            or len(self.subprinters) != self._matches_length):
+            self._matches = {}
+            self._matches_subprinters = self.subprinters
+            self._matches_length = len(self.subprinters)
+        matches = self._matches.get(typename)
+        if matches is None:
+            matches = [printer for printer in self.subprinters
+                       if printer.compiled_re.search(typename)]
+            # Start over when full, rather than keeping track of the
+            # type names used recently.
+            if len(self._matches) >= self._MAX_MATCHES:
+                self._matches = {}
+            self._matches[typename] = matches
+        for printer in matches:
+            if printer.enabled:
                 return printer.gen_printer(val)
 
         # Cannot find a pretty printer.  Return None.
@@ -276,6 +303,9 @@ class FlagEnumerationPrinter(PrettyPrinter):
 # to this with add_builtin_pretty_printer.
 
 _builtin_pretty_printers = RegexpCollectionPrettyPrinter("builtin")
+# The builtin printers are for GDB's own structure types, which they
+# recognize by tag, so the lookup only depends on the value's type.
+_builtin_pretty_printers.cache_by_type = True
 
 register_pretty_printer(None, _builtin_pretty_printers)
 
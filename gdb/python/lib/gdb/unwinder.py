@@ -27,6 +27,10 @@ class Unwinder(object):
     Attributes:
         name: The name of the unwinder.
         enabled: A boolean indicating whether the unwinder is enabled.
+        address_ranges: None if the unwinder may handle frames at any PC.
+            Otherwise, the list of (START, END) address ranges the
+            unwinder handles, END excluded; GDB doesn't call it for
+            frames whose PC is outside these.
     """
 
     def __init__(self, name):
@@ -37,6 +41,33 @@ class Unwinder(object):
         """
         self.name = name
         self.enabled = True
+        self._address_ranges = None
+
+    @property
+    def address_ranges(self):
+        return getattr(self, "_address_ranges", None)
+
+    @address_ranges.setter
+    def address_ranges(self, ranges):
+        if ranges is None:
+            self._address_ranges = None
+        else:
+            # Keep the ranges sorted and merged, for
+            # gdb._unwinder_handles_pc.
+            merged = []
+            for (start, end) in sorted((int(start), int(end))
+                                       for (start, end) in ranges):
+                if start >= end:
+                    continue
+                if merged and start <= merged[-1][1]:
+                    merged[-1] = (merged[-1][0], max(merged[-1][1], end))
+                else:
+                    merged.append((start, end))
+            self._address_ranges = merged
+        # This can run while frames are being unwound, so only make
+        # GDB forget the ranges, not the frames; discarding those is
+        # left to the caller.
+        gdb.invalidate_cached_unwinders()
 
     def __call__(self, pending_frame):
         """GDB calls this method to unwind a frame.
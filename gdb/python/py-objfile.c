@@ -257,6 +257,7 @@ objfpy_set_printers (PyObject *o, PyObject *value, void *ignore)
   gdbpy_ref<> tmp (self->printers);
   Py_INCREF (value);
   self->printers = value;
+  invalidate_pp_lookup_cache ();
 
   return 0;
 }
@@ -336,6 +337,7 @@ objfpy_set_frame_unwinders (PyObject *o, PyObject *unwinders, void *ignore)
   gdbpy_ref<> tmp (self->frame_unwinders);
   Py_INCREF (unwinders);
   self->frame_unwinders = unwinders;
+  pyuw_invalidate_sniffer_cache ();
 
   return 0;
 }
@@ -26,6 +26,9 @@
 #include "python.h"
 #include "python-internal.h"
 #include "cli/cli-style.h"
+#include "observable.h"
+#include <unordered_map>
+#include <unordered_set>
 
 /* Return type of print_string_repr.  */
 
@@ -39,14 +42,67 @@ enum string_repr_result
     string_repr_ok
   };
 
+/* Return 1 if the lookup function FUNCTION is enabled, 0 if it is
+   disabled, and -1, with the Python error set, on error.  */
+
+static int
+pp_function_enabled_p (PyObject *function)
+{
+  if (!PyObject_HasAttr (function, gdbpy_enabled_cst))
+    return 1;
+
+  gdbpy_ref<> attr (PyObject_GetAttr (function, gdbpy_enabled_cst));
+  if (attr == NULL)
+    return -1;
+  return PyObject_IsTrue (attr.get ());
+}
+
+/* Return true if the lookup function FUNCTION declares, with a true
+   "cache_by_type" attribute, that whether it recognizes a value only
+   depends on the type of the value.  Never sets the Python error.  */
+
+static bool
+pp_function_cacheable_p (PyObject *function)
+{
+  if (!PyObject_HasAttrString (function, "cache_by_type"))
+    return false;
+
+  gdbpy_ref<> attr (PyObject_GetAttrString (function, "cache_by_type"));
+  int cmp = attr == NULL ? -1 : PyObject_IsTrue (attr.get ());
+  if (cmp == -1)
+    {
+      PyErr_Clear ();
+      return false;
+    }
+  return cmp;
+}
+
+/* A search for the pretty-printer of a value.  */
+
+struct pp_search
+{
+  /* The key of the value in the pretty-printer lookup cache, or NULL
+     if the search can't use the cache, see pp_lookup_cache_key.  */
+  struct type *key = nullptr;
+
+  /* The cacheable lookup functions that were called and declined the
+     value.  */
+  std::vector<gdbpy_ref<>> declined;
+};
+
+static bool pp_lookup_declined_p (PyObject *function, struct type *key);
+
 /* Helper function for find_pretty_printer which iterates over a list,
    calls each function and inspects output.  This will return a
    printer object if one recognizes VALUE.  If no printer is found, it
    will return None.  On error, it will set the Python error and
-   return NULL.  */
+   return NULL.  The cacheable functions (see pp_function_cacheable_p)
+   that the cache says decline values like VALUE are skipped, and
+   those that are called and decline VALUE are added to
+   SEARCH->declined.  */
 
 static gdbpy_ref<>
-search_pp_list (PyObject *list, PyObject *value)
+search_pp_list (PyObject *list, PyObject *value, struct pp_search *search)
 {
   Py_ssize_t pp_list_size, list_index;
 
@@ -58,20 +114,16 @@ search_pp_list (PyObject *list, PyObject *value)
 	return NULL;
 
       /* Skip if disabled.  */
-      if (PyObject_HasAttr (function, gdbpy_enabled_cst))
-	{
-	  gdbpy_ref<> attr (PyObject_GetAttr (function, gdbpy_enabled_cst));
-	  int cmp;
+      int cmp = pp_function_enabled_p (function);
+      if (cmp == -1)
+	return NULL;
+      if (!cmp)
+	continue;
 
-	  if (attr == NULL)
-	    return NULL;
-	  cmp = PyObject_IsTrue (attr.get ());
-	  if (cmp == -1)
-	    return NULL;
-
-	  if (!cmp)
-	    continue;
-	}
+      bool cacheable = (search->key != NULL
+			&& pp_function_cacheable_p (function));
+      if (cacheable && pp_lookup_declined_p (function, search->key))
+	continue;
 
       gdbpy_ref<> printer (PyObject_CallFunctionObjArgs (function, value,
 							 NULL));
@@ -79,6 +131,9 @@ search_pp_list (PyObject *list, PyObject *value)
 	return NULL;
       else if (printer != Py_None)
 	return printer;
+
+      if (cacheable)
+	search->declined.push_back (gdbpy_ref<>::new_reference (function));
     }
 
   return gdbpy_ref<>::new_reference (Py_None);
@@ -91,7 +146,7 @@ search_pp_list (PyObject *list, PyObject *value)
    Otherwise the result is the pretty-printer function, suitably inc-ref'd.  */
 
 static PyObject *
-find_pretty_printer_from_objfiles (PyObject *value)
+find_pretty_printer_from_objfiles (PyObject *value, struct pp_search *search)
 {
   for (objfile *obj : current_program_space->objfiles ())
     {
@@ -104,7 +159,7 @@ find_pretty_printer_from_objfiles (PyObject *value)
 	}
 
       gdbpy_ref<> pp_list (objfpy_get_printers (objf.get (), NULL));
-      gdbpy_ref<> function (search_pp_list (pp_list.get (), value));
+      gdbpy_ref<> function (search_pp_list (pp_list.get (), value, search));
 
       /* If there is an error in any objfile list, abort the search and exit.  */
       if (function == NULL)
@@ -124,14 +179,33 @@ find_pretty_printer_from_objfiles (PyObject *value)
    Otherwise the result is the pretty-printer function, suitably inc-ref'd.  */
 
 static gdbpy_ref<>
-find_pretty_printer_from_progspace (PyObject *value)
+find_pretty_printer_from_progspace (PyObject *value, struct pp_search *search)
 {
   gdbpy_ref<> obj = pspace_to_pspace_object (current_program_space);
 
   if (obj == NULL)
     return NULL;
   gdbpy_ref<> pp_list (pspy_get_printers (obj.get (), NULL));
-  return search_pp_list (pp_list.get (), value);
+  return search_pp_list (pp_list.get (), value, search);
+}
+
+/* Return a new reference to the global pretty-printer list, or NULL
+   if there is none.  Never sets the Python error.  */
+
+static gdbpy_ref<>
+get_gdb_pp_list ()
+{
+  if (gdb_python_module == NULL
+      || ! PyObject_HasAttrString (gdb_python_module, "pretty_printers"))
+    return NULL;
+  gdbpy_ref<> pp_list (PyObject_GetAttrString (gdb_python_module,
+					       "pretty_printers"));
+  if (pp_list == NULL || ! PyList_Check (pp_list.get ()))
+    {
+      PyErr_Clear ();
+      return NULL;
+    }
+  return pp_list;
 }
 
 /* Subroutine of find_pretty_printer to simplify it.
@@ -141,40 +215,290 @@ find_pretty_printer_from_progspace (PyObject *value)
    Otherwise the result is the pretty-printer function, suitably inc-ref'd.  */
 
 static gdbpy_ref<>
-find_pretty_printer_from_gdb (PyObject *value)
+find_pretty_printer_from_gdb (PyObject *value, struct pp_search *search)
 {
   /* Fetch the global pretty printer list.  */
-  if (gdb_python_module == NULL
-      || ! PyObject_HasAttrString (gdb_python_module, "pretty_printers"))
-    return gdbpy_ref<>::new_reference (Py_None);
-  gdbpy_ref<> pp_list (PyObject_GetAttrString (gdb_python_module,
-					       "pretty_printers"));
-  if (pp_list == NULL || ! PyList_Check (pp_list.get ()))
+  gdbpy_ref<> pp_list = get_gdb_pp_list ();
+  if (pp_list == NULL)
     return gdbpy_ref<>::new_reference (Py_None);
 
-  return search_pp_list (pp_list.get (), value);
+  return search_pp_list (pp_list.get (), value, search);
 }
 
-/* Find the pretty-printing constructor function for VALUE.  If no
-   pretty-printer exists, return None.  If one exists, return a new
-   reference.  On error, set the Python error and return NULL.  */
+/* The pretty-printer lookup cache.  Looking up the printer of a value
+   calls every enabled lookup function in turn, and the usual lookup
+   functions match the name of the value's type against regular
+   expressions; when printing large arrays or containers this
+   dominates the time spent.
+
+   A lookup function can declare, with a true "cache_by_type"
+   attribute, that whether it recognizes a value only depends on the
+   type of the value.  The cache remembers, for each such function,
+   the types of the values it declined, and the function is then
+   skipped for later values of those types.  This is independent of
+   the other lookup functions: those that don't make the declaration
+   are still called for every value.
+
+   The cache is tied to a program space and to a generation, which is
+   bumped whenever lookup functions are registered, enabled or
+   disabled, a pretty_printers attribute is replaced, or objfiles are
+   loaded (see invalidate_pp_lookup_cache).  Lookup functions added to
+   a list directly are detected by checking the lengths of the lists.
+   The cache is flushed when an objfile is freed, since the cached
+   types may belong to it.  */
+
+struct pp_lookup_cache
+{
+  /* The program space the cache is valid for.  */
+  struct program_space *pspace = nullptr;
+
+  /* The value of pp_lookup_generation when the cache was filled.  */
+  unsigned int generation = 0;
+
+  /* The pretty-printer lists that were searched, with their lengths.
+     Each list holds a reference.  */
+  std::vector<std::pair<PyObject *, Py_ssize_t>> lists;
+
+  /* The global list among LISTS, which can be replaced by assigning
+     gdb.pretty_printers.  */
+  PyObject *gdb_list = nullptr;
+
+  /* Map the cacheable lookup functions to the types of the values
+     they declined.  Each function holds a reference.  */
+  std::unordered_map<PyObject *, std::unordered_set<struct type *>>
+    declined;
+};
+
+static pp_lookup_cache pp_cache;
+
+/* Incremented when the cache must be flushed.  */
+
+static unsigned int pp_lookup_generation;
+
+/* See python-internal.h.  */
+
+void
+invalidate_pp_lookup_cache ()
+{
+  pp_lookup_generation++;
+}
+
+/* Remove all the entries of the pretty-printer lookup cache.  The GIL
+   must be held.  */
+
+static void
+clear_pp_lookup_cache ()
+{
+  for (const auto &entry : pp_cache.declined)
+    Py_DECREF (entry.first);
+  pp_cache.declined.clear ();
+  for (const auto &list : pp_cache.lists)
+    Py_DECREF (list.first);
+  pp_cache.lists.clear ();
+  pp_cache.gdb_list = nullptr;
+  pp_cache.pspace = nullptr;
+}
+
+/* Record the pretty-printer lists that find_pretty_printer searches in
+   the cache, with their lengths.  */
+
+static void
+record_pp_lists ()
+{
+  auto add_list = [&] (PyObject *list)
+    {
+      if (list != NULL && PyList_Check (list))
+	{
+	  Py_INCREF (list);
+	  pp_cache.lists.emplace_back (list, PyList_Size (list));
+	}
+    };
+
+  for (objfile *obj : current_program_space->objfiles ())
+    {
+      gdbpy_ref<> objf = objfile_to_objfile_object (obj);
+      if (objf == NULL)
+	{
+	  PyErr_Clear ();
+	  continue;
+	}
+      gdbpy_ref<> pp_list (objfpy_get_printers (objf.get (), NULL));
+      add_list (pp_list.get ());
+    }
+
+  gdbpy_ref<> obj = pspace_to_pspace_object (current_program_space);
+  if (obj == NULL)
+    PyErr_Clear ();
+  else
+    {
+      gdbpy_ref<> pp_list (pspy_get_printers (obj.get (), NULL));
+      add_list (pp_list.get ());
+    }
+
+  gdbpy_ref<> pp_list = get_gdb_pp_list ();
+  add_list (pp_list.get ());
+  pp_cache.gdb_list = pp_list.get ();
+}
+
+/* Return true if the pretty-printer lists recorded in the cache are
+   still the ones to search, with the same lengths.  */
+
+static bool
+pp_lists_unchanged_p ()
+{
+  gdbpy_ref<> pp_list = get_gdb_pp_list ();
+  if (pp_list.get () != pp_cache.gdb_list)
+    return false;
+
+  for (const auto &list : pp_cache.lists)
+    if (PyList_GET_SIZE (list.first) != list.second)
+      return false;
+
+  return true;
+}
+
+/* Return true if the pretty-printer lookup cache is valid for the
+   current state.  */
+
+static bool
+pp_lookup_cache_valid_p ()
+{
+  return (pp_cache.pspace == current_program_space
+	  && pp_cache.generation == pp_lookup_generation
+	  && pp_lists_unchanged_p ());
+}
+
+/* Make sure the pretty-printer lookup cache is valid for the current
+   state, flushing it if it isn't.  */
+
+static void
+validate_pp_lookup_cache ()
+{
+  if (pp_lookup_cache_valid_p ())
+    return;
+
+  clear_pp_lookup_cache ();
+  pp_cache.pspace = current_program_space;
+  pp_cache.generation = pp_lookup_generation;
+  record_pp_lists ();
+}
+
+/* Return true if the pretty-printer lookup cache says that FUNCTION
+   declines values whose key is KEY.  */
+
+static bool
+pp_lookup_declined_p (PyObject *function, struct type *key)
+{
+  auto iter = pp_cache.declined.find (function);
+  return iter != pp_cache.declined.end () && iter->second.count (key) != 0;
+}
+
+/* Record in the pretty-printer lookup cache that FUNCTION declines
+   values whose key is KEY.  */
+
+static void
+record_pp_decline (PyObject *function, struct type *key)
+{
+  auto inserted
+    = pp_cache.declined.emplace (function,
+				 std::unordered_set<struct type *> ());
+  if (inserted.second)
+    Py_INCREF (function);
+  inserted.first->second.insert (key);
+}
+
+/* Search all the pretty-printer lists for the pretty-printer of VALUE,
+   in the order described in find_pretty_printer.  Return it, or
+   None.  */
 
 static gdbpy_ref<>
-find_pretty_printer (PyObject *value)
+search_pretty_printers (PyObject *value, struct pp_search *search)
 {
   /* Look at the pretty-printer list for each objfile
      in the current program-space.  */
-  gdbpy_ref<> function (find_pretty_printer_from_objfiles (value));
+  gdbpy_ref<> function (find_pretty_printer_from_objfiles (value, search));
   if (function == NULL || function != Py_None)
     return function;
 
   /* Look at the pretty-printer list for the current program-space.  */
-  function = find_pretty_printer_from_progspace (value);
+  function = find_pretty_printer_from_progspace (value, search);
   if (function == NULL || function != Py_None)
     return function;
 
   /* Look at the pretty-printer list in the gdb module.  */
-  return find_pretty_printer_from_gdb (value);
+  return find_pretty_printer_from_gdb (value, search);
+}
+
+/* Return the key of VALUE in the pretty-printer lookup cache: its
+   type itself, rather than its canonical type, since lookup functions
+   that go by type names, like gdb.printing.RegexpCollectionPrettyPrinter,
+   can use the name of a typedef.  Return NULL if VALUE is not a
+   gdb.Value.  */
+
+static struct type *
+pp_lookup_cache_key (PyObject *value)
+{
+  struct value *val = value_object_to_value (value);
+  if (val == NULL)
+    return NULL;
+
+  return value_type (val);
+}
+
+/* Find the pretty-printing constructor function for VALUE.  If no
+   pretty-printer exists, return None.  If one exists, return a new
+   reference.  On error, set the Python error and return NULL.  */
+
+static gdbpy_ref<>
+find_pretty_printer (PyObject *value)
+{
+  struct pp_search search;
+
+  search.key = pp_lookup_cache_key (value);
+  if (search.key != NULL)
+    validate_pp_lookup_cache ();
+
+  gdbpy_ref<> printer = search_pretty_printers (value, &search);
+
+  /* Lookup functions may have changed the lists or loaded objfiles;
+     only record their results if the cache is still valid.  */
+  if (printer != NULL && !search.declined.empty ()
+      && pp_lookup_cache_valid_p ())
+    for (const gdbpy_ref<> &function : search.declined)
+      record_pp_decline (function.get (), search.key);
+
+  return printer;
+}
+
+/* Implementation of gdb.invalidate_cached_pretty_printers.  */
+
+PyObject *
+gdbpy_invalidate_cached_pretty_printers (PyObject *self, PyObject *args)
+{
+  invalidate_pp_lookup_cache ();
+  Py_RETURN_NONE;
+}
+
+/* Invalidate the pretty-printer lookup cache when an objfile is
+   loaded, since it brings its own lookup functions.  */
+
+static void
+pp_lookup_cache_new_objfile (struct objfile *objfile)
+{
+  invalidate_pp_lookup_cache ();
+}
+
+/* Flush the pretty-printer lookup cache when an objfile is freed,
+   since the cached types may belong to it.  */
+
+static void
+pp_lookup_cache_free_objfile (struct objfile *objfile)
+{
+  if (!gdb_python_initialized || pp_cache.pspace == nullptr)
+    return;
+
+  gdbpy_enter enter_py (objfile->arch (), current_language);
+  clear_pp_lookup_cache ();
 }
 
 /* Pretty-print a single value, via the printer object PRINTER.
@@ -684,3 +1008,11 @@ gdbpy_default_visualizer (PyObject *self, PyObject *args)
 
   return find_pretty_printer (val_obj).release ();
 }
+
+int
+gdbpy_initialize_prettyprint (void)
+{
+  gdb::observers::new_objfile.attach (pp_lookup_cache_new_objfile);
+  gdb::observers::free_objfile.attach (pp_lookup_cache_free_objfile);
+  return 0;
+}
@@ -23,11 +23,13 @@
 #include "gdb_obstack.h"
 #include "gdbcmd.h"
 #include "language.h"
+#include "objfiles.h"
 #include "observable.h"
 #include "python-internal.h"
 #include "regcache.h"
 #include "valprint.h"
 #include "user-regs.h"
+#include <algorithm>
 
 #define TRACE_PY_UNWIND(level, args...) if (pyuw_debug >= level)  \
   { fprintf_unfiltered (gdb_stdlog, args); }
@@ -477,6 +479,278 @@ pyuw_prev_register (struct frame_info *this_frame, void **cache_ptr,
   return frame_unwind_got_optimized (this_frame, regnum);
 }
 
+/* The sniffer cache.  Calling the Python unwinders for each frame is
+   expensive, all the more so as most frames are usually not handled
+   by any of them.  Unwinders can declare the address ranges of the
+   frames they handle, with the address_ranges attribute of
+   gdb.unwinder.Unwinder, and gdb._execute_unwinders doesn't call them
+   for frames outside these.  When all the enabled unwinders declare
+   their ranges, the cache remembers the union of the ranges, and
+   frames outside it are declined without calling into Python at all.
+   An unwinder that doesn't declare ranges may handle frames anywhere,
+   so it disables this.
+
+   The cache is tied to a program space and to a generation, which is
+   bumped whenever unwinders are registered, enabled or disabled, a
+   frame_unwinders or address_ranges attribute is replaced, or
+   objfiles are loaded (see pyuw_invalidate_sniffer_cache).  Unwinders
+   added to a list directly are detected by checking the lengths of
+   the lists.  */
+
+struct pyuw_sniffer_cache
+{
+  /* The program space the cache is valid for.  */
+  struct program_space *pspace = nullptr;
+
+  /* The value of pyuw_sniffer_generation when the cache was filled.  */
+  unsigned int generation = 0;
+
+  /* The unwinder lists, with their lengths.  Each list holds a
+     reference.  */
+  std::vector<std::pair<PyObject *, Py_ssize_t>> lists;
+
+  /* The global list among LISTS, which can be replaced by assigning
+     gdb.frame_unwinders.  */
+  PyObject *gdb_list = nullptr;
+
+  /* True if an enabled unwinder doesn't declare its address ranges.  */
+  bool unranged = false;
+
+  /* The union of the address ranges of the enabled unwinders, as
+     sorted, disjoint (START, END) pairs, END excluded.  */
+  std::vector<std::pair<CORE_ADDR, CORE_ADDR>> ranges;
+};
+
+static pyuw_sniffer_cache pyuw_cache;
+
+/* The current generation of the unwinders.  */
+
+static unsigned int pyuw_sniffer_generation;
+
+/* See python-internal.h.  */
+
+void
+pyuw_invalidate_sniffer_cache ()
+{
+  pyuw_sniffer_generation++;
+}
+
+/* Implementation of gdb.invalidate_cached_unwinders.  */
+
+PyObject *
+gdbpy_invalidate_cached_unwinders (PyObject *self, PyObject *args)
+{
+  pyuw_invalidate_sniffer_cache ();
+  Py_RETURN_NONE;
+}
+
+/* Remove all the entries of the sniffer cache.  The GIL must be
+   held.  */
+
+static void
+pyuw_clear_sniffer_cache ()
+{
+  for (const auto &list : pyuw_cache.lists)
+    Py_DECREF (list.first);
+  pyuw_cache.lists.clear ();
+  pyuw_cache.gdb_list = nullptr;
+  pyuw_cache.unranged = false;
+  pyuw_cache.ranges.clear ();
+  pyuw_cache.pspace = nullptr;
+}
+
+/* Add the address ranges of UNWINDER to the sniffer cache, or mark
+   the cache as unranged if UNWINDER doesn't declare them.  Disabled
+   unwinders are ignored.  Never sets the Python error.  */
+
+static void
+pyuw_record_unwinder (PyObject *unwinder)
+{
+  gdbpy_ref<> enabled (PyObject_GetAttrString (unwinder, "enabled"));
+  int cmp = enabled == NULL ? -1 : PyObject_IsTrue (enabled.get ());
+  if (cmp == 0)
+    return;
+
+  gdbpy_ref<> ranges;
+  if (cmp > 0 && PyObject_HasAttrString (unwinder, "address_ranges"))
+    ranges.reset (PyObject_GetAttrString (unwinder, "address_ranges"));
+  if (ranges == NULL || ranges == Py_None)
+    {
+      PyErr_Clear ();
+      pyuw_cache.unranged = true;
+      return;
+    }
+
+  gdbpy_ref<> iter (PyObject_GetIter (ranges.get ()));
+  if (iter == NULL)
+    {
+      PyErr_Clear ();
+      pyuw_cache.unranged = true;
+      return;
+    }
+
+  std::vector<std::pair<CORE_ADDR, CORE_ADDR>> unwinder_ranges;
+  while (true)
+    {
+      gdbpy_ref<> item (PyIter_Next (iter.get ()));
+      if (item == NULL)
+	break;
+
+      PyObject *start_obj, *end_obj;
+      CORE_ADDR start, end;
+      if (!PyArg_ParseTuple (item.get (), "OO", &start_obj, &end_obj)
+	  || get_addr_from_python (start_obj, &start) < 0
+	  || get_addr_from_python (end_obj, &end) < 0)
+	break;
+      if (start < end)
+	unwinder_ranges.emplace_back (start, end);
+    }
+
+  if (PyErr_Occurred ())
+    {
+      PyErr_Clear ();
+      pyuw_cache.unranged = true;
+      return;
+    }
+
+  pyuw_cache.ranges.insert (pyuw_cache.ranges.end (),
+			    unwinder_ranges.begin (), unwinder_ranges.end ());
+}
+
+/* Record the unwinder lists that gdb._execute_unwinders searches in
+   the sniffer cache, with their lengths, and the address ranges of
+   their unwinders.  */
+
+static void
+pyuw_record_unwinder_lists ()
+{
+  auto add_list = [&] (PyObject *obj)
+    {
+      gdbpy_ref<> list;
+
+      if (obj != NULL)
+	list.reset (PyObject_GetAttrString (obj, "frame_unwinders"));
+      if (list == NULL || !PyList_Check (list.get ()))
+	{
+	  PyErr_Clear ();
+	  return (PyObject *) nullptr;
+	}
+
+      Py_ssize_t size = PyList_GET_SIZE (list.get ());
+      for (Py_ssize_t i = 0; i < size; ++i)
+	pyuw_record_unwinder (PyList_GET_ITEM (list.get (), i));
+
+      pyuw_cache.lists.emplace_back (list.get (), size);
+      return list.release ();
+    };
+
+  for (objfile *obj : current_program_space->objfiles ())
+    {
+      gdbpy_ref<> objf = objfile_to_objfile_object (obj);
+      add_list (objf.get ());
+    }
+
+  gdbpy_ref<> pspace = pspace_to_pspace_object (current_program_space);
+  add_list (pspace.get ());
+  pyuw_cache.gdb_list = add_list (gdb_python_module);
+
+  /* Merge the ranges, for pyuw_pc_declined_p.  */
+  std::vector<std::pair<CORE_ADDR, CORE_ADDR>> &ranges = pyuw_cache.ranges;
+  std::sort (ranges.begin (), ranges.end ());
+  size_t merged = 0;
+  for (size_t i = 0; i < ranges.size (); ++i)
+    {
+      if (merged > 0 && ranges[i].first <= ranges[merged - 1].second)
+	ranges[merged - 1].second = std::max (ranges[merged - 1].second,
+					      ranges[i].second);
+      else
+	ranges[merged++] = ranges[i];
+    }
+  ranges.resize (merged);
+}
+
+/* Return true if the unwinder lists recorded in the sniffer cache are
+   still the ones to search, with the same lengths.  */
+
+static bool
+pyuw_unwinder_lists_unchanged_p ()
+{
+  gdbpy_ref<> list;
+  if (gdb_python_module != NULL)
+    list.reset (PyObject_GetAttrString (gdb_python_module,
+					"frame_unwinders"));
+  if (list == NULL)
+    PyErr_Clear ();
+  if (list.get () != pyuw_cache.gdb_list)
+    return false;
+
+  for (const auto &entry : pyuw_cache.lists)
+    if (PyList_GET_SIZE (entry.first) != entry.second)
+      return false;
+
+  return true;
+}
+
+/* Make sure the sniffer cache is valid for the current state,
+   refilling it if it isn't.  */
+
+static void
+pyuw_validate_sniffer_cache ()
+{
+  if (pyuw_cache.pspace == current_program_space
+      && pyuw_cache.generation == pyuw_sniffer_generation
+      && pyuw_unwinder_lists_unchanged_p ())
+    return;
+
+  pyuw_clear_sniffer_cache ();
+  pyuw_cache.pspace = current_program_space;
+  pyuw_cache.generation = pyuw_sniffer_generation;
+  pyuw_record_unwinder_lists ();
+}
+
+/* Return true if no Python unwinder can handle a frame at PC.  */
+
+static bool
+pyuw_pc_declined_p (CORE_ADDR pc)
+{
+  pyuw_validate_sniffer_cache ();
+  if (pyuw_cache.unranged)
+    return false;
+
+  /* Find the last range starting at or before PC.  */
+  const std::vector<std::pair<CORE_ADDR, CORE_ADDR>> &ranges
+    = pyuw_cache.ranges;
+  auto iter = std::upper_bound (ranges.begin (), ranges.end (), pc,
+				[] (CORE_ADDR addr,
+				    const std::pair<CORE_ADDR, CORE_ADDR> &range)
+				{
+				  return addr < range.first;
+				});
+  return iter == ranges.begin () || pc >= std::prev (iter)->second;
+}
+
+/* Invalidate the sniffer cache when an objfile is loaded, since it
+   brings its own unwinders.  */
+
+static void
+pyuw_new_objfile (struct objfile *objfile)
+{
+  pyuw_invalidate_sniffer_cache ();
+}
+
+/* Flush the sniffer cache when an objfile is freed, releasing its
+   unwinder list.  */
+
+static void
+pyuw_free_objfile (struct objfile *objfile)
+{
+  if (!gdb_python_initialized || pyuw_cache.pspace == nullptr)
+    return;
+
+  gdbpy_enter enter_py (objfile->arch (), current_language);
+  pyuw_clear_sniffer_cache ();
+}
+
 /* Frame sniffer dispatch.  */
 
 static int
@@ -492,6 +766,16 @@ pyuw_sniffer (const struct frame_unwind *self, struct frame_info *this_frame,
                    paddress (gdbarch, get_frame_sp (this_frame)),
                    paddress (gdbarch, get_frame_pc (this_frame)));
 
+  /* Don't call into Python for frames no unwinder can handle.  */
+  CORE_ADDR pc;
+  bool pc_p = get_frame_pc_if_available (this_frame, &pc);
+  if (pc_p && pyuw_pc_declined_p (pc))
+    {
+      TRACE_PY_UNWIND (3, "%s: outside the unwinders' ranges\n",
+		       __FUNCTION__);
+      return 0;
+    }
+
   /* Create PendingFrame instance to pass to sniffers.  */
   pending_frame_object *pfo = PyObject_New (pending_frame_object,
 					    &pending_frame_object_type);
@@ -523,9 +807,23 @@ pyuw_sniffer (const struct frame_unwind *self, struct frame_info *this_frame,
       return 0;
     }
 
+  gdbpy_ref<> pyo_pc;
+  if (pc_p)
+    {
+      pyo_pc = gdb_py_object_from_ulongest (pc);
+      if (pyo_pc == NULL)
+	{
+	  gdbpy_print_stack ();
+	  return 0;
+	}
+    }
+  else
+    pyo_pc = gdbpy_ref<>::new_reference (Py_None);
+
   gdbpy_ref<> pyo_unwind_info
     (PyObject_CallFunctionObjArgs (pyo_execute.get (),
-				   pyo_pending_frame.get (), NULL));
+				   pyo_pending_frame.get (), pyo_pc.get (),
+				   NULL));
   if (pyo_unwind_info == NULL)
     {
       /* If the unwinder is cancelled due to a Ctrl-C, then propagate
@@ -647,6 +945,8 @@ gdbpy_initialize_unwind (void)
   pyuw_gdbarch_data
       = gdbarch_data_register_post_init (pyuw_gdbarch_data_init);
   gdb::observers::architecture_changed.attach (pyuw_on_new_gdbarch);
+  gdb::observers::new_objfile.attach (pyuw_new_objfile);
+  gdb::observers::free_objfile.attach (pyuw_free_objfile);
 
   if (PyType_Ready (&pending_frame_object_type) < 0)
     return -1;
@@ -1210,6 +1210,73 @@ valpy_fetch_lazy (PyObject *self, PyObject *args)
   Py_RETURN_NONE;
 }
 
+/* Implementation of gdb.Value.read_array ([count]) -> gdb.Value.
+   Return an array of COUNT elements starting where the value, a
+   pointer or an array, points, read from the inferior in a single
+   transfer.  */
+
+static PyObject *
+valpy_read_array (PyObject *self, PyObject *args, PyObject *kw)
+{
+  struct value *value = ((value_object *) self)->value;
+  static const char *keywords[] = { "count", NULL };
+  gdb_py_longest count = -1;
+  PyObject *result = NULL;
+
+  if (!gdb_PyArg_ParseTupleAndKeywords (args, kw, "|" GDB_PY_LL_ARG,
+					keywords, &count))
+    return NULL;
+
+  try
+    {
+      scoped_value_mark free_values;
+      struct type *type = check_typedef (value_type (value));
+      struct type *elt_type;
+      CORE_ADDR addr;
+
+      if (type->code () == TYPE_CODE_PTR)
+	{
+	  if (count < 0)
+	    error (_("The number of elements is required for a pointer."));
+	  addr = value_as_address (value);
+	}
+      else if (type->code () == TYPE_CODE_ARRAY)
+	{
+	  LONGEST low, high;
+
+	  if (VALUE_LVAL (value) != lval_memory)
+	    error (_("Array is not in memory."));
+	  if (count < 0)
+	    {
+	      if (get_array_bounds (type, &low, &high) == 0)
+		error (_("Array has unknown bounds."));
+	      count = high - low + 1;
+	    }
+	  addr = value_address (value);
+	}
+      else
+	error (_("Value is not a pointer or an array."));
+
+      elt_type = TYPE_TARGET_TYPE (type);
+      if (check_typedef (elt_type)->code () == TYPE_CODE_VOID
+	  || TYPE_LENGTH (check_typedef (elt_type)) == 0)
+	error (_("Elements have no size."));
+
+      struct type *array_type
+	= lookup_array_range_type (elt_type, 0, count - 1);
+      struct value *array = value_at_lazy (array_type, addr);
+      value_fetch_lazy (array);
+
+      result = value_to_value_object (array);
+    }
+  catch (const gdb_exception &except)
+    {
+      GDB_PY_HANDLE_EXCEPTION (except);
+    }
+
+  return result;
+}
+
 /* Calculate and return the address of the PyObject as the value of
    the builtin __hash__ call.  */
 static Py_hash_t
@@ -2096,6 +2163,11 @@ Return a lazy string representation of the value." },
 Return Unicode string representation of the value." },
   { "fetch_lazy", valpy_fetch_lazy, METH_NOARGS,
     "Fetches the value from the inferior, if it was lazy." },
+  { "read_array", (PyCFunction) valpy_read_array,
+    METH_VARARGS | METH_KEYWORDS,
+    "read_array ([count]) -> gdb.Value\n\
+Return an array of COUNT elements starting where the value points,\n\
+read from the inferior in one transfer." },
   { "format_string", (PyCFunction) valpy_format_string,
     METH_VARARGS | METH_KEYWORDS,
     "format_string (...) -> string\n\
@@ -2157,6 +2229,37 @@ static PyNumberMethods value_object_as_number = {
   valpy_long,		      /* nb_index */
 };
 
+#ifdef IS_PY3K
+
+/* Implement the buffer protocol: expose the contents of the value,
+   read-only, fetching them first if the value is lazy.  */
+
+static int
+valpy_get_buffer (PyObject *self, Py_buffer *buf, int flags)
+{
+  struct value *value = ((value_object *) self)->value;
+  const gdb_byte *contents = NULL;
+
+  try
+    {
+      contents = value_contents (value);
+    }
+  catch (const gdb_exception &except)
+    {
+      GDB_PY_SET_HANDLE_EXCEPTION (except);
+    }
+
+  return PyBuffer_FillInfo (buf, self, (void *) contents,
+			    TYPE_LENGTH (value_type (value)), 1, flags);
+}
+
+static PyBufferProcs value_object_as_buffer =
+{
+  valpy_get_buffer
+};
+
+#endif	/* IS_PY3K */
+
 static PyMappingMethods value_object_as_mapping = {
   valpy_length,
   valpy_getitem,
@@ -2182,7 +2285,11 @@ PyTypeObject value_object_type = {
   valpy_str,			  /*tp_str*/
   0,				  /*tp_getattro*/
   0,				  /*tp_setattro*/
+#ifdef IS_PY3K
+  &value_object_as_buffer,	  /*tp_as_buffer*/
+#else
   0,				  /*tp_as_buffer*/
+#endif
   Py_TPFLAGS_DEFAULT | Py_TPFLAGS_CHECKTYPES
   | Py_TPFLAGS_BASETYPE,	  /*tp_flags*/
   "GDB value object",		  /* tp_doc */
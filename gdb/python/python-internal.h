@@ -546,6 +546,8 @@ int gdbpy_initialize_unwind (void)
   CPYCHECKER_NEGATIVE_RESULT_SETS_EXCEPTION;
 int gdbpy_initialize_tui ()
   CPYCHECKER_NEGATIVE_RESULT_SETS_EXCEPTION;
+int gdbpy_initialize_prettyprint (void)
+  CPYCHECKER_NEGATIVE_RESULT_SETS_EXCEPTION;
 
 /* A wrapper for PyErr_Fetch that handles reference counting for the
    caller.  */
@@ -720,6 +722,18 @@ gdbpy_ref<> apply_varobj_pretty_printer (PyObject *print_obj,
 gdbpy_ref<> gdbpy_get_varobj_pretty_printer (struct value *value);
 gdb::unique_xmalloc_ptr<char> gdbpy_get_display_hint (PyObject *printer);
 PyObject *gdbpy_default_visualizer (PyObject *self, PyObject *args);
+PyObject *gdbpy_invalidate_cached_pretty_printers (PyObject *self,
+						  PyObject *args);
+
+/* Make the pretty-printer lookup cache forget its results, because
+   the set of lookup functions changed.  */
+void invalidate_pp_lookup_cache ();
+
+/* Make the Python unwinder sniffer cache forget the address ranges of
+   the unwinders, because the unwinders changed.  */
+void pyuw_invalidate_sniffer_cache ();
+PyObject *gdbpy_invalidate_cached_unwinders (PyObject *self,
+					    PyObject *args);
 
 void bpfinishpy_pre_stop_hook (struct gdbpy_breakpoint_object *bp_obj);
 void bpfinishpy_post_stop_hook (struct gdbpy_breakpoint_object *bp_obj);
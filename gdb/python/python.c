@@ -949,6 +949,7 @@ gdbpy_parse_and_eval (PyObject *self, PyObject *args)
 static PyObject *
 gdbpy_invalidate_cached_frames (PyObject *self, PyObject *args)
 {
+  pyuw_invalidate_sniffer_cache ();
   reinit_frame_cache ();
   Py_RETURN_NONE;
 }
@@ -1761,7 +1762,8 @@ do_start_initialization ()
       || gdbpy_initialize_arch () < 0
       || gdbpy_initialize_xmethods () < 0
       || gdbpy_initialize_unwind () < 0
-      || gdbpy_initialize_tui () < 0)
+      || gdbpy_initialize_tui () < 0
+      || gdbpy_initialize_prettyprint () < 0)
     return false;
 
 #define GDB_PY_DEFINE_EVENT_TYPE(name, py_name, doc, base)	\
@@ -2105,6 +2107,16 @@ Return a tuple containing all inferiors." },
 Invalidate any cached frame objects in gdb.\n\
 Intended for internal use only." },
 
+  { "invalidate_cached_pretty_printers",
+    gdbpy_invalidate_cached_pretty_printers, METH_NOARGS,
+    "invalidate_cached_pretty_printers () -> None.\n\
+Invalidate the cached results of the pretty-printer lookup." },
+
+  { "invalidate_cached_unwinders", gdbpy_invalidate_cached_unwinders,
+    METH_NOARGS,
+    "invalidate_cached_unwinders () -> None.\n\
+Invalidate the address ranges of the unwinders remembered by gdb." },
+
   { "convenience_variable", gdbpy_convenience_variable, METH_VARARGS,
     "convenience_variable (NAME) -> value.\n\
 Return the value of the convenience variable $NAME,\n\
@@ -467,7 +467,7 @@ registers_changed_ptid (process_stratum_target *target, ptid_t ptid)
     {
       /* We just deleted the regcache of the current thread.  Need to
 	 forget about any frames we have cached, too.  */
-      reinit_frame_cache ();
+      reinit_frame_cache_retaining ();
     }
 }
 
@@ -23,6 +23,7 @@
 #include <fcntl.h>
 #include "symtab.h"
 #include "bfd.h"
+#include "elf-bfd.h"
 #include "symfile.h"
 #include "objfiles.h"
 #include "gdbcore.h"
@@ -46,8 +47,13 @@
 #include "filesystem.h"
 #include "gdb_bfd.h"
 #include "gdbsupport/filestuff.h"
+#include "gdbsupport/thread-pool.h"
+#include "gdbsupport/byte-vector.h"
+#include "gdbsupport/scoped_fd.h"
 #include "source.h"
 #include "cli/cli-style.h"
+#include "build-id.h"
+#include "debuginfod-support.h"
 
 /* Architecture-specific operations.  */
 
@@ -922,6 +928,233 @@ libpthread_solib_p (struct so_list *so)
   return libpthread_name_p (so->so_name);
 }
 
+/* A range of a file, as an offset and a length.  */
+
+typedef std::pair<file_ptr, bfd_size_type> solib_file_range;
+
+/* Return the ranges of the file of ABFD that reading its symbols
+   reads: the contents of its non-allocated sections (the symbol table
+   and the debug info), and its dynamic symbol table.  If ABFD has a
+   DWARF index, the rest of the DWARF is read lazily, so its ranges
+   are left out.  Only ELF files are handled; for others, no ranges
+   are returned.  */
+
+static std::vector<solib_file_range>
+solib_symbol_file_ranges (bfd *abfd)
+{
+  std::vector<solib_file_range> ranges;
+
+  if (bfd_get_flavour (abfd) != bfd_target_elf_flavour)
+    return ranges;
+
+  Elf_Internal_Shdr **sections = elf_elfsections (abfd);
+  unsigned int num_sections = elf_numsections (abfd);
+  bool have_index = (bfd_get_section_by_name (abfd, ".gdb_index") != NULL
+		     || bfd_get_section_by_name (abfd, ".debug_names") != NULL);
+
+  for (unsigned int i = 1; i < num_sections; i++)
+    {
+      Elf_Internal_Shdr *hdr = sections[i];
+
+      if (hdr == NULL || hdr->sh_type == SHT_NOBITS || hdr->sh_size == 0)
+	continue;
+
+      if (hdr->sh_type == SHT_DYNSYM)
+	{
+	  ranges.emplace_back (hdr->sh_offset, hdr->sh_size);
+	  if (hdr->sh_link < num_sections && sections[hdr->sh_link] != NULL)
+	    ranges.emplace_back (sections[hdr->sh_link]->sh_offset,
+				 sections[hdr->sh_link]->sh_size);
+	  continue;
+	}
+
+      if ((hdr->sh_flags & SHF_ALLOC) != 0)
+	continue;
+
+      if (have_index && hdr->bfd_section != NULL)
+	{
+	  const char *name = bfd_section_name (hdr->bfd_section);
+
+	  if (startswith (name, ".debug_")
+	      && strcmp (name, ".debug_names") != 0)
+	    continue;
+	}
+
+      ranges.emplace_back (hdr->sh_offset, hdr->sh_size);
+    }
+
+  return ranges;
+}
+
+/* Read RANGES of the file FILENAME, so that they are in the operating
+   system's page cache when the symbols are read from the file.  This
+   is called in a worker thread, and so only uses its arguments.  */
+
+static void
+solib_prefetch_file (const std::string &filename,
+		     const std::vector<solib_file_range> &ranges)
+{
+  scoped_fd fd (gdb_open_cloexec (filename.c_str (), O_RDONLY | O_BINARY, 0));
+
+  if (fd.get () < 0)
+    return;
+
+  gdb::byte_vector buffer (256 * 1024);
+
+  for (const solib_file_range &range : ranges)
+    {
+      if (lseek (fd.get (), range.first, SEEK_SET) != range.first)
+	return;
+
+      for (bfd_size_type left = range.second; left > 0; )
+	{
+	  ssize_t n = read (fd.get (), buffer.data (),
+			    std::min (left, (bfd_size_type) buffer.size ()));
+
+	  if (n <= 0)
+	    return;
+	  left -= n;
+	}
+    }
+}
+
+/* Reads the files of the shared libraries whose symbols solib_add is
+   about to read in worker threads, a few libraries ahead of the main
+   thread.  The symbols themselves are still read by the main thread,
+   one library after another, so the objfiles are created in the same
+   order as before; but the main thread then does not wait for the
+   disk, except perhaps for the first library.  */
+
+class solib_prefetcher
+{
+public:
+
+  /* Prepare to prefetch the files of SOS, in order.  */
+  explicit solib_prefetcher (const std::vector<so_list *> &sos);
+
+  ~solib_prefetcher ();
+
+  DISABLE_COPY_AND_ASSIGN (solib_prefetcher);
+
+  /* Called before the symbols of SO are read.  Wait until the file of
+     SO has been prefetched, if it is being prefetched, and prefetch
+     more files ahead of it.  */
+  void wait (struct so_list *so);
+
+private:
+
+  /* Start prefetching the next file, if any.  */
+  void start_next ();
+
+  /* The libraries whose files are to be prefetched, in the order in
+     which their symbols are read.  */
+  std::vector<so_list *> m_sos;
+
+  /* The prefetch tasks started so far, parallel to the start of
+     M_SOS.  */
+  std::vector<std::future<void>> m_futures;
+};
+
+solib_prefetcher::solib_prefetcher (const std::vector<so_list *> &sos)
+{
+  size_t threads = gdb::thread_pool::g_thread_pool->thread_count ();
+
+  /* Without worker threads, prefetching would only read the files
+     twice.  */
+  if (threads == 0 || sos.size () < 2)
+    return;
+
+  for (so_list *so : sos)
+    if (!gdb_bfd_has_target_filename (so->abfd))
+      m_sos.push_back (so);
+
+  /* Keep at most as many files in flight as there are worker threads,
+     so that the tasks that reading the symbols posts to the thread
+     pool do not wait behind a long queue of prefetches.  */
+  for (size_t i = 0; i < threads; i++)
+    start_next ();
+}
+
+solib_prefetcher::~solib_prefetcher ()
+{
+  for (std::future<void> &future : m_futures)
+    if (future.valid ())
+      future.wait ();
+}
+
+void
+solib_prefetcher::start_next ()
+{
+  if (m_futures.size () == m_sos.size ())
+    return;
+
+  bfd *abfd = m_sos[m_futures.size ()]->abfd;
+  std::string filename = bfd_get_filename (abfd);
+  std::vector<solib_file_range> ranges = solib_symbol_file_ranges (abfd);
+
+  m_futures.push_back (gdb::thread_pool::g_thread_pool->post_task
+    ([=] ()
+     {
+       solib_prefetch_file (filename, ranges);
+     }));
+}
+
+void
+solib_prefetcher::wait (struct so_list *so)
+{
+  auto iter = std::find (m_sos.begin (), m_sos.end (), so);
+
+  if (iter == m_sos.end ())
+    return;
+
+  size_t index = iter - m_sos.begin ();
+
+  while (m_futures.size () <= index)
+    start_next ();
+  start_next ();
+  m_futures[index].wait ();
+}
+
+/* Return the build-ids of the libraries of SOS whose separate debug
+   info reading their symbols would download from debuginfod servers:
+   those that have no debug info of their own and none installed
+   locally under their build-id.  The .gnu_debuglink of the libraries
+   is not followed here, since reading their symbols would follow it
+   again and compute the CRC of the debug file a second time; the
+   debug info of a library that is only found that way can therefore
+   be downloaded for nothing.  */
+
+static std::vector<gdb::byte_vector>
+solib_debuginfod_build_ids (const std::vector<so_list *> &sos)
+{
+  std::vector<gdb::byte_vector> build_ids;
+
+  if (!debuginfod_prefetcher::enabled ())
+    return build_ids;
+
+  /* Reading the symbols looks the build-ids up again, and prints its
+     own debug output for that.  */
+  scoped_restore restore_separate_debug_file_debug
+    = make_scoped_restore (&separate_debug_file_debug, false);
+
+  for (so_list *so : sos)
+    {
+      const struct bfd_build_id *build_id = build_id_bfd_get (so->abfd);
+
+      if (build_id == nullptr
+	  || bfd_get_section_by_name (so->abfd, ".debug_info") != nullptr
+	  || bfd_get_section_by_name (so->abfd, ".zdebug_info") != nullptr
+	  || bfd_get_section_by_name (so->abfd, ".gnu_debugdata") != nullptr
+	  || build_id_to_debug_bfd (build_id->size, build_id->data) != nullptr)
+	continue;
+
+      build_ids.emplace_back (build_id->data,
+			      build_id->data + build_id->size);
+    }
+
+  return build_ids;
+}
+
 /* Read in symbolic information for any shared objects whose names
    match PATTERN.  (If we've already read a shared object's symbol
    info, leave it alone.)  If PATTERN is zero, read them all.
@@ -968,6 +1201,16 @@ solib_add (const char *pattern, int from_tty, int readsyms)
     if (from_tty)
         add_flags |= SYMFILE_VERBOSE;
 
+    std::vector<so_list *> to_read;
+    for (struct so_list *gdb : current_program_space->solibs ())
+      if ((! pattern || re_exec (gdb->so_name))
+	  && (readsyms || libpthread_solib_p (gdb))
+	  && !gdb->symbols_loaded
+	  && gdb->abfd != NULL)
+	to_read.push_back (gdb);
+    solib_prefetcher prefetcher (to_read);
+    debuginfod_prefetcher downloads (solib_debuginfod_build_ids (to_read));
+
     for (struct so_list *gdb : current_program_space->solibs ())
       if (! pattern || re_exec (gdb->so_name))
 	{
@@ -990,8 +1233,12 @@ solib_add (const char *pattern, int from_tty, int readsyms)
 		    printf_unfiltered (_("Symbols already loaded for %s\n"),
 				       gdb->so_name);
 		}
-	      else if (solib_read_symbols (gdb, add_flags))
-		loaded_any_symbols = true;
+	      else
+		{
+		  prefetcher.wait (gdb);
+		  if (solib_read_symbols (gdb, add_flags))
+		    loaded_any_symbols = true;
+		}
 	    }
 	}
 
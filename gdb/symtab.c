@@ -71,6 +71,12 @@
 #include "gdbsupport/gdb_string_view.h"
 #include "gdbsupport/pathstuff.h"
 #include "gdbsupport/common-utils.h"
+#include "gdbsupport/function-view.h"
+#include <unordered_set>
+
+#if CXX_STD_THREAD
+#include <mutex>
+#endif
 
 /* Forward declarations for local functions.  */
 
@@ -134,6 +140,18 @@ static const program_space_key<main_info> main_progspace_key;
    there's no point in allowing a user typo to make gdb consume all memory.  */
 #define MAX_SYMBOL_CACHE_SIZE (1024*1024)
 
+/* The number of slots in each set of the symbol cache.
+   Lookups that hash to the same set only evict each other once all the
+   slots of the set are in use, and then the least recently used one
+   goes.  */
+#define SYMBOL_CACHE_WAYS 4
+
+/* The number of cache entries to provide for each objfile.
+   The cache grows beyond the configured size to keep at least this many
+   entries per objfile of the program space, so that programs linked with
+   many shared libraries don't thrash it.  */
+#define SYMBOL_CACHE_ENTRIES_PER_OBJFILE 64
+
 /* symbol_cache_lookup returns this if a previous lookup failed to find the
    symbol in any objfile.  */
 #define SYMBOL_LOOKUP_FAILED \
@@ -154,6 +172,11 @@ struct symbol_cache_slot
 {
   enum symbol_cache_slot_state state;
 
+  /* The hash of the lookup recorded in this slot.  It selects the set of
+     the slot, and is kept so that the cache can be resized without
+     recomputing it.  */
+  unsigned int hash;
+
   /* The objfile that was current when the symbol was looked up.
      This is only needed for global blocks, but for simplicity's sake
      we allocate the space for both.  If data shows the extra space used
@@ -172,6 +195,11 @@ struct symbol_cache_slot
      lookup was saved in the cache, but cache space is pretty cheap.  */
   const struct objfile *objfile_context;
 
+  /* The objfile the found symbol belongs to, or NULL.  The slot must go
+     when this objfile is freed.  It is recorded here because the symbol
+     can no longer be looked at by then.  */
+  const struct objfile *objfile;
+
   union
   {
     struct block_symbol found;
@@ -183,16 +211,6 @@ struct symbol_cache_slot
   } value;
 };
 
-/* Clear out SLOT.  */
-
-static void
-symbol_cache_clear_slot (struct symbol_cache_slot *slot)
-{
-  if (slot->state == SYMBOL_SLOT_NOT_FOUND)
-    xfree (slot->value.not_found.name);
-  slot->state = SYMBOL_SLOT_UNUSED;
-}
-
 /* Symbols don't specify global vs static block.
    So keep them in separate caches.  */
 
@@ -202,7 +220,23 @@ struct block_symbol_cache
   unsigned int misses;
   unsigned int collisions;
 
-  /* SYMBOLS is a variable length array of this size.
+  /* The number of entries removed because an objfile they depend on was
+     added or freed.  */
+  unsigned int invalidations;
+
+  /* The number of slots in use, and how many of those record a failed
+     lookup.  */
+  unsigned int used;
+  unsigned int not_found;
+
+  /* The cache is set-associative: a lookup can only be recorded in the
+     WAYS slots of the set selected by its hash.  The slots of a set are
+     contiguous in SYMBOLS, ordered from the most to the least recently
+     used one.  */
+  unsigned int sets;
+  unsigned int ways;
+
+  /* SYMBOLS is a variable length array of this size, SETS * WAYS.
      One can imagine that in general one cache (global/static) should be a
      fraction of the size of the other, but there's no data at the moment
      on which to decide.  */
@@ -211,6 +245,23 @@ struct block_symbol_cache
   struct symbol_cache_slot symbols[1];
 };
 
+/* Clear out SLOT of BSC.  */
+
+static void
+symbol_cache_clear_slot (struct block_symbol_cache *bsc,
+			 struct symbol_cache_slot *slot)
+{
+  if (slot->state == SYMBOL_SLOT_UNUSED)
+    return;
+  if (slot->state == SYMBOL_SLOT_NOT_FOUND)
+    {
+      xfree (slot->value.not_found.name);
+      --bsc->not_found;
+    }
+  --bsc->used;
+  slot->state = SYMBOL_SLOT_UNUSED;
+}
+
 /* Clear all slots of BSC and free BSC.  */
 
 static void
@@ -219,7 +270,7 @@ destroy_block_symbol_cache (struct block_symbol_cache *bsc)
   if (bsc != nullptr)
     {
       for (unsigned int i = 0; i < bsc->size; i++)
-	symbol_cache_clear_slot (&bsc->symbols[i]);
+	symbol_cache_clear_slot (bsc, &bsc->symbols[i]);
       xfree (bsc);
     }
 }
@@ -232,7 +283,11 @@ destroy_block_symbol_cache (struct block_symbol_cache *bsc)
    overall gdb performance.
 
    Symbols are hashed on the name, its domain, and block.
-   They are also hashed on their objfile for objfile-specific lookups.  */
+   They are also hashed on their objfile for objfile-specific lookups.
+
+   The cache persists as objfiles come and go: adding an objfile only
+   forgets the lookups that failed, and freeing one only forgets the
+   entries that refer to it.  */
 
 struct symbol_cache
 {
@@ -244,8 +299,17 @@ struct symbol_cache
     destroy_block_symbol_cache (static_symbols);
   }
 
+  /* The number of entries the caches were sized for, zero if the cache
+     is disabled.  */
+  unsigned int size = 0;
+
   struct block_symbol_cache *global_symbols = nullptr;
   struct block_symbol_cache *static_symbols = nullptr;
+
+  /* Objfiles freed since the cache was last cleaned up.  Entries referring
+     to them are removed before the cache is used again; batching this
+     makes freeing all the objfiles of a program space cheap.  */
+  std::unordered_set<const struct objfile *> freed_objfiles;
 };
 
 /* Program space key for finding its symbol cache.  */
@@ -791,6 +855,315 @@ create_demangled_names_hash (struct objfile_per_bfd_storage *per_bfd)
      free_demangled_name_entry, xcalloc, xfree));
 }
 
+/* The demangled name cache.
+
+   Demangling is one of the most expensive parts of reading symbols,
+   and many objfiles define the same mangled names: the template
+   instantiations of a C++ library appear in every shared library using
+   them, and the symbols of an objfile are read again when it is
+   reloaded.  This process-wide cache remembers the successful
+   demanglings done by symbol_find_demangled_name, so that each name is
+   only demangled once.
+
+   The minimal symbols are demangled in worker threads (see
+   minimal_symbol_reader::install), so the cache is split in shards,
+   each protected by its own lock.  */
+
+/* The default number of entries of the demangled name cache.  */
+#define DEFAULT_DEMANGLED_NAME_CACHE_SIZE (256 * 1024)
+
+/* The maximum number of entries of the demangled name cache.  */
+#define MAX_DEMANGLED_NAME_CACHE_SIZE (16 * 1024 * 1024)
+
+/* The number of shards of the demangled name cache.  */
+#define DEMANGLED_NAME_CACHE_SHARDS 16
+
+/* An entry of the demangled name cache.  The strings are allocated
+   along with the entry.  */
+
+struct demangled_name_cache_entry
+{
+  /* The mangled name.  */
+  const char *mangled;
+
+  /* The language the name was demangled for, language_auto if it was
+     demangled by any language that could.  */
+  enum language requested;
+
+  /* The demangling style that was in effect.  */
+  enum demangling_styles style;
+
+  /* The language that demangled the name.  */
+  enum language language;
+
+  /* The demangled name.  */
+  const char *demangled;
+};
+
+/* Hash function for the demangled name cache.  */
+
+static hashval_t
+hash_demangled_name_cache_entry (const void *data)
+{
+  const struct demangled_name_cache_entry *e
+    = (const struct demangled_name_cache_entry *) data;
+
+  return htab_hash_string (e->mangled);
+}
+
+/* Equality function for the demangled name cache.  */
+
+static int
+eq_demangled_name_cache_entry (const void *a, const void *b)
+{
+  const struct demangled_name_cache_entry *ea
+    = (const struct demangled_name_cache_entry *) a;
+  const struct demangled_name_cache_entry *eb
+    = (const struct demangled_name_cache_entry *) b;
+
+  return (ea->requested == eb->requested
+	  && ea->style == eb->style
+	  && strcmp (ea->mangled, eb->mangled) == 0);
+}
+
+/* A shard of the demangled name cache.  */
+
+struct demangled_name_cache_shard
+{
+#if CXX_STD_THREAD
+  std::mutex mutex;
+#endif
+
+  /* The entries of the shard, created on first use.  */
+  htab_up entries;
+
+  unsigned int hits = 0;
+  unsigned int misses = 0;
+
+  /* The number of times the shard was emptied because it was full.  */
+  unsigned int evictions = 0;
+};
+
+static demangled_name_cache_shard
+  demangled_name_cache[DEMANGLED_NAME_CACHE_SHARDS];
+
+/* The size of the demangled name cache, staged here by "maint set".  */
+static unsigned int new_demangled_name_cache_size
+  = DEFAULT_DEMANGLED_NAME_CACHE_SIZE;
+
+/* The current size of the demangled name cache, zero if it is
+   disabled.  */
+static unsigned int demangled_name_cache_size
+  = DEFAULT_DEMANGLED_NAME_CACHE_SIZE;
+
+/* Return the shard of the demangled name cache for the mangled name
+   whose hash is HASH.  */
+
+static struct demangled_name_cache_shard &
+demangled_name_cache_shard_for (hashval_t hash)
+{
+  /* The low bits of HASH select the slot in the table of the shard.  */
+  return demangled_name_cache[(hash >> 16) % DEMANGLED_NAME_CACHE_SHARDS];
+}
+
+/* Look up MANGLED, as demangled for language REQUESTED, in the
+   demangled name cache.  If it is found, return true and set *LANGUAGE
+   and *DEMANGLED to the language that demangled it and to a copy of the
+   demangled name, which must be xfree'd.  */
+
+static bool
+demangled_name_cache_lookup (const char *mangled, enum language requested,
+			     enum language *language, char **demangled)
+{
+  if (demangled_name_cache_size == 0)
+    return false;
+
+  struct demangled_name_cache_entry key;
+  key.mangled = mangled;
+  key.requested = requested;
+  key.style = current_demangling_style;
+
+  hashval_t hash = hash_demangled_name_cache_entry (&key);
+  struct demangled_name_cache_shard &shard
+    = demangled_name_cache_shard_for (hash);
+
+#if CXX_STD_THREAD
+  std::lock_guard<std::mutex> guard (shard.mutex);
+#endif
+
+  const struct demangled_name_cache_entry *entry = nullptr;
+  if (shard.entries != nullptr)
+    entry = ((const struct demangled_name_cache_entry *)
+	     htab_find_with_hash (shard.entries.get (), &key, hash));
+  if (entry == nullptr)
+    {
+      ++shard.misses;
+      return false;
+    }
+
+  ++shard.hits;
+  *language = entry->language;
+  *demangled = xstrdup (entry->demangled);
+  return true;
+}
+
+/* Record in the demangled name cache that MANGLED, demangled for
+   language REQUESTED, was demangled as DEMANGLED by LANGUAGE.  */
+
+static void
+demangled_name_cache_insert (const char *mangled, enum language requested,
+			     enum language language, const char *demangled)
+{
+  if (demangled_name_cache_size == 0)
+    return;
+
+  struct demangled_name_cache_entry key;
+  key.mangled = mangled;
+  key.requested = requested;
+  key.style = current_demangling_style;
+
+  hashval_t hash = hash_demangled_name_cache_entry (&key);
+  struct demangled_name_cache_shard &shard
+    = demangled_name_cache_shard_for (hash);
+
+#if CXX_STD_THREAD
+  std::lock_guard<std::mutex> guard (shard.mutex);
+#endif
+
+  if (shard.entries == nullptr)
+    shard.entries.reset (htab_create_alloc
+			 (256, hash_demangled_name_cache_entry,
+			  eq_demangled_name_cache_entry, xfree,
+			  xcalloc, xfree));
+  else if (htab_elements (shard.entries.get ())
+	   >= demangled_name_cache_size / DEMANGLED_NAME_CACHE_SHARDS)
+    {
+      /* The shard is full.  Start it over rather than keeping track of
+	 which entries were used recently.  */
+      htab_empty (shard.entries.get ());
+      ++shard.evictions;
+    }
+
+  void **slot = htab_find_slot_with_hash (shard.entries.get (), &key, hash,
+					  INSERT);
+  if (*slot != nullptr)
+    return;
+
+  /* Allocate the entry and its strings at once.  */
+  size_t mangled_len = strlen (mangled) + 1;
+  size_t demangled_len = strlen (demangled) + 1;
+  struct demangled_name_cache_entry *entry
+    = ((struct demangled_name_cache_entry *)
+       xmalloc (sizeof (*entry) + mangled_len + demangled_len));
+  char *strings = (char *) (entry + 1);
+
+  memcpy (strings, mangled, mangled_len);
+  memcpy (strings + mangled_len, demangled, demangled_len);
+  entry->mangled = strings;
+  entry->requested = requested;
+  entry->style = key.style;
+  entry->language = language;
+  entry->demangled = strings + mangled_len;
+  *slot = entry;
+}
+
+/* Empty the demangled name cache, and reset its statistics.  */
+
+static void
+demangled_name_cache_flush ()
+{
+  for (demangled_name_cache_shard &shard : demangled_name_cache)
+    {
+#if CXX_STD_THREAD
+      std::lock_guard<std::mutex> guard (shard.mutex);
+#endif
+
+      shard.entries.reset ();
+      shard.hits = 0;
+      shard.misses = 0;
+      shard.evictions = 0;
+    }
+}
+
+/* Called when demangled-name-cache-size is set.  */
+
+static void
+set_demangled_name_cache_size_handler (const char *args, int from_tty,
+				       struct cmd_list_element *c)
+{
+  if (new_demangled_name_cache_size > MAX_DEMANGLED_NAME_CACHE_SIZE)
+    {
+      /* Restore the previous value.
+	 This is the value the "show" command prints.  */
+      new_demangled_name_cache_size = demangled_name_cache_size;
+
+      error (_("Demangled name cache size is too large, max is %u."),
+	     MAX_DEMANGLED_NAME_CACHE_SIZE);
+    }
+
+  /* Shards larger than the new size are emptied the next time something
+     is added to them, so only a disabled cache needs flushing now.  */
+  demangled_name_cache_size = new_demangled_name_cache_size;
+  if (demangled_name_cache_size == 0)
+    demangled_name_cache_flush ();
+}
+
+/* The "mt flush-demangled-name-cache" command.  */
+
+static void
+maintenance_flush_demangled_name_cache (const char *args, int from_tty)
+{
+  demangled_name_cache_flush ();
+}
+
+/* The "mt print demangled-name-cache-statistics" command.  */
+
+static void
+maintenance_print_demangled_name_cache_statistics (const char *args,
+						   int from_tty)
+{
+  unsigned int entries = 0, hits = 0, misses = 0, evictions = 0;
+
+  if (demangled_name_cache_size == 0)
+    {
+      printf_filtered ("  <disabled>\n");
+      return;
+    }
+
+  for (demangled_name_cache_shard &shard : demangled_name_cache)
+    {
+#if CXX_STD_THREAD
+      std::lock_guard<std::mutex> guard (shard.mutex);
+#endif
+
+      if (shard.entries != nullptr)
+	entries += htab_elements (shard.entries.get ());
+      hits += shard.hits;
+      misses += shard.misses;
+      evictions += shard.evictions;
+    }
+
+  printf_filtered ("  size:      %u\n", demangled_name_cache_size);
+  printf_filtered ("  entries:   %u\n", entries);
+  printf_filtered ("  hits:      %u\n", hits);
+  printf_filtered ("  misses:    %u\n", misses);
+  if (hits + misses != 0)
+    printf_filtered ("  hit rate:  %.1f%%\n", 100.0 * hits / (hits + misses));
+  else
+    printf_filtered ("  hit rate:  n/a\n");
+  printf_filtered ("  evictions: %u\n", evictions);
+}
+
+/* Return true if MANGLED starts like a C++ ("_Z") or Rust v0 ("_R")
+   mangled name.  Only those are worth the demangled name cache: other
+   names are either not mangled at all, or cheap to demangle.  */
+
+static bool
+demangled_name_cache_candidate_p (const char *mangled)
+{
+  return mangled[0] == '_' && (mangled[1] == 'Z' || mangled[1] == 'R');
+}
+
 /* See symtab.h  */
 
 char *
@@ -798,16 +1171,30 @@ symbol_find_demangled_name (struct general_symbol_info *gsymbol,
 			    const char *mangled)
 {
   char *demangled = NULL;
+  enum language requested, language;
   int i;
 
   if (gsymbol->language () == language_unknown)
     gsymbol->m_language = language_auto;
 
-  if (gsymbol->language () != language_auto)
+  requested = gsymbol->language ();
+  bool use_cache = demangled_name_cache_candidate_p (mangled);
+  if (use_cache
+      && demangled_name_cache_lookup (mangled, requested, &language,
+				      &demangled))
+    {
+      gsymbol->m_language = language;
+      return demangled;
+    }
+
+  if (requested != language_auto)
     {
-      const struct language_defn *lang = language_def (gsymbol->language ());
+      const struct language_defn *lang = language_def (requested);
 
       lang->sniff_from_mangled_name (mangled, &demangled);
+      if (use_cache && demangled != NULL)
+	demangled_name_cache_insert (mangled, requested, requested,
+				     demangled);
       return demangled;
     }
 
@@ -819,6 +1206,8 @@ symbol_find_demangled_name (struct general_symbol_info *gsymbol,
       if (lang->sniff_from_mangled_name (mangled, &demangled))
 	{
 	  gsymbol->m_language = l;
+	  if (use_cache && demangled != NULL)
+	    demangled_name_cache_insert (mangled, requested, l, demangled);
 	  return demangled;
 	}
     }
@@ -1219,39 +1608,164 @@ symbol_cache_byte_size (unsigned int size)
 	  + ((size - 1) * sizeof (struct symbol_cache_slot)));
 }
 
-/* Resize CACHE.  */
+/* Allocate a block symbol cache with room for at least SIZE entries.  */
+
+static struct block_symbol_cache *
+new_block_symbol_cache (unsigned int size)
+{
+  unsigned int ways = std::min (size, (unsigned int) SYMBOL_CACHE_WAYS);
+  unsigned int sets = (size + ways - 1) / ways;
+  struct block_symbol_cache *bsc
+    = (struct block_symbol_cache *) xcalloc (1,
+					     symbol_cache_byte_size (sets
+								     * ways));
+
+  bsc->sets = sets;
+  bsc->ways = ways;
+  bsc->size = sets * ways;
+  return bsc;
+}
+
+/* Return the first slot of the set of BSC that lookups with hash HASH
+   are recorded in.  */
+
+static struct symbol_cache_slot *
+symbol_cache_set (struct block_symbol_cache *bsc, unsigned int hash)
+{
+  return &bsc->symbols[(hash % bsc->sets) * bsc->ways];
+}
+
+/* Make slot WAY of SET its most recently used slot.  */
 
 static void
-resize_symbol_cache (struct symbol_cache *cache, unsigned int new_size)
+symbol_cache_touch (struct symbol_cache_slot *set, unsigned int way)
 {
-  /* If there's no change in size, don't do anything.
-     All caches have the same size, so we can just compare with the size
-     of the global symbols cache.  */
-  if ((cache->global_symbols != NULL
-       && cache->global_symbols->size == new_size)
-      || (cache->global_symbols == NULL
-	  && new_size == 0))
-    return;
+  if (way > 0)
+    {
+      struct symbol_cache_slot slot = set[way];
+
+      memmove (&set[1], &set[0], way * sizeof (*set));
+      set[0] = slot;
+    }
+}
+
+/* Return an unused slot of BSC for recording a lookup with hash HASH.
+   This is the first unused slot of its set or, if there is none, the
+   least recently used slot of the set, which is cleared.  The slot
+   returned is made the most recently used slot of its set.  */
+
+static struct symbol_cache_slot *
+symbol_cache_new_slot (struct block_symbol_cache *bsc, unsigned int hash)
+{
+  struct symbol_cache_slot *set = symbol_cache_set (bsc, hash);
+  unsigned int way;
 
-  destroy_block_symbol_cache (cache->global_symbols);
-  destroy_block_symbol_cache (cache->static_symbols);
+  for (way = 0; way < bsc->ways - 1; ++way)
+    if (set[way].state == SYMBOL_SLOT_UNUSED)
+      break;
 
-  if (new_size == 0)
+  if (set[way].state != SYMBOL_SLOT_UNUSED)
     {
-      cache->global_symbols = NULL;
-      cache->static_symbols = NULL;
+      ++bsc->collisions;
+      symbol_cache_clear_slot (bsc, &set[way]);
     }
-  else
+  symbol_cache_touch (set, way);
+  return &set[0];
+}
+
+/* Return a block symbol cache of at least NEW_SIZE entries holding the
+   entries of BSC, or NULL if NEW_SIZE is zero.  BSC, which may be NULL,
+   is freed.  */
+
+static struct block_symbol_cache *
+resize_block_symbol_cache (struct block_symbol_cache *bsc,
+			   unsigned int new_size)
+{
+  struct block_symbol_cache *new_bsc = NULL;
+
+  if (new_size != 0 && bsc != NULL)
     {
-      size_t total_size = symbol_cache_byte_size (new_size);
+      new_bsc = new_block_symbol_cache (new_size);
+
+      /* Walk each set from its least to its most recently used slot, so
+	 that the order of the entries is kept in their new sets.  */
+      for (unsigned int i = 0; i < bsc->size; i += bsc->ways)
+	for (unsigned int way = bsc->ways; way-- > 0; )
+	  {
+	    struct symbol_cache_slot *slot = &bsc->symbols[i + way];
+
+	    if (slot->state == SYMBOL_SLOT_UNUSED)
+	      continue;
+
+	    *symbol_cache_new_slot (new_bsc, slot->hash) = *slot;
+	    ++new_bsc->used;
+	    if (slot->state == SYMBOL_SLOT_NOT_FOUND)
+	      ++new_bsc->not_found;
+
+	    /* NEW_BSC owns the entry now.  */
+	    slot->state = SYMBOL_SLOT_UNUSED;
+	  }
 
-      cache->global_symbols
-	= (struct block_symbol_cache *) xcalloc (1, total_size);
-      cache->static_symbols
-	= (struct block_symbol_cache *) xcalloc (1, total_size);
-      cache->global_symbols->size = new_size;
-      cache->static_symbols->size = new_size;
+      new_bsc->hits = bsc->hits;
+      new_bsc->misses = bsc->misses;
+      new_bsc->collisions = bsc->collisions;
+      new_bsc->invalidations = bsc->invalidations;
     }
+  else if (new_size != 0)
+    new_bsc = new_block_symbol_cache (new_size);
+
+  destroy_block_symbol_cache (bsc);
+  return new_bsc;
+}
+
+/* Resize CACHE, keeping its entries.  */
+
+static void
+resize_symbol_cache (struct symbol_cache *cache, unsigned int new_size)
+{
+  /* If there's no change in size, don't do anything.  */
+  if (cache->size == new_size)
+    return;
+
+  cache->global_symbols = resize_block_symbol_cache (cache->global_symbols,
+						     new_size);
+  cache->static_symbols = resize_block_symbol_cache (cache->static_symbols,
+						     new_size);
+  cache->size = new_size;
+}
+
+/* Return the number of entries the symbol cache of PSPACE should have
+   room for: the configured size, or more if PSPACE has many objfiles.  */
+
+static unsigned int
+symbol_cache_target_size (struct program_space *pspace)
+{
+  if (symbol_cache_size == 0)
+    return 0;
+
+  size_t wanted = (pspace->objfiles_list.size ()
+		   * SYMBOL_CACHE_ENTRIES_PER_OBJFILE);
+
+  if (wanted <= symbol_cache_size)
+    return symbol_cache_size;
+  return std::min (wanted, (size_t) MAX_SYMBOL_CACHE_SIZE);
+}
+
+/* Grow CACHE, the symbol cache of PSPACE, if PSPACE now has more objfiles
+   than it was sized for.  */
+
+static void
+symbol_cache_grow (struct symbol_cache *cache, struct program_space *pspace)
+{
+  unsigned int target = symbol_cache_target_size (pspace);
+
+  /* Grow geometrically, so that adding many objfiles one at a time only
+     rehashes the cache a logarithmic number of times.  */
+  if (target > cache->size)
+    resize_symbol_cache (cache,
+			 std::max (target,
+				   std::min (2 * cache->size,
+					     (unsigned int) MAX_SYMBOL_CACHE_SIZE)));
 }
 
 /* Return the symbol cache of PSPACE.
@@ -1265,7 +1779,7 @@ get_symbol_cache (struct program_space *pspace)
   if (cache == NULL)
     {
       cache = symbol_cache_key.emplace (pspace);
-      resize_symbol_cache (cache, symbol_cache_size);
+      resize_symbol_cache (cache, symbol_cache_target_size (pspace));
     }
 
   return cache;
@@ -1274,7 +1788,7 @@ get_symbol_cache (struct program_space *pspace)
 /* Set the size of the symbol cache in all program spaces.  */
 
 static void
-set_symbol_cache_size (unsigned int new_size)
+set_symbol_cache_size ()
 {
   for (struct program_space *pspace : program_spaces)
     {
@@ -1282,7 +1796,7 @@ set_symbol_cache_size (unsigned int new_size)
 
       /* The pspace could have been created but not have a cache yet.  */
       if (cache != NULL)
-	resize_symbol_cache (cache, new_size);
+	resize_symbol_cache (cache, symbol_cache_target_size (pspace));
     }
 }
 
@@ -1303,7 +1817,56 @@ set_symbol_cache_size_handler (const char *args, int from_tty,
     }
   symbol_cache_size = new_symbol_cache_size;
 
-  set_symbol_cache_size (symbol_cache_size);
+  set_symbol_cache_size ();
+}
+
+/* Remove the entries of CACHE for which PRED returns true, counting them
+   as invalidations.  */
+
+static void
+symbol_cache_invalidate
+  (struct symbol_cache *cache,
+   gdb::function_view<bool (const struct symbol_cache_slot *)> pred)
+{
+  for (int pass = 0; pass < 2; ++pass)
+    {
+      struct block_symbol_cache *bsc
+	= pass == 0 ? cache->global_symbols : cache->static_symbols;
+
+      if (bsc == NULL || bsc->used == 0)
+	continue;
+
+      for (unsigned int i = 0; i < bsc->size; ++i)
+	{
+	  struct symbol_cache_slot *slot = &bsc->symbols[i];
+
+	  if (slot->state != SYMBOL_SLOT_UNUSED && pred (slot))
+	    {
+	      ++bsc->invalidations;
+	      symbol_cache_clear_slot (bsc, slot);
+	    }
+	}
+    }
+}
+
+/* Remove the entries of CACHE that refer to objfiles freed since the
+   last call.  This must be done before the cache is used: the symbols
+   of those entries are gone, and their objfile contexts could match
+   objfiles allocated at the same address.  */
+
+static void
+symbol_cache_forget_freed_objfiles (struct symbol_cache *cache)
+{
+  if (cache->freed_objfiles.empty ())
+    return;
+
+  symbol_cache_invalidate (cache, [&] (const struct symbol_cache_slot *slot)
+    {
+      return (cache->freed_objfiles.count (slot->objfile_context) != 0
+	      || (slot->state == SYMBOL_SLOT_FOUND
+		  && cache->freed_objfiles.count (slot->objfile) != 0));
+    });
+  cache->freed_objfiles.clear ();
 }
 
 /* Lookup symbol NAME,DOMAIN in BLOCK in the symbol cache of PSPACE.
@@ -1311,7 +1874,7 @@ set_symbol_cache_size_handler (const char *args, int from_tty,
    The result is the symbol if found, SYMBOL_LOOKUP_FAILED if a previous lookup
    failed (and thus this one will too), or NULL if the symbol is not present
    in the cache.
-   *BSC_PTR and *SLOT_PTR are set to the cache and slot of the symbol, which
+   *BSC_PTR and *HASH_PTR are set to the cache and hash of the lookup, which
    can be used to save the result of a full lookup attempt.  */
 
 static struct block_symbol
@@ -1319,11 +1882,11 @@ symbol_cache_lookup (struct symbol_cache *cache,
 		     struct objfile *objfile_context, enum block_enum block,
 		     const char *name, domain_enum domain,
 		     struct block_symbol_cache **bsc_ptr,
-		     struct symbol_cache_slot **slot_ptr)
+		     unsigned int *hash_ptr)
 {
   struct block_symbol_cache *bsc;
   unsigned int hash;
-  struct symbol_cache_slot *slot;
+  struct symbol_cache_slot *set;
 
   if (block == GLOBAL_BLOCK)
     bsc = cache->global_symbols;
@@ -1332,18 +1895,27 @@ symbol_cache_lookup (struct symbol_cache *cache,
   if (bsc == NULL)
     {
       *bsc_ptr = NULL;
-      *slot_ptr = NULL;
+      *hash_ptr = 0;
       return {};
     }
 
+  symbol_cache_forget_freed_objfiles (cache);
+
   hash = hash_symbol_entry (objfile_context, name, domain);
-  slot = bsc->symbols + hash % bsc->size;
+  set = symbol_cache_set (bsc, hash);
 
   *bsc_ptr = bsc;
-  *slot_ptr = slot;
+  *hash_ptr = hash;
 
-  if (eq_symbol_entry (slot, objfile_context, name, domain))
+  for (unsigned int way = 0; way < bsc->ways; ++way)
     {
+      struct symbol_cache_slot *slot = &set[way];
+
+      if (slot->state == SYMBOL_SLOT_UNUSED
+	  || slot->hash != hash
+	  || !eq_symbol_entry (slot, objfile_context, name, domain))
+	continue;
+
       if (symbol_lookup_debug)
 	fprintf_unfiltered (gdb_stdlog,
 			    "%s block symbol cache hit%s for %s, %s\n",
@@ -1352,6 +1924,8 @@ symbol_cache_lookup (struct symbol_cache *cache,
 			    ? " (not found)" : "",
 			    name, domain_name (domain));
       ++bsc->hits;
+      symbol_cache_touch (set, way);
+      slot = &set[0];
       if (slot->state == SYMBOL_SLOT_NOT_FOUND)
 	return SYMBOL_LOOKUP_FAILED;
       return slot->value.found;
@@ -1370,52 +1944,55 @@ symbol_cache_lookup (struct symbol_cache *cache,
   return {};
 }
 
-/* Mark SYMBOL as found in SLOT.
+/* Mark SYMBOL as found in BSC, for a lookup with hash HASH.
    OBJFILE_CONTEXT is the current objfile when the lookup was done, or NULL
    if it's not needed to distinguish lookups (STATIC_BLOCK).  It is *not*
    necessarily the objfile the symbol was found in.  */
 
 static void
-symbol_cache_mark_found (struct block_symbol_cache *bsc,
-			 struct symbol_cache_slot *slot,
+symbol_cache_mark_found (struct block_symbol_cache *bsc, unsigned int hash,
 			 struct objfile *objfile_context,
 			 struct symbol *symbol,
 			 const struct block *block)
 {
+  struct symbol_cache_slot *slot;
+
   if (bsc == NULL)
     return;
-  if (slot->state != SYMBOL_SLOT_UNUSED)
-    {
-      ++bsc->collisions;
-      symbol_cache_clear_slot (slot);
-    }
+  slot = symbol_cache_new_slot (bsc, hash);
   slot->state = SYMBOL_SLOT_FOUND;
+  slot->hash = hash;
   slot->objfile_context = objfile_context;
+  slot->objfile = (SYMBOL_OBJFILE_OWNED (symbol)
+		   ? symbol_objfile (symbol) : NULL);
   slot->value.found.symbol = symbol;
   slot->value.found.block = block;
+  ++bsc->used;
 }
 
-/* Mark symbol NAME, DOMAIN as not found in SLOT.
+/* Mark symbol NAME, DOMAIN as not found in BSC, for a lookup with hash HASH.
    OBJFILE_CONTEXT is the current objfile when the lookup was done, or NULL
    if it's not needed to distinguish lookups (STATIC_BLOCK).  */
 
 static void
 symbol_cache_mark_not_found (struct block_symbol_cache *bsc,
-			     struct symbol_cache_slot *slot,
+			     unsigned int hash,
 			     struct objfile *objfile_context,
 			     const char *name, domain_enum domain)
 {
+  struct symbol_cache_slot *slot;
+
   if (bsc == NULL)
     return;
-  if (slot->state != SYMBOL_SLOT_UNUSED)
-    {
-      ++bsc->collisions;
-      symbol_cache_clear_slot (slot);
-    }
+  slot = symbol_cache_new_slot (bsc, hash);
   slot->state = SYMBOL_SLOT_NOT_FOUND;
+  slot->hash = hash;
   slot->objfile_context = objfile_context;
+  slot->objfile = NULL;
   slot->value.not_found.name = xstrdup (name);
   slot->value.not_found.domain = domain;
+  ++bsc->used;
+  ++bsc->not_found;
 }
 
 /* Flush the symbol cache of PSPACE.  */
@@ -1428,45 +2005,38 @@ symbol_cache_flush (struct program_space *pspace)
 
   if (cache == NULL)
     return;
+  cache->freed_objfiles.clear ();
   if (cache->global_symbols == NULL)
     {
-      gdb_assert (symbol_cache_size == 0);
+      gdb_assert (cache->size == 0);
       gdb_assert (cache->static_symbols == NULL);
       return;
     }
 
-  /* If the cache is untouched since the last flush, early exit.
-     This is important for performance during the startup of a program linked
-     with 100s (or 1000s) of shared libraries.  */
-  if (cache->global_symbols->misses == 0
-      && cache->static_symbols->misses == 0)
-    return;
-
-  gdb_assert (cache->global_symbols->size == symbol_cache_size);
-  gdb_assert (cache->static_symbols->size == symbol_cache_size);
-
   for (pass = 0; pass < 2; ++pass)
     {
       struct block_symbol_cache *bsc
 	= pass == 0 ? cache->global_symbols : cache->static_symbols;
       unsigned int i;
 
-      for (i = 0; i < bsc->size; ++i)
-	symbol_cache_clear_slot (&bsc->symbols[i]);
-    }
+      /* If the cache is empty, early exit.  This is important for
+	 performance during the startup of a program linked with 100s
+	 (or 1000s) of shared libraries.  */
+      if (bsc->used != 0)
+	for (i = 0; i < bsc->size; ++i)
+	  symbol_cache_clear_slot (bsc, &bsc->symbols[i]);
 
-  cache->global_symbols->hits = 0;
-  cache->global_symbols->misses = 0;
-  cache->global_symbols->collisions = 0;
-  cache->static_symbols->hits = 0;
-  cache->static_symbols->misses = 0;
-  cache->static_symbols->collisions = 0;
+      bsc->hits = 0;
+      bsc->misses = 0;
+      bsc->collisions = 0;
+      bsc->invalidations = 0;
+    }
 }
 
 /* Dump CACHE.  */
 
 static void
-symbol_cache_dump (const struct symbol_cache *cache)
+symbol_cache_dump (struct symbol_cache *cache)
 {
   int pass;
 
@@ -1476,6 +2046,8 @@ symbol_cache_dump (const struct symbol_cache *cache)
       return;
     }
 
+  symbol_cache_forget_freed_objfiles (cache);
+
   for (pass = 0; pass < 2; ++pass)
     {
       const struct block_symbol_cache *bsc
@@ -1567,10 +2139,13 @@ symbol_cache_stats (struct symbol_cache *cache)
       return;
     }
 
+  symbol_cache_forget_freed_objfiles (cache);
+
   for (pass = 0; pass < 2; ++pass)
     {
       const struct block_symbol_cache *bsc
 	= pass == 0 ? cache->global_symbols : cache->static_symbols;
+      unsigned int lookups = bsc->hits + bsc->misses;
 
       QUIT;
 
@@ -1579,10 +2154,19 @@ symbol_cache_stats (struct symbol_cache *cache)
       else
 	printf_filtered ("Static block cache stats:\n");
 
-      printf_filtered ("  size:       %u\n", bsc->size);
-      printf_filtered ("  hits:       %u\n", bsc->hits);
-      printf_filtered ("  misses:     %u\n", bsc->misses);
-      printf_filtered ("  collisions: %u\n", bsc->collisions);
+      printf_filtered ("  size:          %u\n", bsc->size);
+      printf_filtered ("  sets:          %u\n", bsc->sets);
+      printf_filtered ("  ways:          %u\n", bsc->ways);
+      printf_filtered ("  used:          %u\n", bsc->used);
+      printf_filtered ("  hits:          %u\n", bsc->hits);
+      printf_filtered ("  misses:        %u\n", bsc->misses);
+      if (lookups != 0)
+	printf_filtered ("  hit rate:      %.1f%%\n",
+			 100.0 * bsc->hits / lookups);
+      else
+	printf_filtered ("  hit rate:      n/a\n");
+      printf_filtered ("  collisions:    %u\n", bsc->collisions);
+      printf_filtered ("  invalidations: %u\n", bsc->invalidations);
     }
 }
 
@@ -1610,13 +2194,70 @@ maintenance_print_symbol_cache_statistics (const char *args, int from_tty)
     }
 }
 
+/* Return true if the objfiles following OBJFILE in the objfile list of
+   its program space, if any, are the objfiles it is the separate debug
+   objfile of.  Lookups search such an objfile after all the objfiles
+   that came before.  */
+
+static bool
+objfile_searched_last_p (struct objfile *objfile)
+{
+  bool seen = false;
+
+  for (struct objfile *iter : objfile->pspace->objfiles ())
+    {
+      if (iter == objfile)
+	seen = true;
+      else if (seen)
+	{
+	  struct objfile *parent;
+
+	  for (parent = objfile->separate_debug_objfile_backlink;
+	       parent != NULL;
+	       parent = parent->separate_debug_objfile_backlink)
+	    if (parent == iter)
+	      break;
+	  if (parent == NULL)
+	    return false;
+	}
+    }
+
+  return seen;
+}
+
 /* This module's 'new_objfile' observer.  */
 
 static void
 symtab_new_objfile_observer (struct objfile *objfile)
 {
-  /* Ideally we'd use OBJFILE->pspace, but OBJFILE may be NULL.  */
-  symbol_cache_flush (current_program_space);
+  struct symbol_cache *cache;
+
+  /* A NULL OBJFILE means the symbols of the current program space were
+     all reloaded.  */
+  if (objfile == NULL)
+    {
+      symbol_cache_flush (current_program_space);
+      return;
+    }
+
+  cache = symbol_cache_key.get (objfile->pspace);
+  if (cache == NULL)
+    return;
+
+  symbol_cache_forget_freed_objfiles (cache);
+  symbol_cache_grow (cache, objfile->pspace);
+
+  /* The symbols of a new objfile can only make failed lookups succeed,
+     provided that it is searched after the objfiles holding the symbols
+     already found.  That is the case of an objfile added at the end of
+     the objfile list, which is where new objfiles normally go.  */
+  if (objfile_searched_last_p (objfile))
+    symbol_cache_invalidate (cache, [] (const struct symbol_cache_slot *slot)
+      {
+	return slot->state == SYMBOL_SLOT_NOT_FOUND;
+      });
+  else
+    symbol_cache_flush (objfile->pspace);
 }
 
 /* This module's 'free_objfile' observer.  */
@@ -1624,7 +2265,16 @@ symtab_new_objfile_observer (struct objfile *objfile)
 static void
 symtab_free_objfile_observer (struct objfile *objfile)
 {
-  symbol_cache_flush (objfile->pspace);
+  struct symbol_cache *cache = symbol_cache_key.get (objfile->pspace);
+
+  if (cache == NULL)
+    return;
+
+  /* Only remember OBJFILE if there are entries which could refer to it.
+     They are removed the next time the cache is used.  */
+  if ((cache->global_symbols != NULL && cache->global_symbols->used != 0)
+      || (cache->static_symbols != NULL && cache->static_symbols->used != 0))
+    cache->freed_objfiles.insert (objfile);
 }
 
 /* Debug symbols usually don't have section information.  We need to dig that
@@ -2614,7 +3264,7 @@ lookup_global_or_static_symbol (const char *name,
   struct block_symbol result;
   struct global_or_static_sym_lookup_data lookup_data;
   struct block_symbol_cache *bsc;
-  struct symbol_cache_slot *slot;
+  unsigned int hash;
 
   gdb_assert (block_index == GLOBAL_BLOCK || block_index == STATIC_BLOCK);
   gdb_assert (objfile == nullptr || block_index == GLOBAL_BLOCK);
@@ -2622,7 +3272,7 @@ lookup_global_or_static_symbol (const char *name,
   /* First see if we can find the symbol in the cache.
      This works because we use the current objfile to qualify the lookup.  */
   result = symbol_cache_lookup (cache, objfile, block_index, name, domain,
-				&bsc, &slot);
+				&bsc, &hash);
   if (result.symbol != NULL)
     {
       if (SYMBOL_LOOKUP_FAILED_P (result))
@@ -2644,9 +3294,9 @@ lookup_global_or_static_symbol (const char *name,
     }
 
   if (result.symbol != NULL)
-    symbol_cache_mark_found (bsc, slot, objfile, result.symbol, result.block);
+    symbol_cache_mark_found (bsc, hash, objfile, result.symbol, result.block);
   else
-    symbol_cache_mark_not_found (bsc, slot, objfile, name, domain);
+    symbol_cache_mark_not_found (bsc, hash, objfile, name, domain);
 
   return result;
 }
@@ -6868,6 +7518,7 @@ When enabled (non-zero), symbol lookups are logged."),
 			     _("Set the size of the symbol cache."),
 			     _("Show the size of the symbol cache."), _("\
 The size of the symbol cache.\n\
+The cache grows beyond this size as objfiles are loaded.\n\
 If zero then the symbol cache is disabled."),
 			     set_symbol_cache_size_handler, NULL,
 			     &maintenance_set_cmdlist,
@@ -6887,6 +7538,26 @@ If zero then the symbol cache is disabled."),
 	   _("Flush the symbol cache for each program space."),
 	   &maintenancelist);
 
+  add_setshow_zuinteger_cmd ("demangled-name-cache-size", no_class,
+			     &new_demangled_name_cache_size,
+			     _("Set the size of the demangled name cache."),
+			     _("Show the size of the demangled name cache."), _("\
+The maximum number of names in the demangled name cache.\n\
+If zero then the demangled name cache is disabled."),
+			     set_demangled_name_cache_size_handler, NULL,
+			     &maintenance_set_cmdlist,
+			     &maintenance_show_cmdlist);
+
+  add_cmd ("demangled-name-cache-statistics", class_maintenance,
+	   maintenance_print_demangled_name_cache_statistics,
+	   _("Print demangled name cache statistics."),
+	   &maintenanceprintlist);
+
+  add_cmd ("flush-demangled-name-cache", class_maintenance,
+	   maintenance_flush_demangled_name_cache,
+	   _("Flush the demangled name cache."),
+	   &maintenancelist);
+
   gdb::observers::executable_changed.attach (symtab_observer_executable_changed);
   gdb::observers::new_objfile.attach (symtab_new_objfile_observer);
   gdb::observers::free_objfile.attach (symtab_free_objfile_observer);
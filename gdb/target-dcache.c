@@ -112,6 +112,19 @@ stack_cache_enabled_p (void)
   return stack_cache_enabled;
 }
 
+/* Read ahead the LEN bytes of stack memory at MEMADDR into the target
+   dcache, if the stack cache is enabled.  */
+
+void
+target_dcache_prefetch_stack (CORE_ADDR memaddr, ULONGEST len)
+{
+  if (!stack_cache_enabled_p ())
+    return;
+
+  dcache_prefetch (current_top_target (), target_dcache_get_or_init (),
+		   memaddr, len);
+}
+
 /* The option sets this.  */
 
 static bool code_cache_enabled_1 = true;
@@ -30,6 +30,8 @@ extern int target_dcache_init_p (void);
 
 extern int stack_cache_enabled_p (void);
 
+extern void target_dcache_prefetch_stack (CORE_ADDR memaddr, ULONGEST len);
+
 extern int code_cache_enabled_p (void);
 
 #endif /* TARGET_DCACHE_H */
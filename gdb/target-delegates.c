@@ -171,6 +171,7 @@ struct dummy_target : public target_ops
   const struct frame_unwind *get_tailcall_unwinder () override;
   void prepare_to_generate_core () override;
   void done_generating_core () override;
+  std::unique_ptr<concurrent_memory_reader> make_concurrent_memory_reader () override;
 };
 
 struct debug_target : public target_ops
@@ -340,6 +341,7 @@ struct debug_target : public target_ops
   const struct frame_unwind *get_tailcall_unwinder () override;
   void prepare_to_generate_core () override;
   void done_generating_core () override;
+  std::unique_ptr<concurrent_memory_reader> make_concurrent_memory_reader () override;
 };
 
 void
@@ -4363,3 +4365,28 @@ debug_target::done_generating_core ()
   fputs_unfiltered (")\n", gdb_stdlog);
 }
 
+std::unique_ptr<concurrent_memory_reader>
+target_ops::make_concurrent_memory_reader ()
+{
+  return this->beneath ()->make_concurrent_memory_reader ();
+}
+
+std::unique_ptr<concurrent_memory_reader>
+dummy_target::make_concurrent_memory_reader ()
+{
+  return NULL;
+}
+
+std::unique_ptr<concurrent_memory_reader>
+debug_target::make_concurrent_memory_reader ()
+{
+  std::unique_ptr<concurrent_memory_reader> result;
+  fprintf_unfiltered (gdb_stdlog, "-> %s->make_concurrent_memory_reader (...)\n", this->beneath ()->shortname ());
+  result = this->beneath ()->make_concurrent_memory_reader ();
+  fprintf_unfiltered (gdb_stdlog, "<- %s->make_concurrent_memory_reader (", this->beneath ()->shortname ());
+  fputs_unfiltered (") = ", gdb_stdlog);
+  target_debug_print_std_unique_ptr_concurrent_memory_reader (result);
+  fputs_unfiltered ("\n", gdb_stdlog);
+  return result;
+}
+
@@ -3702,6 +3702,14 @@ target_done_generating_core (void)
   current_top_target ()->done_generating_core ();
 }
 
+/* See target.h.  */
+
+std::unique_ptr<concurrent_memory_reader>
+target_make_concurrent_memory_reader ()
+{
+  return current_top_target ()->make_concurrent_memory_reader ();
+}
+
 
 
 static char targ_desc[] =
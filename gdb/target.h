@@ -296,6 +296,21 @@ struct memory_read_result
 extern std::vector<memory_read_result> read_memory_robust
     (struct target_ops *ops, const ULONGEST offset, const LONGEST len);
 
+/* Reads the memory of a stopped inferior directly, without going
+   through the target stack, so that several threads can use it at
+   once.  Breakpoint shadows are not applied to the memory read.  This
+   is meant for copying large amounts of memory, e.g. when generating
+   a core file.  See target_ops::make_concurrent_memory_reader.  */
+
+struct concurrent_memory_reader
+{
+  virtual ~concurrent_memory_reader () = default;
+
+  /* Read the LEN bytes at MEMADDR into MYADDR.  Return true if they
+     could all be read.  This can be called from any thread.  */
+  virtual bool read (CORE_ADDR memaddr, gdb_byte *myaddr, size_t len) = 0;
+};
+
 /* Request that OPS transfer up to LEN addressable units from BUF to the
    target's OBJECT.  When writing to a memory object, the addressable unit
    size is architecture dependent and can be found using
@@ -1252,6 +1267,13 @@ struct target_ops
     /* Cleanup after generating a core file.  */
     virtual void done_generating_core ()
       TARGET_DEFAULT_IGNORE ();
+
+    /* Return an object that reads the memory of the current inferior
+       from several threads at once, or NULL if the target cannot do
+       that.  The inferior must stay stopped while the object is
+       used.  */
+    virtual std::unique_ptr<concurrent_memory_reader> make_concurrent_memory_reader ()
+      TARGET_DEFAULT_RETURN (NULL);
   };
 
 /* Deleter for std::unique_ptr.  See comments in
@@ -2608,4 +2630,8 @@ extern void target_prepare_to_generate_core (void);
 /* See to_done_generating_core.  */
 extern void target_done_generating_core (void);
 
+/* See target_ops::make_concurrent_memory_reader.  */
+extern std::unique_ptr<concurrent_memory_reader>
+  target_make_concurrent_memory_reader ();
+
 #endif /* !defined (TARGET_H) */
@@ -0,0 +1,45 @@
+/* This testcase is part of GDB, the GNU debugger.
+
+   Copyright 2020 Free Software Foundation, Inc.
+
+   This program is free software; you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation; either version 3 of the License, or
+   (at your option) any later version.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this program.  If not, see <http://www.gnu.org/licenses/>.  */
+
+volatile int v;
+
+static void __attribute__ ((noinline))
+func3 (int i)
+{
+  v = i;
+}
+
+static void __attribute__ ((noinline))
+func2 (int i)
+{
+  func3 (i + 1);
+  v++;
+}
+
+static void __attribute__ ((noinline))
+func1 (int i)
+{
+  func2 (i + 1);
+  v++;
+}
+
+int
+main (void)
+{
+  func1 (1);
+  return 0;
+}
@@ -0,0 +1,60 @@
+/* Copyright 2020 Free Software Foundation, Inc.
+
+   This file is part of GDB.
+
+   This program is free software; you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation; either version 3 of the License, or
+   (at your option) any later version.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this program.  If not, see <http://www.gnu.org/licenses/>.  */
+
+#include <stdlib.h>
+#include <string.h>
+
+#define BUF_SIZE (8 * 1024 * 1024)
+
+/* Mostly zero, with a few non-zero bytes.  */
+static char static_buf[BUF_SIZE];
+
+/* Partly written, and partly never touched.  */
+static char *heap_buf;
+
+static void
+marker (void)
+{
+}
+
+static void
+break_here (void)
+{
+}
+
+int
+main (void)
+{
+  int i;
+
+  heap_buf = malloc (BUF_SIZE);
+  if (heap_buf == NULL)
+    return 1;
+
+  static_buf[0] = 1;
+  static_buf[BUF_SIZE / 2 + 1] = 2;
+  static_buf[BUF_SIZE - 1] = 3;
+
+  memset (heap_buf, 0x55, BUF_SIZE / 4);
+  for (i = 0; i < BUF_SIZE; i += 1024 * 1024)
+    heap_buf[i + 7] = i / (1024 * 1024) + 1;
+
+  break_here ();
+  marker ();
+
+  return 0;
+}
@@ -0,0 +1,52 @@
+/* This testcase is part of GDB, the GNU debugger.
+
+   Copyright 2020 Free Software Foundation, Inc.
+
+   This program is free software; you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation; either version 3 of the License, or
+   (at your option) any later version.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this program.  If not, see  <http://www.gnu.org/licenses/>.  */
+
+/* Register JIT code entries whose symbol files are not object files,
+   notifying GDB of each one.  */
+
+#include "jit-protocol.h"
+
+#define NUM_ENTRIES 3
+
+static char garbage[64] = "not an object file";
+static struct jit_code_entry entries[NUM_ENTRIES];
+
+int
+main (void)
+{
+  int i;
+
+  for (i = 0; i < NUM_ENTRIES; i++)
+    {
+      struct jit_code_entry *entry = &entries[i];
+
+      entry->symfile_addr = garbage;
+      entry->symfile_size = sizeof (garbage);
+
+      /* Prepend the entry.  */
+      entry->next_entry = __jit_debug_descriptor.first_entry;
+      if (entry->next_entry != 0)
+	entry->next_entry->prev_entry = entry;
+      __jit_debug_descriptor.first_entry = entry;
+
+      __jit_debug_descriptor.relevant_entry = entry;
+      __jit_debug_descriptor.action_flag = JIT_REGISTER;
+      __jit_debug_register_code ();
+    }
+
+  return 0;  /* Break here.  */
+}
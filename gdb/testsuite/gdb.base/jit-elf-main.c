@@ -44,6 +44,12 @@ usage (void)
 #define ATTACH 0
 #endif
 
+/* If non-zero, only notify GDB once all the JIT objects are linked,
+   as with "set jit-batch-registration on".  */
+#ifndef BATCH_REGISTER
+#define BATCH_REGISTER 0
+#endif
+
 #ifndef MAIN
 #define MAIN main
 #endif
@@ -105,8 +111,11 @@ MAIN (int argc, char *argv[])
 	__jit_debug_descriptor.first_entry = entry;
 
       /* Notify GDB.  */
-      __jit_debug_descriptor.action_flag = JIT_REGISTER;
-      __jit_debug_register_code ();
+      if (!BATCH_REGISTER || i == argc - 1)
+	{
+	  __jit_debug_descriptor.action_flag = JIT_REGISTER;
+	  __jit_debug_register_code ();
+	}
 
       if (jit_function () != 42)
 	{
@@ -0,0 +1,48 @@
+/* This testcase is part of GDB, the GNU debugger.
+
+   Copyright 2020 Free Software Foundation, Inc.
+
+   This program is free software; you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation; either version 3 of the License, or
+   (at your option) any later version.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this program.  If not, see <http://www.gnu.org/licenses/>.  */
+
+volatile int counter;
+
+static void __attribute__ ((noinline))
+leaf (int *outer)
+{
+  counter++;	/* leaf start */
+  counter++;
+  *outer = counter;	/* write outer */
+  counter++;	/* leaf end */
+}
+
+static int __attribute__ ((noinline))
+recurse (int depth, int *outer)
+{
+  int local = depth;
+
+  if (depth == 0)
+    leaf (outer);
+  else
+    local += recurse (depth - 1, outer);
+
+  return local;
+}
+
+int
+main (void)
+{
+  int outer = 0;
+
+  return recurse (20, &outer) == outer;
+}
@@ -0,0 +1,46 @@
+/* This testcase is part of GDB, the GNU debugger.
+
+   Copyright 2020 Free Software Foundation, Inc.
+
+   This program is free software; you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation; either version 3 of the License, or
+   (at your option) any later version.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this program.  If not, see <http://www.gnu.org/licenses/>.  */
+
+/* Templates instantiated both in the program and in the shared
+   library, so that both define symbols with the same mangled names.  */
+
+namespace ns
+{
+  template<typename T>
+  struct holder
+  {
+    T value;
+
+    T get () const;
+  };
+
+  template<typename T>
+  T
+  holder<T>::get () const
+  {
+    return value;
+  }
+
+  template<typename T>
+  T
+  twice (const holder<T> &h)
+  {
+    return h.get () + h.get ();
+  }
+}
+
+extern int lib_func (int x);
@@ -0,0 +1,32 @@
+/* This testcase is part of GDB, the GNU debugger.
+
+   Copyright 2020 Free Software Foundation, Inc.
+
+   This program is free software; you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation; either version 3 of the License, or
+   (at your option) any later version.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this program.  If not, see <http://www.gnu.org/licenses/>.  */
+
+/* Compiled into several libraries, with LIBNUM defined to the number
+   of each.  */
+
+#define CONCAT2(a, b) a ## b
+#define CONCAT3(a, b, c) a ## b ## c
+#define XCONCAT2(a, b) CONCAT2 (a, b)
+#define XCONCAT3(a, b, c) CONCAT3 (a, b, c)
+
+int XCONCAT2 (lib_var, LIBNUM) = LIBNUM;
+
+int
+XCONCAT3 (lib, LIBNUM, _func) (int x)
+{
+  return x + XCONCAT2 (lib_var, LIBNUM);
+}
@@ -0,0 +1,42 @@
+# Copyright (C) 2020 Free Software Foundation, Inc.
+
+# This program is free software; you can redistribute it and/or modify
+# it under the terms of the GNU General Public License as published by
+# the Free Software Foundation; either version 3 of the License, or
+# (at your option) any later version.
+#
+# This program is distributed in the hope that it will be useful,
+# but WITHOUT ANY WARRANTY; without even the implied warranty of
+# MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+# GNU General Public License for more details.
+#
+# You should have received a copy of the GNU General Public License
+# along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+from perftest import perftest
+from perftest import utils
+
+class AddrMap(perftest.TestCaseWithBasicMeasurements):
+    def __init__(self, binfile):
+        super(AddrMap, self).__init__("addrmap")
+        self.binfile = binfile
+
+    def warm_up(self):
+        # Get the file into the page cache.
+        utils.select_file(self.binfile)
+        utils.select_file(None)
+
+    def _do_read(self):
+        utils.select_file(self.binfile)
+
+    def _do_expand(self):
+        utils.select_file(self.binfile)
+        gdb.execute("maint expand-symtabs", False, True)
+
+    def execute_test(self):
+        for _ in range(3):
+            self.measure.measure(self._do_read, "read")
+            utils.select_file(None)
+        for _ in range(3):
+            self.measure.measure(self._do_expand, "expand")
+            utils.select_file(None)
@@ -0,0 +1,55 @@
+/* This testcase is part of GDB, the GNU debugger.
+
+   Copyright 2020 Free Software Foundation, Inc.
+
+   This program is free software; you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation; either version 3 of the License, or
+   (at your option) any later version.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this program.  If not, see  <http://www.gnu.org/licenses/>.  */
+
+struct point
+{
+  int x, y;
+};
+
+struct lonely
+{
+  int z;
+};
+
+typedef struct point point_t;
+
+typedef struct
+{
+  int w;
+} anon_t;
+
+typedef anon_t other_anon_t;
+
+struct point points[64];
+const point_t origin = { 0, 0 };
+struct lonely lonely = { 3 };
+anon_t anon = { 5 };
+other_anon_t other_anon = { 6 };
+
+int
+main ()
+{
+  int i;
+
+  for (i = 0; i < 64; i++)
+    {
+      points[i].x = i;
+      points[i].y = -i;
+    }
+
+  return 0; /* Break here.  */
+}
@@ -0,0 +1,82 @@
+# Copyright (C) 2020 Free Software Foundation, Inc.
+
+# This program is free software; you can redistribute it and/or modify
+# it under the terms of the GNU General Public License as published by
+# the Free Software Foundation; either version 3 of the License, or
+# (at your option) any later version.
+#
+# This program is distributed in the hope that it will be useful,
+# but WITHOUT ANY WARRANTY; without even the implied warranty of
+# MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+# GNU General Public License for more details.
+#
+# You should have received a copy of the GNU General Public License
+# along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+import gdb
+import gdb.printing
+
+# The number of calls of counting_lookup.
+lookup_calls = 0
+
+def counting_lookup(val):
+    global lookup_calls
+    lookup_calls += 1
+    return None
+
+counting_lookup.cache_by_type = True
+
+# The number of calls of plain_lookup.
+plain_calls = 0
+
+# A lookup function without a cache_by_type attribute.
+def plain_lookup(val):
+    global plain_calls
+    plain_calls += 1
+    return None
+
+class PointPrinter(object):
+    def __init__(self, val):
+        self.val = val
+
+    def to_string(self):
+        return "(%d, %d)" % (int(self.val['x']), int(self.val['y']))
+
+class AnonPrinter(object):
+    def __init__(self, val):
+        self.val = val
+
+    def to_string(self):
+        return "anon %d" % int(self.val['w'])
+
+class LonelyPrinter(object):
+    def __init__(self, val):
+        self.val = val
+
+    def to_string(self):
+        return "lonely %d" % int(self.val['z'])
+
+# Whether lonely_lookup recognizes values.
+lonely_active = True
+
+def lonely_lookup(val):
+    if lonely_active and val.type.strip_typedefs().tag == "lonely":
+        return LonelyPrinter(val)
+    return None
+
+lonely_lookup.cache_by_type = True
+
+# A lookup function whose result depends on the contents of the
+# value, which must not be cached.
+def lonely_three_lookup(val):
+    if val.type.strip_typedefs().tag == "lonely" and int(val['z']) == 3:
+        return LonelyPrinter(val)
+    return None
+
+pp = gdb.printing.RegexpCollectionPrettyPrinter("pp-cache")
+pp.add_printer("point", "^point$", PointPrinter)
+pp.add_printer("anon", "^anon_t$", AnonPrinter)
+pp.cache_by_type = True
+gdb.printing.register_pretty_printer(None, pp)
+
+gdb.pretty_printers.insert(0, counting_lookup)
@@ -0,0 +1,60 @@
+# Copyright (C) 2020 Free Software Foundation, Inc.
+
+# This program is free software; you can redistribute it and/or modify
+# it under the terms of the GNU General Public License as published by
+# the Free Software Foundation; either version 3 of the License, or
+# (at your option) any later version.
+#
+# This program is distributed in the hope that it will be useful,
+# but WITHOUT ANY WARRANTY; without even the implied warranty of
+# MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+# GNU General Public License for more details.
+#
+# You should have received a copy of the GNU General Public License
+# along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+import gdb
+from gdb.unwinder import Unwinder, register_unwinder
+
+class CountingUnwinder(Unwinder):
+    """An unwinder which counts its calls, and declines every frame.
+    If ranges_on_call is set, the unwinder sets its address ranges to
+    it when called."""
+
+    def __init__(self):
+        super(CountingUnwinder, self).__init__("counting")
+        self.calls = 0
+        self.ranges_on_call = None
+
+    def __call__(self, pending_frame):
+        self.calls += 1
+        if self.ranges_on_call is not None:
+            self.address_ranges = self.ranges_on_call
+        return None
+
+counting_unwinder = CountingUnwinder()
+register_unwinder(None, counting_unwinder)
+
+# Count the calls GDB makes into Python to run the unwinders.
+execute_calls = 0
+real_execute_unwinders = gdb._execute_unwinders
+
+def counting_execute_unwinders(*args):
+    global execute_calls
+    execute_calls += 1
+    return real_execute_unwinders(*args)
+
+gdb._execute_unwinders = counting_execute_unwinders
+
+def count_backtrace_calls():
+    """Flush the frames, print a backtrace, and return the number of
+    calls of the unwinder.  Also count the calls into Python in
+    execute_calls."""
+    global execute_calls
+    gdb.execute("flushregs", to_string=True)
+    counting_unwinder.calls = 0
+    execute_calls = 0
+    gdb.execute("backtrace", to_string=True)
+    return counting_unwinder.calls
+
+print("Python script imported")
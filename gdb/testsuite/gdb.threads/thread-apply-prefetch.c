@@ -0,0 +1,71 @@
+/* This testcase is part of GDB, the GNU debugger.
+
+   Copyright 2020 Free Software Foundation, Inc.
+
+   This program is free software; you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation; either version 3 of the License, or
+   (at your option) any later version.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this program.  If not, see <http://www.gnu.org/licenses/>.  */
+
+#include <pthread.h>
+
+/* More threads than "thread apply all -prefetch" reads ahead at
+   once.  */
+#define NUM_THREADS 40
+
+static pthread_barrier_t barrier;
+
+static void __attribute__ ((noinline))
+recurse (int depth)
+{
+  if (depth > 0)
+    recurse (depth - 1);
+  else
+    {
+      /* Wait for all threads to be started, then for main to have
+	 called all_started.  */
+      pthread_barrier_wait (&barrier);
+      pthread_barrier_wait (&barrier);
+    }
+}
+
+static void *
+thread_func (void *arg)
+{
+  recurse ((int) (long) arg % 8);
+  return NULL;
+}
+
+static void
+all_started (void)
+{
+}
+
+int
+main (void)
+{
+  pthread_t threads[NUM_THREADS];
+  int i;
+
+  pthread_barrier_init (&barrier, NULL, NUM_THREADS + 1);
+
+  for (i = 0; i < NUM_THREADS; i++)
+    pthread_create (&threads[i], NULL, thread_func, (void *) (long) i);
+
+  pthread_barrier_wait (&barrier);
+  all_started ();
+  pthread_barrier_wait (&barrier);
+
+  for (i = 0; i < NUM_THREADS; i++)
+    pthread_join (threads[i], NULL);
+
+  return 0;
+}
@@ -31,6 +31,7 @@
 #include "gdbcmd.h"
 #include "regcache.h"
 #include "btrace.h"
+#include "gdbarch.h"
 
 #include <ctype.h>
 #include <sys/types.h>
@@ -48,6 +49,8 @@
 #include "gdbsupport/gdb_optional.h"
 #include "inline-frame.h"
 #include "stack.h"
+#include "target-dcache.h"
+#include "dcache.h"
 
 /* Definition of struct thread_info exported to gdbthread.h.  */
 
@@ -1313,7 +1316,7 @@ switch_to_thread (thread_info *thr)
 
   switch_to_thread_no_regs (thr);
 
-  reinit_frame_cache ();
+  reinit_frame_cache_retaining ();
 }
 
 /* See gdbsupport/common-gdbthread.h.  */
@@ -1582,6 +1585,16 @@ Call COMMAND for all threads in ascending order.\n\
 The default is descending order."),
 };
 
+/* Option definition of "thread apply all"'s "-prefetch" option.  */
+
+static const gdb::option::flag_option_def<> prefetch_option_def = {
+  "prefetch",
+  N_("\
+Read ahead the registers and stacks of the threads in batches.\n\
+This speeds up commands like \"backtrace\" that read the stack of each\n\
+thread, as the stacks are fetched with fewer, larger target requests."),
+};
+
 /* The qcs command line flags for the "thread apply" commands.  Keep
    this in sync with the "frame apply" commands.  */
 
@@ -1606,14 +1619,16 @@ static const gdb::option::option_def thr_qcs_flags_option_defs[] = {
 };
 
 /* Create an option_def_group for the "thread apply all" options, with
-   ASCENDING and FLAGS as context.  */
+   ASCENDING, PREFETCH and FLAGS as context.  */
 
-static inline std::array<gdb::option::option_def_group, 2>
+static inline std::array<gdb::option::option_def_group, 3>
 make_thread_apply_all_options_def_group (bool *ascending,
+					 bool *prefetch,
 					 qcs_flags *flags)
 {
   return {{
     { {ascending_option_def.def ()}, ascending},
+    { {prefetch_option_def.def ()}, prefetch},
     { {thr_qcs_flags_option_defs}, flags },
   }};
 }
@@ -1627,6 +1642,48 @@ make_thread_apply_options_def_group (qcs_flags *flags)
   return {{thr_qcs_flags_option_defs}, flags};
 }
 
+/* Number of threads whose registers and stacks "thread apply all
+   -prefetch" reads ahead at once.  The stacks of a batch must fit in
+   the stack cache together.  */
+#define THREAD_APPLY_PREFETCH_BATCH 32
+
+/* Number of bytes of stack read ahead for each thread, from its stack
+   pointer.  */
+#define THREAD_APPLY_PREFETCH_STACK_SIZE 4096
+
+/* Read ahead the registers of thread THR and the top of its stack.
+   Errors are ignored: they'll be reported by the command, if it needs
+   the registers or memory that couldn't be read.  */
+
+static void
+thread_prefetch_registers_and_stack (thread_info *thr)
+{
+  if (thr->executing || !switch_to_thread_if_alive (thr))
+    return;
+
+  try
+    {
+      struct regcache *regcache = get_thread_regcache (thr);
+      struct gdbarch *gdbarch = regcache->arch ();
+      ULONGEST sp;
+
+      regcache_read_pc (regcache);
+      if (gdbarch_sp_regnum (gdbarch) < 0)
+	return;
+
+      regcache_cooked_read_unsigned (regcache, gdbarch_sp_regnum (gdbarch),
+				     &sp);
+      if (gdbarch_inner_than (gdbarch, 1, 2))
+	target_dcache_prefetch_stack (sp, THREAD_APPLY_PREFETCH_STACK_SIZE);
+      else
+	target_dcache_prefetch_stack (sp - THREAD_APPLY_PREFETCH_STACK_SIZE,
+				      THREAD_APPLY_PREFETCH_STACK_SIZE);
+    }
+  catch (const gdb_exception_error &ex)
+    {
+    }
+}
+
 /* Apply a GDB command to a list of threads.  List syntax is a whitespace
    separated list of numbers, or ranges, or the keyword `all'.  Ranges consist
    of two numbers separated by a hyphen.  Examples:
@@ -1639,9 +1696,11 @@ static void
 thread_apply_all_command (const char *cmd, int from_tty)
 {
   bool ascending = false;
+  bool prefetch = false;
   qcs_flags flags;
 
   auto group = make_thread_apply_all_options_def_group (&ascending,
+							&prefetch,
 							&flags);
   gdb::option::process_options
     (&cmd, gdb::option::PROCESS_OPTIONS_UNKNOWN_IS_OPERAND, group);
@@ -1678,10 +1737,28 @@ thread_apply_all_command (const char *cmd, int from_tty)
       std::sort (thr_list_cpy.begin (), thr_list_cpy.end (), sorter);
 
       scoped_restore_current_thread restore_thread;
+      scoped_restore restore_keep_dcache
+	= make_scoped_restore (&dcache_keep_on_thread_switch, prefetch);
 
-      for (thread_info *thr : thr_list_cpy)
-	if (switch_to_thread_if_alive (thr))
-	  thr_try_catch_cmd (thr, cmd, from_tty, flags);
+      for (size_t i = 0; i < thr_list_cpy.size (); i++)
+	{
+	  /* Fetch the data of the next batch of threads before running
+	     COMMAND for any of them.  The stack cache isn't flushed by
+	     switching between threads of the same inferior meanwhile,
+	     so COMMAND then finds the stack memory in the cache.  */
+	  if (prefetch && i % THREAD_APPLY_PREFETCH_BATCH == 0)
+	    {
+	      size_t end = std::min (thr_list_cpy.size (),
+				     i + THREAD_APPLY_PREFETCH_BATCH);
+
+	      for (size_t j = i; j < end; j++)
+		thread_prefetch_registers_and_stack (thr_list_cpy[j]);
+	    }
+
+	  thread_info *thr = thr_list_cpy[i];
+	  if (switch_to_thread_if_alive (thr))
+	    thr_try_catch_cmd (thr, cmd, from_tty, flags);
+	}
     }
 }
 
@@ -1752,6 +1829,7 @@ thread_apply_all_command_completer (cmd_list_element *ignore,
 				    const char *text, const char *word)
 {
   const auto group = make_thread_apply_all_options_def_group (nullptr,
+							      nullptr,
 							      nullptr);
   if (gdb::option::complete_options
       (tracker, &text, gdb::option::PROCESS_OPTIONS_UNKNOWN_IS_OPERAND, group))
@@ -2223,7 +2301,7 @@ THREAD_APPLY_OPTION_HELP),
   set_cmd_completer_handle_brkchars (c, thread_apply_command_completer);
 
   const auto thread_apply_all_opts
-    = make_thread_apply_all_options_def_group (nullptr, nullptr);
+    = make_thread_apply_all_options_def_group (nullptr, nullptr, nullptr);
 
   static std::string thread_apply_all_help = gdb::option::build_help (_("\
 Apply a command to all threads.\n\
@@ -0,0 +1,166 @@
+/* Self tests for address maps for GDB, the GNU debugger.
+
+   Copyright (C) 2020 Free Software Foundation, Inc.
+
+   This file is part of GDB.
+
+   This program is free software; you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation; either version 3 of the License, or
+   (at your option) any later version.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this program.  If not, see <http://www.gnu.org/licenses/>.  */
+
+#include "defs.h"
+#include "addrmap.h"
+#include "gdb_obstack.h"
+#include "gdbsupport/selftest.h"
+
+namespace selftests {
+namespace addrmap {
+
+/* The number of addresses covered by the reference map.  */
+static const int map_size = 4096;
+
+/* Objects to store in the maps.  */
+static char objects[16];
+
+/* Callback for addrmap_foreach, counting the transitions to different
+   values.  DATA is a pair of the number of transitions seen so far
+   and the value of the last one.  */
+
+static int
+count_transitions (void *data, CORE_ADDR start_addr, void *obj)
+{
+  auto *state = (std::pair<int, void *> *) data;
+
+  if (obj != state->second)
+    state->first++;
+  state->second = obj;
+  return 0;
+}
+
+/* Check that MAP maps the addresses of the reference map REF in the
+   same way.  */
+
+static void
+check_map (struct addrmap *map, void **ref)
+{
+  int transitions = 0;
+  void *prev = NULL;
+
+  for (int i = 0; i < map_size; i++)
+    {
+      SELF_CHECK (addrmap_find (map, i) == ref[i]);
+      if (ref[i] != prev)
+	transitions++;
+      prev = ref[i];
+    }
+  /* The transition back to NULL at the end of the reference map.  */
+  if (prev != NULL)
+    transitions++;
+  SELF_CHECK (addrmap_find (map, map_size) == NULL);
+  SELF_CHECK (addrmap_find (map, CORE_ADDR_MAX) == NULL);
+
+  std::pair<int, void *> state (0, NULL);
+  addrmap_foreach (map, count_transitions, &state);
+  SELF_CHECK (state.first == transitions);
+}
+
+/* Fill mutable maps with random ranges, and compare them with a
+   reference map after each change.  */
+
+static void
+test_random ()
+{
+  /* A simple linear congruential generator, so that the test is
+     reproducible.  */
+  unsigned int seed = 1;
+  auto next_random = [&] ()
+    {
+      seed = seed * 1103515245 + 12345;
+      return (seed >> 16) & 0x7fff;
+    };
+
+  for (int round = 0; round < 8; round++)
+    {
+      auto_obstack obstack;
+      struct addrmap *map = addrmap_create_mutable (&obstack);
+      void *ref[map_size] = {};
+
+      /* Small ranges in early rounds make for many transitions, and so
+	 a tree of several levels; large ranges exercise the removal
+	 of transitions.  */
+      int max_len = 4 << round;
+
+      for (int i = 0; i < 600; i++)
+	{
+	  int start = next_random () % map_size;
+	  int len = 1 + next_random () % max_len;
+	  int end = std::min (start + len, map_size) - 1;
+	  void *obj = &objects[next_random () % ARRAY_SIZE (objects)];
+
+	  addrmap_set_empty (map, start, end, obj);
+	  for (int a = start; a <= end; a++)
+	    if (ref[a] == NULL)
+	      ref[a] = obj;
+
+	  if (i % 50 == 0)
+	    check_map (map, ref);
+	}
+      check_map (map, ref);
+
+      struct addrmap *fixed = addrmap_create_fixed (map, &obstack);
+      check_map (fixed, ref);
+    }
+}
+
+/* Check ranges at both ends of the address space.  */
+
+static void
+test_extremes ()
+{
+  auto_obstack obstack;
+  struct addrmap *map = addrmap_create_mutable (&obstack);
+
+  SELF_CHECK (addrmap_find (map, 0) == NULL);
+
+  addrmap_set_empty (map, CORE_ADDR_MAX - 10, CORE_ADDR_MAX, &objects[0]);
+  addrmap_set_empty (map, 0, 10, &objects[1]);
+  addrmap_set_empty (map, 5, CORE_ADDR_MAX, &objects[2]);
+
+  SELF_CHECK (addrmap_find (map, 0) == &objects[1]);
+  SELF_CHECK (addrmap_find (map, 10) == &objects[1]);
+  SELF_CHECK (addrmap_find (map, 11) == &objects[2]);
+  SELF_CHECK (addrmap_find (map, CORE_ADDR_MAX - 11) == &objects[2]);
+  SELF_CHECK (addrmap_find (map, CORE_ADDR_MAX - 10) == &objects[0]);
+  SELF_CHECK (addrmap_find (map, CORE_ADDR_MAX) == &objects[0]);
+
+  struct addrmap *fixed = addrmap_create_fixed (map, &obstack);
+  SELF_CHECK (addrmap_find (fixed, 0) == &objects[1]);
+  SELF_CHECK (addrmap_find (fixed, 11) == &objects[2]);
+  SELF_CHECK (addrmap_find (fixed, CORE_ADDR_MAX) == &objects[0]);
+}
+
+static void
+test ()
+{
+  test_random ();
+  test_extremes ();
+}
+
+} /* namespace addrmap */
+} /* namespace selftests */
+
+void _initialize_addrmap_selftests ();
+void
+_initialize_addrmap_selftests ()
+{
+  selftests::register_test ("addrmap", selftests::addrmap::test);
+}
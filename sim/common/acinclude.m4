@@ -21,6 +21,7 @@
 # Include global overrides and fixes for Autoconf.
 m4_include(../../config/override.m4)
 sinclude([../../config/zlib.m4])
+sinclude([../../config/zstd.m4])
 m4_include([../../config/plugins.m4])
 m4_include([../../libtool.m4])
 m4_include([../../ltoptions.m4])
@@ -115,6 +116,9 @@ AC_CHECK_LIB(nsl, gethostbyname)
 # using the same condition.
 AM_ZLIB
 
+# Likewise for zstd.
+AC_ZSTD
+
 # BFD uses libdl when when plugins enabled.
 AC_PLUGINS
 AM_CONDITIONAL(PLUGINS, test "$plugins" = yes)